@@ -0,0 +1,54 @@
+// Counts the heap allocations of a benchmark, by replacing the global
+// operator new and delete: allocations and allocated are the calls and the
+// bytes asked for so far, in_use and peak the heap held now and at most, as
+// glibc's malloc counts it.  Include it in one translation unit only.
+//
+// The replacements are kept out of line: inlined into a caller, delete
+// shows GCC a free() of what new returned, which -Wmismatched-new-delete
+// takes for a mismatch.
+
+#ifndef BENCH_ALLOC_HPP
+#define BENCH_ALLOC_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+
+#if defined(__GNUC__)
+#define BENCH_NOINLINE __attribute__((noinline))
+#else
+#define BENCH_NOINLINE
+#endif
+
+static long allocations = 0;
+static std::size_t allocated = 0;
+static std::size_t in_use = 0;
+static std::size_t peak = 0;
+
+BENCH_NOINLINE void * operator new(std::size_t n)
+{
+    void * p = std::malloc(n ? n : 1);
+    if (!p)
+        throw std::bad_alloc();
+    ++allocations;
+    allocated += n;
+    in_use += malloc_usable_size(p);
+    peak = std::max(peak, in_use);
+    return p;
+}
+
+BENCH_NOINLINE void operator delete(void * p) noexcept
+{
+    if (p)
+        in_use -= malloc_usable_size(p);
+    std::free(p);
+}
+
+BENCH_NOINLINE void operator delete(void * p, std::size_t) noexcept
+{
+    operator delete(p);
+}
+
+#endif
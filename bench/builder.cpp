@@ -0,0 +1,122 @@
+// mark() over 10 MB of text: a dye::colorful chain, a dye::builder and a
+// dye::styled_string, with every heap allocation counted
+//
+//     g++ -std=c++11 -O2 -I../include builder.cpp -o builder
+
+#include "../include/color.hpp"
+#include "alloc.hpp"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+bool is_keyword(const char * s, size_t n)
+{
+    static const char * const names[] = {"google", "facebook", "microsoft", "twitter"};
+    for (const char * name : names)
+        if (strlen(name) == n && strncasecmp(name, s, n) == 0)
+            return true;
+    return false;
+}
+
+bool is_number(const char * s, size_t n)
+{
+    return n && strspn(s, ",.1234567890%$") >= n;
+}
+
+// walk text word by word, calling f(word, size, kind) for words and gaps
+template<typename F>
+void scan(const string & text, F f)
+{
+    const char * p = text.data();
+    const char * end = p + text.size();
+    while (p != end) {
+        const char * q = p;
+        while (q != end && (*q == ' ' || *q == '\n'))
+            ++q;
+        if (q != p)
+            f(p, size_t(q - p), 0);
+        p = q;
+        while (q != end && *q != ' ' && *q != '\n')
+            ++q;
+        if (q != p)
+            f(p, size_t(q - p), is_keyword(p, q - p) ? 2 : is_number(p, q - p) ? 1 : 0);
+        p = q;
+    }
+}
+
+// time and count the allocations of building, then time rendering
+template<typename B>
+void run(const char * name, B build)
+{
+    long before = allocations;
+    size_t bytes = allocated;
+    auto start = chrono::steady_clock::now();
+    auto marked = build();
+    auto built = chrono::steady_clock::now();
+    long count = allocations - before;
+    bytes = allocated - bytes;
+    ostringstream oss;
+    oss << marked;
+    chrono::duration<double, milli> b = built - start;
+    chrono::duration<double, milli> r = chrono::steady_clock::now() - built;
+    cout << name << "build " << b.count() << " ms with " << count << " allocations ("
+         << bytes / (1024 * 1024) << " MB), render " << r.count() << " ms, "
+         << oss.str().size() << " bytes" << endl;
+}
+
+int main()
+{
+    const string paragraph =
+        "Shares in Twitter, Snap and Facebook all declined significantly, dragging "
+        "the Nasdaq down more than 1% to below the 8,000 level.\n"
+        "Twitter fell 6% to end the session at $32.17. Google parent Alphabet came "
+        "in for a drubbing during the hearing.\n";
+    string text;
+    while (text.size() < 10 * 1024 * 1024)
+        text += paragraph;
+
+    const int color = hue::YELLOW;
+
+    run("colorful chain    ", [&]
+        {
+            auto marked = dye::vanilla("");
+            scan(text, [&](const char * s, size_t n, int kind)
+                 {
+                     if (kind == 2)
+                         marked += dye::colorize(string(s, n), "yellow").invert();
+                     else if (kind == 1)
+                         marked += dye::colorize(string(s, n), "yellow");
+                     else
+                         marked += string(s, n);
+                 });
+            return marked;
+        });
+
+    run("builder           ", [&]
+        {
+            dye::builder marked;
+            int plain = hue::get();
+            scan(text, [&](const char * s, size_t n, int kind)
+                 {
+                     marked.append(s, n, kind == 2 ? hue::invert(color) : kind == 1 ? color : plain);
+                 });
+            return marked;
+        });
+
+    run("styled_string     ", [&]
+        {
+            dye::styled_string marked;
+            int plain = hue::get();
+            scan(text, [&](const char * s, size_t n, int kind)
+                 {
+                     marked.append(s, n, kind == 2 ? hue::invert(color) : kind == 1 ? color : plain);
+                 });
+            return marked;
+        });
+
+    return 0;
+}
@@ -0,0 +1,222 @@
+// bytes hue::canvas emits per frame when k cells change, next to drawing
+// every frame in full, for several screen sizes; the diff should grow with
+// the cells changed, not with the screen.  Every frame is also played back
+// on a toy terminal to check that the screen ends up showing the canvas,
+// and a frame that changes one cell must write one cursor move and that
+// cell, and a muted stream nothing; the exit status is 1 otherwise.
+//
+//     g++ -std=c++11 -O2 -I../include canvas.cpp -o canvas
+
+#include "../include/color_canvas.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+// just enough of a terminal for what the canvas emits: CUP, CUF and SGR
+struct terminal
+{
+    int w, h, x = 0, y = 0;
+    string chars, colors;
+    int text = hue::DEFAULT_COLOR, background = 0;
+
+    terminal(int w, int h) : w(w), h(h), chars(size_t(w) * h, ' '), colors(size_t(w) * h, 0) {}
+
+    void play(const string & s)
+    {
+        for (size_t i = 0; i < s.size(); ) {
+            if (s[i] != '\x1b') {
+                if (x < w) {
+                    chars[size_t(y) * w + x] = s[i];
+                    colors[size_t(y) * w + x] = char(text + background * 16);
+                }
+                ++x, ++i;
+                continue;
+            }
+            int args[3] = {0, 0, 0}, n = 0;
+            for (i += 2; isdigit(s[i]) || s[i] == ';'; ++i)
+                if (s[i] == ';')
+                    ++n;
+                else
+                    args[n] = args[n] * 10 + s[i] - '0';
+            char op = s[i++];
+            if (op == 'H')
+                y = max(args[0], 1) - 1, x = max(args[1], 1) - 1;
+            else if (op == 'C')
+                x += args[0];
+            else if (op == 'm')
+                for (int k = 0; k <= n; ++k) {
+                    // 39 and 49 are the terminal's own colors, the console's 7 on 0
+                    int code = args[k];
+                    if (code == 0 || code == 39)
+                        text = hue::DEFAULT_COLOR;
+                    if (code == 0 || code == 49)
+                        background = 0;
+                    if ((code >= 30 && code <= 37) || code >= 90)
+                        text = sgr(code);
+                    if ((code >= 40 && code <= 47) || (code >= 100 && code <= 107))
+                        background = sgr(code);
+                }
+        }
+    }
+
+    static int sgr(int code)
+    {
+        int bright = code >= 90 ? 8 : 0;
+        int k = code % 10;
+        for (int c = 0; c != 8; ++c)
+            if (hue::ansi::SGR[c] == k)
+                return c + bright;
+        return 0;
+    }
+
+    bool shows(const hue::canvas & screen) const
+    {
+        for (int j = 0; j != h; ++j)
+            for (int i = 0; i != w; ++i)
+                if (chars[size_t(j) * w + i] != screen.char_at(i, j) ||
+                    (unsigned char)colors[size_t(j) * w + i] != screen.color_at(i, j))
+                    return false;
+        return true;
+    }
+};
+
+// a status board: a title bar, then rows of "name  value" pairs
+void draw(hue::canvas & screen, const int * values)
+{
+    screen.clear();
+    screen.fill(0, 0, screen.width(), 1, ' ', hue::BLACK + hue::AQUA * 16);
+    screen.write(1, 0, "status", hue::BLACK + hue::AQUA * 16);
+    for (int y = 1; y < screen.height(); ++y)
+        for (int x = 0; x + 16 <= screen.width(); x += 16) {
+            int v = values[y * screen.width() + x];
+            screen.write(x, y, "cpu", hue::GREY);
+            screen.write(x + 5, y, to_string(v) + "%", v > 90 ? hue::LIGHT_RED : hue::GREEN);
+        }
+}
+
+// the cursor moves and the visible bytes of what the canvas wrote
+void count(const string & s, int & moves, string & shown)
+{
+    moves = 0;
+    shown.clear();
+    for (size_t i = 0; i < s.size(); ++i) {
+        if (s[i] != '\x1b') {
+            shown += s[i];
+            continue;
+        }
+        for (i += 2; isdigit(s[i]) || s[i] == ';'; ++i)
+            ;
+        moves += s[i] == 'H' || s[i] == 'C';
+    }
+}
+
+// a frame with one cell changed, in its old color and in a new one, then
+// the same frame again
+bool one_cell()
+{
+    hue::canvas screen(80, 24);
+    ostringstream oss;
+    hue::escaped(oss) = 1;
+    int values[80 * 24] = {};
+    draw(screen, values);
+    screen.present(oss);
+
+    bool right = true;
+    const int colors[] = {hue::GREY, hue::LIGHT_PURPLE};
+    for (int color : colors) {
+        oss.str("");
+        screen.put(41, 7, 'x', color);
+        size_t written = screen.present(oss);
+        int moves;
+        string shown;
+        count(oss.str(), moves, shown);
+        if (written != 1 || moves != 1 || shown != "x") {
+            cout << "one cell changed: " << written << " cells, " << moves << " cursor moves, \"" << shown
+                 << "\" written" << endl;
+            right = false;
+        }
+        screen.put(41, 7, ' ', hue::DEFAULT_COLOR);
+        oss.str("");
+        screen.present(oss);
+    }
+
+    oss.str("");
+    if (screen.present(oss) || !oss.str().empty()) {
+        cout << "a frame with nothing changed wrote " << oss.str().size() << " bytes" << endl;
+        right = false;
+    }
+
+    // a muted stream has no screen to move about
+    ostringstream file;
+    hue::muted(file) = 1;
+    screen.invalidate();
+    if (screen.present(file) || !file.str().empty()) {
+        cout << "a muted stream got " << file.str().size() << " bytes" << endl;
+        right = false;
+    }
+    return right;
+}
+
+int main()
+{
+    if (!one_cell())
+        return 1;
+
+    const int frames = 100;
+    const struct { int w, h; } sizes[] = {{80, 24}, {200, 60}, {400, 120}};
+
+    for (const auto & size : sizes) {
+        int cells = size.w * size.h;
+        int * values = new int[cells]();
+        for (int changes : {1, 10, 100}) {
+            hue::canvas screen(size.w, size.h);
+            ostringstream oss;
+            hue::escaped(oss) = 1;
+            terminal term(size.w, size.h);
+            draw(screen, values);
+            screen.present(oss);
+            term.play(oss.str());
+            size_t first = oss.str().size();
+
+            size_t diff = 0, full = 0, written = 0;
+            srand(1);
+            for (int f = 0; f != frames; ++f) {
+                // change some values in place, then redraw the whole board
+                for (int k = 0; k != changes; ++k) {
+                    int y = 1 + rand() % (size.h - 1);
+                    int x = rand() % (size.w / 16) * 16;
+                    values[y * size.w + x] = rand() % 100;
+                }
+                draw(screen, values);
+
+                oss.str("");
+                written += screen.present(oss);
+                diff += oss.str().size();
+                term.play(oss.str());
+                if (!term.shows(screen)) {
+                    cout << "frame " << f << " is not what the canvas holds" << endl;
+                    return 1;
+                }
+
+                // the same frame drawn from scratch
+                hue::canvas fresh(size.w, size.h);
+                draw(fresh, values);
+                oss.str("");
+                fresh.present(oss);
+                full += oss.str().size();
+            }
+
+            cout << size.w << "x" << size.h << ", " << changes << " values changed per frame: "
+                 << written / frames << " cells, " << diff / frames << " bytes per frame ("
+                 << full / frames << " to redraw in full, " << first << " for the first frame)"
+                 << endl;
+        }
+        delete [] values;
+    }
+    return 0;
+}
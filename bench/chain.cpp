@@ -0,0 +1,162 @@
+// building dye::colorful chains: the examples/how.cpp and examples/mark.cpp
+// patterns, and a large vector dyed by value and through dye::ref, timed and
+// with every heap allocation counted.  Prepending must cost what appending
+// does, chains must move without throwing, and a copy that throws while a
+// chain grows must leave it whole; the exit status is 1 otherwise.
+//
+//     g++ -std=c++11 -O2 -I../include chain.cpp -o chain
+
+#include "../include/color.hpp"
+#include "alloc.hpp"
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+
+struct DoubleVector : private vector<double>
+{
+    using vector<double>::vector;
+    friend ostream & operator<<(ostream &, const DoubleVector &);
+};
+
+ostream & operator<<(ostream & os, const DoubleVector & v)
+{
+    for (const auto & e : v)
+        os << e << "  ";
+    return os;
+}
+
+// a thing whose move may throw, so that a growing chain copies it, and
+// whose copy throws once copies_left runs out
+struct flaky
+{
+    static int live;
+    static int copies_left;
+
+    flaky() { ++live; }
+    flaky(const flaky &)
+    {
+        if (copies_left-- == 0)
+            throw runtime_error("copy");
+        ++live;
+    }
+    flaky(flaky &&) noexcept(false) : flaky() {}
+    ~flaky() { --live; }
+};
+
+int flaky::live = 0;
+int flaky::copies_left = -1;
+
+// a chain growing past its inline room while a copy throws: every element
+// destroyed once, and the block given back
+bool grows_safely()
+{
+    size_t held = in_use;
+    {
+        dye::colorful<flaky> c;
+        for (int i = 0; i != 4; ++i)
+            c.push_back(flaky());
+        flaky::copies_left = 2;
+        try {
+            for (int i = 0; i != 8; ++i)
+                c.push_back(flaky());
+        }
+        catch (const runtime_error &) {
+        }
+        flaky::copies_left = -1;
+    }
+    bool safe = flaky::live == 0 && in_use == held;
+    cout << "a copy throwing as a chain grows: " << flaky::live << " left alive, " << in_use - held
+         << " bytes kept" << endl;
+    return safe;
+}
+
+template<typename F>
+double run(const char * name, int rounds, F f)
+{
+    long before = allocations;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i)
+        f(i);
+    chrono::duration<double, nano> d = chrono::steady_clock::now() - start;
+    cout << name << d.count() / rounds << " ns, "
+         << double(allocations - before) / rounds << " allocations per round" << endl;
+    return d.count() / rounds;
+}
+
+int main()
+{
+    const string words[] = {"Shares", "in", "Twitter", "fell", "6%", "to", "$32.17"};
+
+    run("single item       ", 1000000, [](int i)
+        {
+            auto a = dye::on_yellow(i);
+        });
+
+    run("how.cpp chain     ", 200000, [](int)
+        {
+            using vec = DoubleVector;
+            auto b = dye::red(vec{1, 2, 3});
+            b = b + dye::blue(vec{4, 5, 6});
+            b += dye::green(vec{7, 8, 9});
+        });
+
+    run("string + chain    ", 200000, [](int)
+        {
+            auto c = dye::on_white(string("strings")) + " are " +
+                     dye::on_white("more") + string(" flexible");
+        });
+
+    run("mark() 10k words  ", 100, [&](int)
+        {
+            auto marked = dye::vanilla("");
+            for (int i = 0; i < 10000; ++i) {
+                const string & word = words[i % 7];
+                if (i % 7 == 2)
+                    marked += dye::colorize(word, "yellow").invert();
+                else if (i % 7 >= 4)
+                    marked += dye::colorize(word, "yellow");
+                else
+                    marked += word;
+                marked += " ";
+            }
+        });
+
+    const DoubleVector big(100000, 1.5);
+
+    run("100k by value     ", 1000, [&](int)
+        {
+            auto d = dye::red(big) + dye::blue(big);
+        });
+
+    run("100k by dye::ref  ", 1000, [&](int)
+        {
+            auto d = dye::red(dye::ref(big)) + dye::blue(dye::ref(big));
+        });
+
+    // 10k words prepended one at a time, against appended
+    double back = run("10k appends       ", 100, [&](int)
+        {
+            auto chain = dye::vanilla("");
+            for (int i = 0; i < 10000; ++i)
+                chain = std::move(chain) + dye::text(words[i % 7]);
+        });
+    double front = run("10k prepends      ", 100, [&](int)
+        {
+            auto chain = dye::vanilla("");
+            for (int i = 0; i < 10000; ++i)
+                chain = dye::text(words[i % 7]) + std::move(chain);
+        });
+
+    bool right = grows_safely();
+    bool nothrow = is_nothrow_move_constructible<dye::colorful<string>>::value &&
+                   is_nothrow_move_constructible<dye::colorful<dye::text>>::value;
+    cout << "chains move without throwing, so vectors of them move them: " << (nothrow ? "yes" : "NO") << endl;
+    bool linear = front < 3 * back;
+    cout << "prepends cost about what appends do: " << (linear ? "yes" : "NO") << endl;
+    return right && nothrow && linear ? 0 : 1;
+}
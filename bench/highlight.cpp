@@ -0,0 +1,280 @@
+// dye::highlighter against the mark() of examples/mark.cpp: the same colors
+// on the same text, the throughput of each, and the memory the highlighter
+// allocates as its input grows from 1 MB to 256 MB.  Overlapping and
+// multi-word keywords are checked against a naive search as well; the exit
+// status is 1 if any check fails.
+//
+//     g++ -std=c++11 -O2 -I../include highlight.cpp -o highlight
+
+#include "../include/color_highlight.hpp"
+#include "alloc.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <set>
+#include <sstream>
+#include <streambuf>
+#include <string>
+
+using namespace std;
+
+// mark() as in examples/mark.cpp
+
+const set<string> TO_WATCH = {"google", "facebook", "microsoft", "twitter"};
+
+void segment(const string & s, decltype(s.begin()) & a,  decltype(s.end()) & b)
+{
+    auto is_punct = [](char c) -> bool
+                    {
+                        auto punct = set<char>{',', '.', ':', ';', '?', '!',
+                                               '\'', '\"', '(', ')'};
+                        return punct.find(c) != punct.end();
+                    };
+
+    a = find_if_not(s.cbegin(), s.cend(), is_punct);
+    b = find_if_not(s.crbegin(), s.crend(), is_punct).base();
+    if (a == s.cend())
+        a = s.cbegin();
+}
+
+void separate(const string & s, string & pre, string & word, string & post)
+{
+    auto a = s.cbegin(), b = s.cend();
+    segment(s, a, b);
+    pre = string(s.cbegin(), a);
+    word = string(a, b);
+    post = string(b, s.cend());
+}
+
+bool is_keyword(string s, const set<string> & names = TO_WATCH)
+{
+    transform(s.begin(), s.end(), s.begin(), ::tolower);
+    return names.find(s) != names.end();
+}
+
+bool is_number(string s)
+{
+    if (s.empty())
+        return false;
+    auto a = s.cbegin(), b = s.cend();
+    if (s.front() == '$')
+        a = s.cbegin() + 1;
+    if (s.back() == '%')
+        b = s.cend() - 1;
+    s = string(a, b);
+    return !s.empty() && s.find_first_not_of(",.1234567890") == string::npos;
+}
+
+auto mark(const string & str, string color) -> decltype(dye::vanilla(""))
+{
+    istringstream iss(str);
+    auto marked = dye::vanilla("");
+    for (string line; getline(iss, line); marked += "\n") {
+        istringstream lineiss(line);
+        for (string text; lineiss >> text; marked += " ") {
+            string pre, word, post;
+            separate(text, pre, word, post);
+            marked += pre;
+            if (is_keyword(word))
+                marked += dye::colorize(word, color).invert();
+            else if (is_number(word))
+                marked += dye::colorize(word, color);
+            else
+                marked += word;
+            marked += post;
+        }
+    }
+    return marked;
+}
+
+// endless copies of one text, up to a limit, without holding them in memory
+struct repeat : streambuf
+{
+    string text;
+    size_t left;
+
+    repeat(string t, size_t limit) : text(move(t)), left(limit) {}
+
+    int_type underflow() override
+    {
+        if (left == 0)
+            return traits_type::eof();
+        size_t n = min(left, text.size());
+        left -= n;
+        setg(&text[0], &text[0], &text[0] + n);
+        return traits_type::to_int_type(text[0]);
+    }
+};
+
+struct discard : streambuf
+{
+    int_type overflow(int_type c) override { return traits_type::not_eof(c); }
+    streamsize xsputn(const char *, streamsize n) override { return n; }
+};
+
+// the keyword each byte of random text is in, by the rules the highlighter
+// documents: a keyword starts and ends at a boundary, and overlapping ones
+// go to the one starting first, then to the longer one
+string naive(const string & text, const vector<string> & keywords)
+{
+    // whether the byte before i is a boundary, or there is none
+    auto boundary = [&](size_t i)
+    {
+        return i == 0 || i > text.size() || strchr(" \t\n\r\v\f,.:;?!'\"()", text[i - 1]);
+    };
+    string marks(text.size(), '.');
+    for (size_t i = 0, free = 0; i < text.size(); ++i) {
+        if (i < free || !boundary(i))
+            continue;
+        size_t best = 0;
+        for (const auto & k : keywords) {
+            if (k.size() <= best || i + k.size() > text.size() || !boundary(i + k.size() + 1))
+                continue;
+            bool same = true;
+            for (size_t j = 0; j != k.size() && same; ++j)
+                same = tolower(static_cast<unsigned char>(text[i + j])) == k[j];
+            if (same)
+                best = k.size();
+        }
+        if (best) {
+            marks.replace(i, best, best, 'K');
+            free = i + best;
+        }
+    }
+    return marks;
+}
+
+// a sink marking each byte with whether it came out as a keyword
+struct marking : dye::highlighter::sink
+{
+    string marks;
+    int keyword;
+
+    explicit marking(int keyword) : sink(hue::DEFAULT_COLOR), keyword(keyword) {}
+
+    void write(const char *, size_t n, int color) override
+    {
+        marks.append(n, color == keyword ? 'K' : '.');
+    }
+};
+
+// random text of words that make keywords overlap, within a word and
+// across words, against the naive search, whole and in pieces
+bool overlapping()
+{
+    const vector<string> keywords = {"new york times", "york", "new york", "york times", "times square",
+                                     "ne", "new", "a b a", "b a b", "b"};
+    const char * words[] = {"new", "york", "times", "square", "a", "b", "ne", "w", "yorkshire", "New",
+                            "YORK", "newyork"};
+    const char * gaps[] = {" ", "  ", ". ", "! ", "\n", ",", "(", ")"};
+    const dye::highlighter marker(keywords, hue::YELLOW);
+    const int keyword = hue::invert(hue::YELLOW);
+
+    int wrong = 0;
+    auto check = [&](const string & text)
+    {
+        marking whole(keyword), pieces(keyword);
+        marker.highlight(text.data(), text.size(), whole);
+        {
+            dye::highlighter::scanner s(marker, pieces);
+            for (size_t i = 0, k = 1; i < text.size(); i += k, k = k % 7 + 1)
+                s.feed(text.data() + i, min(k, text.size() - i));
+            s.finish();
+        }
+        string want = naive(text, keywords);
+        if ((whole.marks != want || pieces.marks != want) && ++wrong <= 3)
+            cout << "    " << text << endl << "    " << want << " expected" << endl << "    " << whole.marks
+                 << " got" << endl;
+    };
+
+    check("a new york b");
+    check("in new york city. york!");
+    mt19937 rng(14);
+    for (int round = 0; round != 20000; ++round) {
+        string text;
+        for (int k = rng() % 12; k; --k) {
+            text += words[rng() % 12];
+            text += gaps[rng() % 8];
+        }
+        check(text);
+    }
+    cout << "overlapping keywords like the naive search: " << (wrong ? "NO" : "yes") << endl;
+    return !wrong;
+}
+
+int main()
+{
+    bool right = overlapping();
+
+    const string paragraph =
+        "Silicon Valley giants including Google, Facebook and Twitter are headed to "
+        "Capitol Hill. Here's what you can expect from their hearings.\n"
+        "Shares in Twitter, Snap and Facebook all declined significantly, dragging "
+        "the Nasdaq down more than 1% to below the 8,000 level.\n"
+        "Twitter fell 6% to end the session at $32.17.\n"
+        "Facebook saw its shares fall more than 2% to finish at $167.18.\n"
+        "Google parent, Alphabet, came in for a drubbing during the hearing "
+        "because it declined to accept the committes's invitation to testify. "
+        "The company's stock slipped nearly 1% to close at 1186.48.\n"
+        "Microsoft fell almost 3% on the day, to $108.49. (Twitter) \"MICROSOFT\" "
+        "..., $.5 5$5 a.5 8,000level 12,345.67% x$1\n";
+    const dye::highlighter marker({"google", "facebook", "microsoft", "twitter"}, hue::YELLOW);
+
+    // same colors as mark(), which also puts a space before every newline
+    string text;
+    while (text.size() < 4 * 1024 * 1024)
+        text += paragraph;
+    ostringstream expected, got;
+    hue::escaped(expected) = hue::escaped(got) = 1;
+    auto start = chrono::steady_clock::now();
+    expected << mark(text, "yellow");
+    chrono::duration<double> slow = chrono::steady_clock::now() - start;
+    start = chrono::steady_clock::now();
+    marker.highlight(text, got);
+    chrono::duration<double> fast = chrono::steady_clock::now() - start;
+    string spaced;
+    for (char c : got.str())
+        spaced += c == '\n' ? string(" \n") : string(1, c);
+    // the chain mark() returns starts by setting the default color
+    string want = expected.str();
+    if (want.compare(0, 4, "\x1b[0m") == 0)
+        want.erase(0, 4);
+    cout << "same output as mark(): " << (spaced == want ? "yes" : "NO") << endl;
+    right = right && spaced == want;
+
+    // the same again, fed in pieces of every size from 1 to 97 bytes
+    ostringstream pieces;
+    hue::escaped(pieces) = 1;
+    {
+        dye::highlighter::stream_sink out(pieces);
+        dye::highlighter::scanner s(marker, out);
+        for (size_t i = 0, k = 1; i < text.size(); i += k, k = k % 97 + 1)
+            s.feed(text.data() + i, min(k, text.size() - i));
+        s.finish();
+    }
+    cout << "same output in pieces: " << (pieces.str() == got.str() ? "yes" : "NO") << endl;
+    right = right && pieces.str() == got.str();
+
+    double mb = text.size() / 1e6;
+    cout << "mark()        " << mb / slow.count() << " MB/s" << endl;
+    cout << "highlighter   " << mb / fast.count() << " MB/s" << endl;
+
+    discard sink;
+    ostream out(&sink);
+    hue::escaped(out) = 1;
+    for (size_t limit : {1u << 20, 16u << 20, 256u << 20}) {
+        repeat source(paragraph, limit);
+        istream in(&source);
+        long before = allocations;
+        size_t bytes = allocated;
+        start = chrono::steady_clock::now();
+        marker.highlight(in, out);
+        chrono::duration<double> d = chrono::steady_clock::now() - start;
+        cout << "from a stream, " << (limit >> 20) << " MB: " << limit / 1e6 / d.count()
+             << " MB/s, " << allocations - before << " allocations ("
+             << (allocated - bytes) / 1024 << " KB)" << endl;
+    }
+    return right ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+// N threads publishing colored records through dye::line into one pipe; a
+// reader checks that every record arrives whole and in per-thread order,
+// and the writers' throughput is reported for each thread count
+//
+//     g++ -std=c++11 -O2 -pthread -I../include lines.cpp -o lines
+
+#include "../include/color_line.hpp"
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+using namespace std;
+
+template<typename Out>
+void record(Out && out, int id, int seq)
+{
+    out << "worker " << id << " record " << seq << ": "
+        << dye::light_red("ERROR") << " disk " << dye::yellow(seq % 97)
+        << "% full, " << dye::on_blue(string("retrying")) << " in " << hue::green
+        << seq % 13 << "s" << hue::reset;
+}
+
+// a record as dye::line(1) writes it: colored as std::cout would be, which
+// is not at all when stdout is no terminal
+string expected(int id, int seq)
+{
+    ostringstream oss;
+    hue::escaped(oss) = 1;
+    hue::muted(oss) = hue::muted(cout);
+    hue::depth(oss) = hue::depth(cout);
+    hue::ansi::full(oss) = hue::ansi::full(cout);
+    record(oss, id, seq);
+    if (!hue::muted(oss) && hue::get(oss) != hue::DEFAULT_COLOR)
+        hue::reset(oss);
+    return oss.str();
+}
+
+int main()
+{
+    const int records = 20000;
+
+    for (int threads : {1, 2, 4, 8}) {
+        int fds[2];
+        if (pipe(fds) != 0)
+            return 1;
+
+        long bad = 0, seen = 0;
+        thread reader([&]
+            {
+                vector<int> next(threads, 0);
+                string pending;
+                char buf[65536];
+                for (ssize_t n; (n = read(fds[0], buf, sizeof buf)) > 0; ) {
+                    pending.append(buf, size_t(n));
+                    size_t start = 0;
+                    for (size_t end; (end = pending.find('\n', start)) != string::npos; start = end + 1) {
+                        string got = pending.substr(start, end - start);
+                        int id = -1, seq = -1;
+                        istringstream(got.substr(7)) >> id;
+                        auto at = got.find(" record ");
+                        if (at != string::npos)
+                            istringstream(got.substr(at + 8)) >> seq;
+                        if (id < 0 || id >= threads || seq != next[id] || got != expected(id, seq))
+                            ++bad;
+                        else
+                            ++next[id];
+                        ++seen;
+                    }
+                    pending.erase(0, start);
+                }
+            });
+
+        auto start = chrono::steady_clock::now();
+        vector<thread> writers;
+        for (int id = 0; id < threads; ++id)
+            writers.emplace_back([=]
+                {
+                    for (int seq = 0; seq < records; ++seq)
+                        record(dye::line(fds[1]), id, seq);
+                });
+        for (auto & w : writers)
+            w.join();
+        chrono::duration<double> d = chrono::steady_clock::now() - start;
+        close(fds[1]);
+        reader.join();
+        close(fds[0]);
+
+        cout << threads << " threads  " << long(threads * records / d.count()) << " records/s, "
+             << seen << " records read, " << bad << " split or out of order" << endl;
+        if (bad)
+            return 1;
+    }
+    return 0;
+}
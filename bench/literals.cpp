@@ -0,0 +1,72 @@
+// heap allocations made by the examples/why.cpp patterns, built and printed
+// to a stream that discards its output; dyed literals are views, so the
+// literal-only lines should not allocate at all
+//
+//     g++ -std=c++11 -O2 -I../include literals.cpp -o literals
+
+#include "../include/color.hpp"
+#include "alloc.hpp"
+#include <iostream>
+#include <streambuf>
+#include <string>
+
+using namespace std;
+
+struct discard : streambuf
+{
+    int_type overflow(int_type c) override { return traits_type::not_eof(c); }
+    streamsize xsputn(const char *, streamsize n) override { return n; }
+};
+
+template<typename F>
+void run(const char * name, F f)
+{
+    const int rounds = 10000;
+    long before = allocations;
+    for (int i = 0; i < rounds; ++i)
+        f();
+    cout << name << double(allocations - before) / rounds << " allocations" << endl;
+}
+
+int main()
+{
+    discard sink;
+    ostream out(&sink);
+    hue::set(out, hue::DEFAULT_COLOR);
+
+    run("literal in a sentence     ", [&]
+        {
+            out << "When in doubt, wear " << dye::red("a shade of red that nobody will miss") << "." << endl;
+        });
+
+    run("one dyed literal, twice   ", [&]
+        {
+            auto green = dye::green("evergreen, deciduous and coniferous");
+            out << "I saw " << green << " trees, " << green << " bushes." << endl;
+        });
+
+    run("literal and number        ", [&]
+        {
+            out << "Take the " << dye::blue("Blue Line, the one by the river") << " Line and then "
+                << "catch Bus " << dye::yellow(42 + 7 % 8) << "." << endl;
+        });
+
+    run("literal + dyed literal    ", [&]
+        {
+            out << "the long way round: " + dye::aqua("through the underpass") << endl;
+        });
+
+    const char ca[] = "a char array longer than the small string buffer";
+    string str = "a std::string longer than the small string buffer";
+    run("chain of five, as in why  ", [&]
+        {
+            out << "[ " + dye::aqua(ca) + " | " + dye::aqua(str) + " ]" << endl;
+        });
+
+    run("chain of five, copied     ", [&]
+        {
+            out << "[ " + dye::aqua(dye::copy(ca)) + " | " + dye::aqua(str) + " ]" << endl;
+        });
+
+    return 0;
+}
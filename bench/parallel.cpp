@@ -0,0 +1,170 @@
+// dye::highlight on a dye::pool against dye::highlighter on one thread: a
+// synthetic log (256 MB unless a size in MB is given) highlighted with
+// pools of growing size, each output checked to be byte for byte the same
+// as the sequential one, on a 256-color stream and one taking colors in
+// full as well; the exit status is 1 if any differs
+//
+//     g++ -std=c++11 -O2 -pthread -I../include parallel.cpp -o parallel
+//     ./parallel 1024
+
+#include "../include/color_parallel.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <streambuf>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+// checks what is written to it against the sequential output as it goes
+class compare : public streambuf
+{
+    const string & expected;
+
+public:
+    size_t size = 0;
+    bool same = true;
+
+    explicit compare(const string & expected) : expected(expected)
+    {
+    }
+
+protected:
+    int_type overflow(int_type c) override
+    {
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            char ch = traits_type::to_char_type(c);
+            xsputn(&ch, 1);
+        }
+        return traits_type::not_eof(c);
+    }
+
+    streamsize xsputn(const char * s, streamsize n) override
+    {
+        size_t k = static_cast<size_t>(n);
+        same = same && size + k <= expected.size() && memcmp(expected.data() + size, s, k) == 0;
+        size += k;
+        return n;
+    }
+};
+
+string synthetic_log(size_t bytes)
+{
+    const char * levels[] = {"INFO", "WARN", "DEBUG", "ERROR"};
+    const char * words[] = {"request", "from", "google", "served", "in", "cache", "miss",
+                            "twitter", "retry", "upstream", "facebook", "timeout", "user",
+                            "microsoft", "session", "closed", "(proxy)", "queue,"};
+    mt19937 rng(7);
+    string log;
+    log.reserve(bytes + 256);
+    while (log.size() < bytes) {
+        log += "2026-10-17 12:";
+        log += to_string(10 + rng() % 50) + ":" + to_string(10 + rng() % 50) + " ";
+        log += levels[rng() % 4];
+        for (unsigned i = 0, k = 6 + rng() % 10; i != k; ++i) {
+            log += ' ';
+            if (rng() % 5 == 0)
+                log += rng() % 2 ? to_string(rng() % 1000) + "%" : "$" + to_string(rng() % 100) + ".17";
+            else
+                log += words[rng() % 18];
+        }
+        log += '\n';
+    }
+    return log;
+}
+
+int main(int argc, char * argv[])
+{
+    bool right = true;
+    size_t mb = argc > 1 ? strtoul(argv[1], nullptr, 10) : 256;
+    string log = synthetic_log(mb << 20);
+    dye::highlighter marker({"google", "facebook", "microsoft", "twitter"}, hue::YELLOW);
+
+    // tiny chunks, so that chunk edges fall everywhere, over text that
+    // does not end in a line break
+    {
+        string text = log.substr(0, 1 << 16) + "google 12% $3.50";
+        dye::string_buffer one;
+        ostream os(&one);
+        marker.highlight(text, os);
+        dye::pool workers(3);
+        bool same = true;
+        for (size_t chunk : {1, 2, 7, 100, 4096}) {
+            dye::string_buffer many;
+            ostream ps(&many);
+            dye::highlight(marker, text.data(), text.size(), ps, workers, chunk);
+            same = same && many.str() == one.str();
+        }
+        cout << "small chunks give the same bytes: " << (same ? "yes" : "NO") << endl;
+        right = right && same;
+
+        // RGB colors on a 256-color terminal, which the chunks must render
+        // as the stream would, not in RGB
+        dye::highlighter rich({"google", "facebook"}, hue::rgb(255, 128, 0), hue::rgb(0, 200, 255));
+        dye::string_buffer one256, many256;
+        ostream os256(&one256), ps256(&many256);
+        hue::depth(os256) = hue::depth(ps256) = 256;
+        rich.highlight(text, os256);
+        dye::highlight(rich, text.data(), text.size(), ps256, workers, 100);
+        cout << "the same bytes on a 256-color stream: " << (many256.str() == one256.str() ? "yes" : "NO")
+             << endl;
+        right = right && many256.str() == one256.str();
+
+        // and every color written in full, where the stream asks for it,
+        // from a color other than the default, where a delta is shorter
+        dye::string_buffer one_full, many_full;
+        ostream os_full(&one_full), ps_full(&many_full);
+        hue::ansi::full(os_full) = hue::ansi::full(ps_full) = 1;
+        hue::set(os_full, hue::LIGHT_BLUE);
+        hue::set(ps_full, hue::LIGHT_BLUE);
+        marker.highlight(text, os_full);
+        dye::highlight(marker, text.data(), text.size(), ps_full, workers, 100);
+        cout << "the same bytes on a stream taking colors in full: "
+             << (many_full.str() == one_full.str() ? "yes" : "NO") << endl;
+        right = right && many_full.str() == one_full.str();
+    }
+
+    // the reference, written untimed
+    dye::string_buffer reference;
+    {
+        ostream os(&reference);
+        marker.highlight(log, os);
+    }
+    const string & expected = reference.str();
+
+    auto time = [&](const char * name, unsigned threads) -> double
+    {
+        compare c(expected);
+        ostream os(&c);
+        auto start = chrono::steady_clock::now();
+        if (threads) {
+            dye::pool workers(threads);
+            dye::highlight(marker, log, os, workers);
+        }
+        else {
+            marker.highlight(log, os);
+        }
+        chrono::duration<double> s = chrono::steady_clock::now() - start;
+        right = right && c.same && c.size == expected.size();
+        cout << name << log.size() / s.count() / 1e6 << " MB/s, "
+             << (c.same && c.size == expected.size() ? "same bytes" : "DIFFERENT");
+        return s.count();
+    };
+
+    cout << log.size() / 1e6 << " MB of log, " << expected.size() / 1e6 << " MB highlighted, "
+         << thread::hardware_concurrency() << " hardware threads" << endl;
+
+    double base = time("sequential   ", 0);
+    cout << endl;
+    for (unsigned threads : {1u, 2u, 4u, 8u, 16u}) {
+        if (threads > 2 * thread::hardware_concurrency() && threads > 2)
+            break;
+        string name = "pool of " + to_string(threads) + (threads < 10 ? "   " : "  ");
+        double s = time(name.c_str(), threads);
+        cout << ", x" << base / s << endl;
+    }
+    return right ? 0 : 1;
+}
@@ -0,0 +1,119 @@
+// dye on a stream that gets no colors, as cout does when redirected to a
+// file, against writing the same things with plain operator<<: the bytes
+// checked to be the same, then the time of each.  A muted stream keeps no
+// state, so what is left of the gap is building the dyed temporaries, the
+// copy of each std::string into its item most of all.  A muted cout must
+// not be looked up either; the exit status is 1 if it is, or if the bytes
+// differ.
+//
+//     g++ -std=c++11 -O2 -I../include plain.cpp -o plain
+//     ./plain > out.log
+
+#include "../include/color.hpp"
+#include <chrono>
+#include <iostream>
+#include <streambuf>
+#include <string>
+
+using namespace std;
+
+// a file that throws its bytes away, buffered as a file would be
+class discard : public streambuf
+{
+    char buf[1 << 16];
+
+public:
+    size_t size = 0;
+
+    discard()
+    {
+        setp(buf, buf + sizeof buf);
+    }
+
+protected:
+    int_type overflow(int_type c) override
+    {
+        size += static_cast<size_t>(pptr() - pbase());
+        setp(buf, buf + sizeof buf);
+        if (!traits_type::eq_int_type(c, traits_type::eof()))
+            sputc(traits_type::to_char_type(c));
+        return traits_type::not_eof(c);
+    }
+
+    int sync() override
+    {
+        overflow(traits_type::eof());
+        return 0;
+    }
+};
+
+const int LINES = 2000000;
+const string names[] = {"cache", "proxy", "worker", "shard"};
+
+void plain(ostream & os)
+{
+    for (int i = 0; i != LINES; ++i)
+        os << names[i & 3] << ' ' << i << ": " << "ok" << " in " << (i % 97) << " ms" << '\n';
+}
+
+void dyed(ostream & os)
+{
+    for (int i = 0; i != LINES; ++i)
+        os << dye::aqua(names[i & 3]) << ' ' << dye::yellow(i) << ": " << dye::green("ok") << " in "
+           << (dye::light_red(to_string(i % 97)) + dye::grey(" ms")) << '\n';
+}
+
+template<typename F>
+double time(const char * name, F f, bool muted)
+{
+    discard d;
+    ostream os(&d);
+    hue::muted(os) = muted;
+    auto start = chrono::steady_clock::now();
+    f(os);
+    os.flush();
+    chrono::duration<double> s = chrono::steady_clock::now() - start;
+    cout << name << LINES / s.count() / 1e6 << " M lines/s, " << d.size / 1e6 << " MB" << endl;
+    return s.count();
+}
+
+int main()
+{
+    bool right = true;
+
+    // cout is muted here unless it is a terminal or colors are forced
+    cout << "cout gets " << (hue::muted(cout) ? "no colors" : "colors") << endl;
+
+    {
+        ostringstream a, b;
+        hue::muted(b) = 1;
+        plain(a);
+        dyed(b);
+        cout << "muted dye writes " << (a.str() == b.str() ? "the same bytes" : "DIFFERENT bytes")
+             << " as plain operator<<" << endl;
+        right = a.str() == b.str();
+    }
+
+    // things dyed in cout's current color do not look cout up while it
+    // is muted, which under Win32 would ask the console
+    {
+        long was = hue::muted(cout);
+        hue::muted(cout) = 1;
+        hue::shadow(cout) = 0;
+        dye::builder b;
+        dye::styled_string s;
+        auto v = dye::vanilla("x");
+        b += "x";
+        s += "x";
+        bool untouched = hue::shadow(cout) == 0;
+        cout << "a muted cout is never looked up: " << (untouched ? "yes" : "NO") << endl;
+        right = right && untouched;
+        hue::muted(cout) = was;
+    }
+
+    double base = time("plain operator<<  ", plain, false);
+    double muted = time("dye, muted        ", dyed, true);
+    double colored = time("dye, colored      ", dyed, false);
+    cout << "muted x" << base / muted << " of plain, colored x" << base / colored << endl;
+    return right ? 0 : 1;
+}
@@ -0,0 +1,65 @@
+// rendering a long dye::colorful chain, built the way mark() builds one
+//
+//     g++ -std=c++11 -O2 -I../include render.cpp -o render
+//
+// Run against the ANSI backend, so that every color transition shows up as
+// one escape sequence in the rendered text.  Exits with 1 if there are more
+// sequences than transitions, or the text between them is not the chain's.
+
+#include "../include/color_width.hpp"
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+int main()
+{
+    const int words = 200000;
+    const string vocabulary[] = {"shares", "fell", "to", "the", "level", "of"};
+
+    auto marked = dye::vanilla("");
+    string text;
+    int items = 1, changes = 0;
+    for (int i = 0; i < words; ++i) {
+        if (i % 50 == 0) {
+            marked += dye::colorize(string("Twitter"), "yellow").invert();
+            text += "Twitter";
+            changes += 2;
+        }
+        else {
+            marked += vocabulary[i % 6];
+            text += vocabulary[i % 6];
+        }
+        marked += " ";
+        text += " ";
+        items += 2;
+    }
+
+    ostringstream oss;
+    auto start = chrono::steady_clock::now();
+    oss << marked;
+    chrono::duration<double, milli> d = chrono::steady_clock::now() - start;
+
+    string out = oss.str();
+    long escapes = 0;
+    for (char c : out)
+        escapes += c == '\x1b';
+
+    cout << "items             " << items << endl;
+    cout << "color changes     " << changes << endl;
+    cout << "escape sequences  " << escapes << " (one set + one reset per item would be "
+         << 2L * items << ")" << endl;
+    cout << "render time       " << d.count() << " ms" << endl;
+
+    // one sequence a transition, and one more for the first color, as the
+    // string stream's color is not known before it
+    bool coalesced = escapes == changes + 1;
+    bool same = dye::plain(out) == text;
+    if (!coalesced)
+        cout << "EXPECTED " << changes + 1 << " escape sequences" << endl;
+    if (!same)
+        cout << "TEXT DIFFERS from the chain's" << endl;
+    return coalesced && same ? 0 : 1;
+}
@@ -0,0 +1,115 @@
+// hue::quantize against a nearest-color search per pixel: the tables
+// checked against brute force at every cell and on random pixels, the batch
+// checked against the scalar loop at every SIMD level, and the throughput of
+// each on a frame of 16M pixels
+//
+//     g++ -std=c++11 -O2 -I../include rgb.cpp -o rgb
+
+#include "../include/color_rgb.hpp"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// the nearest of count palette entries, from first, by trying them all
+int search(uint32_t rgb, int first, int count, uint32_t (*entry)(int))
+{
+    int best = first;
+    for (int c = first + 1; c != first + count; ++c)
+        if (hue::palette::distance(rgb, entry(c)) < hue::palette::distance(rgb, entry(best)))
+            best = c;
+    return best;
+}
+
+uint32_t console_entry(int c)
+{
+    return hue::palette::CONSOLE[c];
+}
+
+uint32_t xterm_entry(int n)
+{
+    return hue::palette::xterm(n);
+}
+
+int main()
+{
+    // every cell, by the tables and by brute force
+    {
+        int console_differ = 0, xterm_differ = 0, worst = 0;
+        for (int k = 0; k != 32 * 32 * 32; ++k) {
+            uint32_t c = hue::palette::center(k);
+            console_differ += hue::nearest(c) != search(c, 0, 16, console_entry);
+            int x = hue::palette::xterm_table()[k];
+            int best = search(c, 16, 240, xterm_entry);
+            if (x != best) {
+                ++xterm_differ;
+                int excess = hue::palette::distance(c, xterm_entry(x)) - hue::palette::distance(c, xterm_entry(best));
+                worst = excess > worst ? excess : worst;
+            }
+        }
+        cout << "32768 cells: " << console_differ << " differ from the nearest console color, "
+             << xterm_differ << " from the nearest xterm entry (worst by " << worst << ")" << endl;
+    }
+
+    mt19937 rng(3);
+    vector<uint32_t> frame(16 << 20);
+    for (auto & p : frame)
+        p = rng() & 0xffffff;
+    vector<unsigned char> reference(frame.size()), out(frame.size());
+
+    for (long colors : {16L, 256L}) {
+        cout << endl << colors << " colors" << endl;
+
+        // a search of the whole palette per pixel, on a sixteenth of the
+        // frame; the tables go by cell, so a pixel near the edge of one may
+        // get a near second
+        size_t part = frame.size() / 16, off = 0;
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i != part; ++i) {
+            int exact = colors == 16 ? search(frame[i], 0, 16, console_entry) : search(frame[i], 16, 240, xterm_entry);
+            int table = colors == 16 ? hue::nearest(frame[i]) : hue::palette::xterm_table()[hue::palette::cell(frame[i])];
+            off += exact != table;
+        }
+        chrono::duration<double> d = chrono::steady_clock::now() - start;
+        cout << "search        " << part / d.count() / 1e6 << " Mpixel/s, the table picks another for "
+             << 100.0 * off / part << "% of pixels" << endl;
+
+        // one call per pixel, through the public single-color lookups
+        start = chrono::steady_clock::now();
+        if (colors == 16)
+            for (size_t i = 0; i != frame.size(); ++i)
+                reference[i] = static_cast<unsigned char>(hue::nearest(frame[i]));
+        else
+            for (size_t i = 0; i != frame.size(); ++i)
+                reference[i] = hue::palette::xterm_table()[hue::palette::cell(frame[i])];
+        d = chrono::steady_clock::now() - start;
+        cout << "per pixel     " << frame.size() / d.count() / 1e6 << " Mpixel/s" << endl;
+
+        dye::simd::level best = dye::simd::active();
+        for (auto l : {dye::simd::level::scalar, dye::simd::level::sse2, dye::simd::level::avx2}) {
+            if (l > best)
+                break;
+            dye::simd::active() = l;
+            // odd sizes and offsets, so that the tails are checked too
+            bool same = true;
+            for (size_t n : {0, 1, 31, 33, 100, 1000})
+                for (size_t at : {0, 3}) {
+                    hue::quantize(frame.data() + at, n, out.data() + at, colors);
+                    for (size_t i = at; i != at + n; ++i)
+                        same = same && out[i] == reference[i];
+                }
+            start = chrono::steady_clock::now();
+            hue::quantize(frame.data(), frame.size(), out.data(), colors);
+            d = chrono::steady_clock::now() - start;
+            same = same && out == reference;
+            cout << "batch " << dye::simd::name(l) << string(8 - strlen(dye::simd::name(l)), ' ')
+                 << frame.size() / d.count() / 1e6 << " Mpixel/s, " << (same ? "same" : "DIFFERENT") << endl;
+        }
+        dye::simd::active() = best;
+    }
+    return 0;
+}
@@ -0,0 +1,212 @@
+// dye::ruleset against std::regex run rule by rule: the matches checked
+// against std::regex_match on random lines, then the throughput of both
+// on a synthetic log as the number of rules grows.  Unknown escapes must
+// be refused; the exit status is 1 if they are not, or if a match differs.
+//
+//     g++ -std=c++11 -O2 -I../include rules.cpp -o rules
+
+#include "../include/color_rules.hpp"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <regex>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace std;
+
+// the patterns of the rules, most of them ordinary log vocabulary
+vector<string> patterns(size_t n)
+{
+    vector<string> fixed = {
+        "ERROR|FATAL", "WARN(ING)?", "[0-9]+(\\.[0-9]+)?%?", "\\d{4}-\\d\\d-\\d\\d",
+        "(?i)timeout", "\\d{1,3}(\\.\\d{1,3}){3}", "[a-z]+@[a-z]+\\.(com|org)", "0x[0-9a-fA-F]+",
+        "\"[^\"]*\"", "user=\\w+", "^\\[[A-Z]+\\]", "(GET|POST|PUT) /\\S*",
+    };
+    const char * words[] = {"cache", "retry", "upstream", "session", "proxy", "queue",
+                            "socket", "client", "worker", "shard", "lease", "quorum"};
+    vector<string> out;
+    for (size_t i = 0; i != n; ++i)
+        out.push_back(i < fixed.size() ? fixed[i] : string(words[i % 12]) + "_" + to_string(i));
+    return out;
+}
+
+// every match the rules make, by brute force: at each start, each end,
+// each rule, does std::regex_match accept it
+vector<tuple<size_t, size_t, int>> reference(const vector<string> & pats, const vector<int> & prio,
+                                             const string & line)
+{
+    vector<regex> res;
+    vector<bool> at_start, at_end;
+    for (string p : pats) {
+        auto flags = regex::ECMAScript;
+        if (p.compare(0, 4, "(?i)") == 0) {
+            p.erase(0, 4);
+            flags |= regex::icase;
+        }
+        at_start.push_back(!p.empty() && p[0] == '^');
+        if (at_start.back())
+            p.erase(0, 1);
+        at_end.push_back(!p.empty() && p.back() == '$');
+        if (at_end.back())
+            p.pop_back();
+        res.emplace_back(p, flags);
+    }
+    vector<tuple<size_t, size_t, int>> out;
+    size_t n = line.size();
+    for (size_t i = 0; i < n; ) {
+        size_t best = 0;
+        int winner = -1;
+        for (size_t j = n; j > i && winner < 0; --j)
+            for (size_t r = 0; r != res.size(); ++r) {
+                if ((at_start[r] && i) || (at_end[r] && j != n))
+                    continue;
+                if (regex_match(line.begin() + i, line.begin() + j, res[r]) &&
+                    (winner < 0 || prio[r] > prio[winner])) {
+                    best = j - i;
+                    winner = static_cast<int>(r);
+                }
+            }
+        if (winner >= 0) {
+            out.emplace_back(i, i + best, winner);
+            i += best;
+        }
+        else {
+            ++i;
+        }
+    }
+    return out;
+}
+
+string random_line(mt19937 & rng)
+{
+    const char * bits[] = {"ERROR", "WARN", "WARNING", "12", "3.5%", "2026-10-17", "TimeOut", "10.0.0.1",
+                           "bob@mail.com", "0x1F", "\"a b\"", "user=ann", "[INFO]", "GET /x", "POST",
+                           " ", " ", " ", ".", "-", "x", "ab", "FATAL", "\"", "@", "99"};
+    string s;
+    for (int k = rng() % 12; k >= 0; --k)
+        s += bits[rng() % 26];
+    return s;
+}
+
+int main()
+{
+    bool right = true;
+
+    // rules with a priority each, over random lines
+    {
+        vector<string> pats = patterns(12);
+        pats.insert(pats.end(), {"x+$", "(ab)*c?", "-\\.?$"});
+        vector<int> prio;
+        dye::ruleset rules;
+        mt19937 rng(11);
+        for (size_t r = 0; r != pats.size(); ++r) {
+            prio.push_back(static_cast<int>(rng() % 3));
+            if (!rules.add(pats[r], static_cast<int>(r), prio.back()))
+                cout << "refused: " << pats[r] << endl;
+        }
+        int differ = 0;
+        for (int round = 0; round != 2000; ++round) {
+            string line = random_line(rng);
+            vector<tuple<size_t, size_t, int>> got;
+            rules.match(line.data(), line.size(), [&](size_t a, size_t b, int color)
+                {
+                    got.emplace_back(a, b, color);
+                });
+            if (got != reference(pats, prio, line) && ++differ <= 3)
+                cout << "differs on: " << line << endl;
+        }
+        cout << "2000 random lines, " << differ << " differ from std::regex_match, "
+             << rules.states() << " DFA states" << endl;
+        right = right && !differ;
+    }
+
+    // escapes it does not know, refused; those it does, and punctuation,
+    // taken
+    {
+        dye::ruleset rules;
+        int wrong = 0;
+        for (const char * p : {"\\bword\\b", "\\B", "(a)\\1", "x\\z", "[\\q]", "\\0"})
+            if (rules.add(p, hue::RED) && ++wrong)
+                cout << "taken: " << p << endl;
+        for (const char * p : {"\\.\\$\\(\\[\\\\", "[\\]\\-]", "\\d\\x41\\t", "a\\ b"})
+            if (!rules.add(p, hue::RED) && ++wrong)
+                cout << "refused: " << p << endl;
+        cout << "unknown escapes refused: " << (wrong ? "NO" : "yes") << endl;
+        right = right && !wrong;
+    }
+
+    // adding rules costs no compile each; the first match compiles them
+    // all, where a compile at every add() would cost one per rule
+    {
+        vector<string> pats = patterns(80);
+        dye::ruleset rules, eager;
+        auto start = chrono::steady_clock::now();
+        for (const auto & p : pats)
+            rules.add(p, hue::YELLOW);
+        rules.compile();
+        chrono::duration<double, milli> lazy = chrono::steady_clock::now() - start;
+        start = chrono::steady_clock::now();
+        for (const auto & p : pats) {
+            eager.add(p, hue::YELLOW);
+            eager.compile();
+        }
+        chrono::duration<double, milli> each = chrono::steady_clock::now() - start;
+        cout << "80 rules, " << rules.states() << " states: added and compiled in " << lazy.count()
+             << " ms, " << each.count() << " ms compiled at every add" << endl;
+    }
+
+    // a synthetic log
+    mt19937 rng(5);
+    string log;
+    while (log.size() < (16 << 20)) {
+        log += "2026-10-17 12:00:0" + to_string(rng() % 10) + " ";
+        log += rng() % 8 ? "INFO" : "ERROR";
+        for (int k = 6 + rng() % 8; k; --k)
+            log += rng() % 6 ? " request served from cache" : " upstream timeout after " + to_string(rng() % 900) + " ms";
+        log += '\n';
+    }
+    vector<string> lines;
+    istringstream is(log);
+    for (string line; getline(is, line); )
+        lines.push_back(line);
+
+    for (size_t count : {1, 4, 16, 64}) {
+        vector<string> pats = patterns(count);
+        dye::ruleset rules;
+        for (const auto & p : pats)
+            rules.add(p, hue::YELLOW);
+
+        size_t matches = 0;
+        auto start = chrono::steady_clock::now();
+        for (const auto & line : lines)
+            rules.match(line.data(), line.size(), [&](size_t, size_t, int) { ++matches; });
+        chrono::duration<double> d = chrono::steady_clock::now() - start;
+        cout << count << " rules, " << rules.states() << " states, " << matches << " matches: ruleset "
+             << log.size() / d.count() / 1e6 << " MB/s";
+
+        // std::regex, a rule at a time, on a sixteenth of the lines
+        vector<regex> res;
+        for (string p : pats) {
+            if (p.compare(0, 4, "(?i)") == 0)
+                res.emplace_back(p.substr(4), regex::icase);
+            else
+                res.emplace_back(p);
+        }
+        size_t part = lines.size() / 16;
+        size_t bytes = 0;
+        start = chrono::steady_clock::now();
+        for (size_t l = 0; l != part; ++l) {
+            bytes += lines[l].size() + 1;
+            for (const auto & re : res)
+                for (sregex_iterator it(lines[l].begin(), lines[l].end(), re), end; it != end; ++it)
+                    ++matches;
+        }
+        d = chrono::steady_clock::now() - start;
+        cout << ", std::regex " << bytes / d.count() / 1e6 << " MB/s" << endl;
+    }
+    return right ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+// dye::simd::classify at every level the CPU supports: each level checked
+// against the scalar one on random blocks and byte sets, the highlighter's
+// output checked to be the same at every level, and the throughput of each
+//
+//     g++ -std=c++11 -O2 -I../include scan.cpp -o scan
+
+#include "../include/color_highlight.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+bool same(const dye::simd::masks & a, const dye::simd::masks & b)
+{
+    return a.space == b.space && a.digit == b.digit && a.punct == b.punct && a.member == b.member;
+}
+
+int main()
+{
+    using dye::simd::level;
+    vector<level> levels = {level::scalar};
+    if (dye::simd::detect() != level::scalar)
+        levels.push_back(level::sse2);
+    if (dye::simd::detect() == level::avx2)
+        levels.push_back(level::avx2);
+
+    // random blocks of random lengths, with text-like and fully random bytes
+    mt19937 rng(42);
+    const string alphabet = "abcdefghijklmnopqrstuvwxyz ABCXYZ\t\n\r\v\f0123456789,.:;?!'\"()$%&*-_";
+    long mismatches = 0, checked = 0;
+    for (int round = 0; round != 20000; ++round) {
+        dye::simd::byte_set set;
+        // few members make ranges for SSE2, many force its bitmap fallback
+        int members = round % 2 ? rng() % 8 : rng() % 200;
+        for (int k = 0; k != members; ++k)
+            set.add(static_cast<unsigned char>(rng()));
+
+        unsigned char block[64];
+        for (auto & c : block)
+            c = round % 3 ? alphabet[rng() % alphabet.size()] : static_cast<unsigned char>(rng());
+        size_t n = rng() % 65;
+        const char * p = reinterpret_cast<const char *>(block);
+
+        dye::simd::active() = level::scalar;
+        dye::simd::masks want = dye::simd::classify(p, n, set);
+        for (level l : levels) {
+            dye::simd::active() = l;
+            mismatches += !same(dye::simd::classify(p, n, set), want);
+            ++checked;
+        }
+    }
+    cout << checked << " blocks classified, " << mismatches << " differ from scalar" << endl;
+
+    // the highlighter gives the same output whatever the level
+    const string paragraph =
+        "Shares in Twitter, Snap and Facebook all declined significantly, dragging "
+        "the Nasdaq down more than 1% to below the 8,000 level.\n"
+        "Twitter fell 6% to end the session at $32.17. Google parent Alphabet came "
+        "in for a drubbing during the hearing.\n";
+    const string prose =
+        "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod "
+        "tempor incididunt ut labore et dolore magna aliqua. Ut enim ad minim veniam.\n";
+    const dye::highlighter marker({"google", "facebook", "microsoft", "twitter"}, hue::YELLOW);
+    string news, plain;
+    while (news.size() < 64 * 1024 * 1024)
+        news += paragraph;
+    while (plain.size() < 64 * 1024 * 1024)
+        plain += prose;
+
+    string reference;
+    for (level l : levels) {
+        dye::simd::active() = l;
+        ostringstream oss;
+        hue::escaped(oss) = 1;
+        marker.highlight(news.data(), 4 * 1024 * 1024, oss);
+        if (reference.empty())
+            reference = oss.str();
+        else if (oss.str() != reference)
+            ++mismatches;
+    }
+    cout << "highlighter output the same at every level: " << (mismatches ? "NO" : "yes") << endl;
+
+    // throughput of classify alone, and of the highlighter on top of it
+    dye::simd::byte_set starts;
+    for (unsigned char c : string("$%,.0123456789gGfFmMtT"))
+        starts.add(c);
+    struct discard : streambuf
+    {
+        int_type overflow(int_type c) override { return traits_type::not_eof(c); }
+        streamsize xsputn(const char *, streamsize n) override { return n; }
+    } sink;
+    ostream out(&sink);
+    hue::escaped(out) = 1;
+
+    for (level l : levels) {
+        dye::simd::active() = l;
+        uint64_t bits = 0;
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i + 64 <= plain.size(); i += 64) {
+            dye::simd::masks m = dye::simd::classify(plain.data() + i, 64, starts);
+            bits += m.space ^ m.digit ^ m.punct ^ m.member;
+        }
+        chrono::duration<double> c = chrono::steady_clock::now() - start;
+
+        start = chrono::steady_clock::now();
+        marker.highlight(plain, out);
+        chrono::duration<double> h = chrono::steady_clock::now() - start;
+        start = chrono::steady_clock::now();
+        marker.highlight(news, out);
+        chrono::duration<double> k = chrono::steady_clock::now() - start;
+
+        cout << dye::simd::name(l) << "\tclassify " << plain.size() / 1e9 / c.count() << " GB/s"
+             << ", highlight prose " << plain.size() / 1e9 / h.count() << " GB/s"
+             << ", news " << news.size() / 1e9 / k.count() << " GB/s"
+             << (bits == 1 ? " " : "") << endl;
+    }
+    return 0;
+}
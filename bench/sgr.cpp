@@ -0,0 +1,294 @@
+// the escape bytes colored logs cost three ways: every color in full, as the
+// ANSI backend wrote them before (hue::ansi::full), what changes from the
+// color before, and what changes held back by hue::deferred until text shows
+// it.  A small terminal reads each output back, and the screens must come out
+// the same: every character in the same colors, spaces and line breaks in
+// the same background.  The same goes for every change between two colors,
+// as a delta and in full.  Then the time to render a line of each log each
+// way.
+//
+//     g++ -std=c++11 -O2 -I../include sgr.cpp -o sgr
+
+#include "../include/color_highlight.hpp"
+#include "../include/color_table.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// a file that throws its bytes away, buffered as a file would be
+class discard : public streambuf
+{
+    char buf[1 << 16];
+
+public:
+    size_t size = 0;
+
+    discard()
+    {
+        setp(buf, buf + sizeof buf);
+    }
+
+protected:
+    int_type overflow(int_type c) override
+    {
+        size += static_cast<size_t>(pptr() - pbase());
+        setp(buf, buf + sizeof buf);
+        if (!traits_type::eq_int_type(c, traits_type::eof()))
+            sputc(traits_type::to_char_type(c));
+        return traits_type::not_eof(c);
+    }
+
+    int sync() override
+    {
+        overflow(traits_type::eof());
+        return 0;
+    }
+};
+
+// what a terminal shows of the text: each byte, with the text and background
+// colors it is shown in as SGR keys (those of hue::ansi::state), the text
+// color left out for blanks; and how many bytes were escape sequences
+struct screen
+{
+    string cells;
+    size_t escapes = 0;
+};
+
+screen read(const string & out)
+{
+    screen s;
+    string fg = "39", bg = "49";
+    for (size_t i = 0; i < out.size(); ++i) {
+        if (out[i] == '\x1b' && i + 1 < out.size() && out[i + 1] == '[') {
+            size_t end = out.find('m', i);
+            s.escapes += end + 1 - i;
+            vector<string> keys;
+            istringstream in(out.substr(i + 2, end - i - 2));
+            for (string k; getline(in, k, ';'); )
+                keys.push_back(k);
+            for (size_t k = 0; k < keys.size(); ++k) {
+                int v = atoi(keys[k].c_str());
+                string * side = (v / 10 == 3 || v / 10 == 9) ? &fg : &bg;
+                if (v == 0) {
+                    fg = "39";
+                    bg = "49";
+                }
+                else if ((v == 38 || v == 48) && keys[k + 1] == "5") {
+                    *side = "5;" + keys[k + 2];
+                    k += 2;
+                }
+                else if (v == 38 || v == 48) {
+                    *side = "2;" + keys[k + 2] + ";" + keys[k + 3] + ";" + keys[k + 4];
+                    k += 4;
+                }
+                else {
+                    *side = keys[k];
+                }
+            }
+            i = end;
+            continue;
+        }
+        bool blank = out[i] == ' ' || out[i] == '\n';
+        s.cells += out[i];
+        s.cells += '[' + (blank ? string() : fg) + '/' + bg + ']';
+    }
+    return s;
+}
+
+const char * news = "Silicon Valley giants including Google, Facebook and Twitter are headed to Capitol Hill. "
+                    "Shares in Twitter, Snap and Facebook all declined significantly, dragging the Nasdaq down "
+                    "more than 1% to below the 8,000 level. Twitter fell 6% to end the session at $32.17. "
+                    "Facebook saw its shares fall more than 2% to finish at $167.18.\n";
+
+const char * hosts[] = {"cache-01", "proxy", "worker-3", "shard-7"};
+
+// the examples/mark.cpp pattern: keywords inverted, numbers dyed, the rest
+// plain, each word and space its own item
+void marked(ostream & os, int rounds)
+{
+    for (int r = 0; r != rounds; ++r) {
+        istringstream words(news);
+        auto line = dye::vanilla("");
+        for (string w; words >> w; line += " ") {
+            string bare = w.substr(0, w.find_first_of(",.%"));
+            if (bare == "Google" || bare == "Facebook" || bare == "Twitter")
+                line += dye::yellow(w).invert();
+            else if (!bare.empty() && bare.find_first_not_of("$0123456789,.") == string::npos)
+                line += dye::yellow(w);
+            else
+                line += w;
+        }
+        os << line << '\n';
+    }
+}
+
+// service log lines, a few dyed items between plain text
+void service(ostream & os, int rounds)
+{
+    for (int r = 0; r != rounds; ++r) {
+        bool failed = r % 7 == 0;
+        os << dye::grey("2024-05-01T12:00:") << dye::grey(r % 60) << ' '
+           << (failed ? dye::light_red("ERROR") : dye::green("INFO")) << ' ' << dye::aqua(hosts[r & 3]) << ": "
+           << (failed ? "upstream timeout" : "served") << " in " << dye::yellow(r % 997) << dye::grey(" ms")
+           << '\n';
+    }
+}
+
+// hue manipulators, some of them setting what is already set, with dyed
+// items and raw text between
+void manipulators(ostream & os, int rounds)
+{
+    for (int r = 0; r != rounds; ++r) {
+        os << hue::yellow << "warning" << hue::reset << ": disk " << hue::light_red << r % 100 << "%"
+           << hue::reset << " full on " << hue::aqua << hosts[r & 3] << hue::aqua << hue::on_blue << " (raid) "
+           << hue::reset << dye::grey("retry in ") << dye::white(5) << "s" << hue::reset << '\n';
+    }
+}
+
+// a table of dyed cells in columns of their own colors
+void table(ostream & os, int rounds)
+{
+    using align = dye::table::align;
+    dye::table t(os, {{"host", align::left, hue::AQUA}, {"status", align::center}, {"ms", align::right, hue::YELLOW},
+                      {"message", align::left, hue::GREY}});
+    for (int r = 0; r != rounds; ++r)
+        t.row(hosts[r & 3], r % 9 ? dye::green("ok") : dye::light_red("failed"), r % 997,
+              r % 5 ? "served from cache" : "upstream timeout after retry");
+}
+
+// the keyword and number highlighter over log text
+void highlighted(ostream & os, int rounds)
+{
+    static const dye::highlighter marker({"google", "facebook", "twitter"}, hue::YELLOW, hue::LIGHT_AQUA);
+    string text;
+    for (int r = 0; r != rounds / 4; ++r)
+        text += news;
+    marker.highlight(text, os);
+}
+
+// a gradient in 24-bit color, one character at a time
+void gradient(ostream & os, int rounds)
+{
+    for (int r = 0; r != rounds; ++r) {
+        for (int x = 0; x != 64; ++x)
+            os << dye::rgb('#', 255 - x * 4, x * 4, 128);
+        os << '\n';
+    }
+}
+
+// every change of color written as hue::ansi::delta, from every color and
+// from a terminal in an unknown state, against the same color written in
+// full: the screen must show a character in the same colors either way
+bool deltas()
+{
+    vector<int> colors;
+    for (int c = 0; c != 256; ++c)
+        colors.push_back(c);
+    for (int n : {0, 9, 16, 196, 231, 232, 255}) {
+        colors.push_back(hue::xterm256(n));
+        colors.push_back(hue::on_xterm256(n));
+    }
+    for (int v : {0, 7, 128, 255}) {
+        colors.push_back(hue::rgb(v, 255 - v, 40));
+        colors.push_back(hue::on_rgb(40, v, 255 - v));
+    }
+
+    size_t pairs = 0, wrong = 0;
+    for (long depth : {16L, 256L, 0L}) {
+        // a full sequence for each color, and what a character after it shows
+        vector<string> full;
+        vector<string> cells;
+        for (int c : colors) {
+            ostringstream os;
+            if (hue::is_extended(c))
+                hue::ansi::write(os, c, depth);
+            else
+                hue::ansi::write(os, c);
+            full.push_back(os.str());
+            cells.push_back(read(os.str() + "x").cells);
+        }
+        for (size_t a = 0; a != colors.size() + 1; ++a)
+            for (size_t b = 0; b != colors.size(); ++b) {
+                // from the last color, or from an unknown state that some
+                // other color left
+                bool unknown = a == colors.size();
+                const string & before = full[unknown ? b * 7 % colors.size() : a];
+                hue::ansi::state from = unknown ? hue::ansi::UNKNOWN : hue::ansi::shows(colors[a], depth);
+                char seq[48];
+                size_t n = hue::ansi::delta(seq, from, hue::ansi::shows(colors[b], depth));
+                string shown = read(before + string(seq, n) + "x").cells;
+                ++pairs;
+                if (shown != cells[b] && ++wrong <= 3)
+                    cout << "    from " << colors[a % colors.size()] << (unknown ? " (unknown)" : "") << " to "
+                         << colors[b] << " at depth " << depth << ": " << shown << ", in full " << cells[b] << endl;
+            }
+    }
+    cout << pairs << " changes of color, " << wrong << " showing other than in full" << endl << endl;
+    return !wrong;
+}
+
+enum class way
+{
+    full,
+    delta,
+    deferred
+};
+
+const char * names[] = {"full    ", "delta   ", "deferred"};
+
+void render(ostream & os, way w, function<void(ostream &, int)> log, int rounds)
+{
+    hue::ansi::full(os) = w == way::full;
+    if (w == way::deferred) {
+        hue::deferred held(os);
+        log(os, rounds);
+    }
+    else {
+        log(os, rounds);
+    }
+    os.flush();
+}
+
+int main()
+{
+    struct
+    {
+        const char * name;
+        function<void(ostream &, int)> log;
+    } logs[] = {{"mark() news", marked}, {"service log", service}, {"hue manipulators", manipulators},
+                {"dye::table", table}, {"highlighter", highlighted}, {"rgb gradient", gradient}};
+
+    bool same = deltas();
+    for (const auto & l : logs) {
+        cout << l.name << endl;
+        screen first;
+        for (way w : {way::full, way::delta, way::deferred}) {
+            ostringstream os;
+            render(os, w, l.log, 1000);
+            screen s = read(os.str());
+            if (w == way::full)
+                first = s;
+            bool shown = s.cells == first.cells;
+            same = same && shown;
+
+            discard d;
+            ostream out(&d);
+            auto start = chrono::steady_clock::now();
+            render(out, w, l.log, 20000);
+            chrono::duration<double> t = chrono::steady_clock::now() - start;
+
+            cout << "    " << names[static_cast<int>(w)] << "  " << os.str().size() << " bytes, " << s.escapes
+                 << " of escapes, x" << double(first.escapes) / s.escapes << " fewer, " << t.count() / 20000 * 1e9
+                 << " ns a line" << (shown ? "" : ", SCREEN DIFFERS") << endl;
+        }
+    }
+    cout << endl << "screens " << (same ? "all the same" : "DIFFERENT") << endl;
+    return same ? 0 : 1;
+}
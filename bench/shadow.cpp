@@ -0,0 +1,84 @@
+// how often the console is asked for its color: once for each stream, the
+// first time its color is read, and again only on hue::resync().  Counted
+// with hue::stats over a mix of sets, gets, manipulators and dyed items;
+// the exit status is 1 if any get after the first reaches the console,
+// or if a reset goes uncounted.  Then the time of a get from the shadow, next to asking the console.
+//
+//     g++ -std=c++11 -O2 -DCOLOR_CONSOLE_STATS -I../include shadow.cpp -o shadow
+
+#include "../include/color.hpp"
+#include <chrono>
+#include <iostream>
+#include <sstream>
+
+#if !defined(COLOR_CONSOLE_STATS)
+#error "the shadow bench is built with -DCOLOR_CONSOLE_STATS"
+#endif
+
+using namespace std;
+
+unsigned long long queries()
+{
+    return hue::stats::snapshot().queries;
+}
+
+int main()
+{
+    const int rounds = 100000;
+    bool right = true;
+    auto expect = [&](const char * what, unsigned long long n)
+    {
+        cout << what << ": " << queries() << " queries" << endl;
+        if (queries() != n) {
+            cout << "    EXPECTED " << n << endl;
+            right = false;
+        }
+    };
+
+    ostringstream a, b;
+    hue::stats::reset();
+    hue::get(a);
+    expect("first get", 1);
+
+    long sum = 0;
+    for (int i = 0; i != rounds; ++i) {
+        hue::set(a, i & 255);
+        sum += hue::get(a) + hue::get_text(a) + hue::get_background(a);
+        a << hue::light_red << "x" << hue::on_blue << hue::reset;
+        a << dye::aqua(i) << " " << dye::red("y").invert();
+        hue::set_text(a, hue::YELLOW);
+        sum += hue::get(a);
+        a.str("");
+    }
+    expect("100k rounds of sets, gets and dyed items", 1);
+
+    hue::get(b);
+    expect("first get of another stream", 2);
+    hue::resync(a);
+    expect("resync", 3);
+
+    // a reset counts as one, whichever way it is made
+    hue::stats::reset();
+    hue::reset();
+    a << hue::reset;
+    hue::reset(a);
+    unsigned long long resets = hue::stats::snapshot().resets;
+    cout << "three resets: " << resets << " counted" << endl;
+    if (resets != 3) {
+        cout << "    EXPECTED 3" << endl;
+        right = false;
+    }
+
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i != rounds; ++i)
+        sum += hue::get(a);
+    chrono::duration<double, nano> shadowed = chrono::steady_clock::now() - start;
+    start = chrono::steady_clock::now();
+    for (int i = 0; i != rounds; ++i)
+        sum += hue::resync(a);
+    chrono::duration<double, nano> asked = chrono::steady_clock::now() - start;
+
+    cout << endl << "hue::get     " << shadowed.count() / rounds << " ns" << endl;
+    cout << "hue::resync  " << asked.count() / rounds << " ns (" << sum % 2 << ")" << endl;
+    return right ? 0 : 1;
+}
@@ -0,0 +1,136 @@
+// producer-side cost of dye::async_sink under each overflow policy, with
+// the writer thread rendering into /dev/null; the cost is measured in the
+// producer's own CPU time, so that the writer sharing its core does not count.
+// Then a trickle of records, which must not cost a flush each, and pushes
+// and a flush() waiting on a slow stream, which must not burn the waiting
+// thread's core; the exit status is 1 if either does.
+//
+//     g++ -std=c++11 -O2 -pthread -I../include sink.cpp -o sink
+
+#include "../include/color_sink.hpp"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+#include <time.h>
+
+using namespace std;
+
+double thread_ns()
+{
+    timespec t;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t);
+    return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+// a stream that counts its flushes, and takes its time over every write
+// if asked to
+class counting : public streambuf
+{
+public:
+    int flushes = 0;
+    chrono::microseconds delay{0};
+
+protected:
+    int_type overflow(int_type c) override
+    {
+        this_thread::sleep_for(delay);
+        return traits_type::not_eof(c);
+    }
+
+    streamsize xsputn(const char *, streamsize n) override
+    {
+        this_thread::sleep_for(delay);
+        return n;
+    }
+
+    int sync() override
+    {
+        ++flushes;
+        return 0;
+    }
+};
+
+int main()
+{
+    bool right = true;
+    const int records = 1000000;
+    const string message = "disk usage above threshold";
+    const struct { dye::overflow policy; const char * name; } runs[] = {
+        {dye::overflow::block,       "block       "},
+        {dye::overflow::drop_newest, "drop_newest "},
+        {dye::overflow::drop_oldest, "drop_oldest "},
+    };
+
+    for (const auto & run : runs) {
+        ofstream null("/dev/null");
+        dye::async_sink<dye::colorful<dye::text>> sink(null, 4096, run.policy);
+
+        // build the records up front so that only push() is timed
+        vector<dye::colorful<dye::text>> batch;
+        batch.reserve(records);
+        for (int i = 0; i < records; ++i)
+            batch.push_back(dye::light_red("ERROR") + " " + dye::yellow(message));
+
+        size_t deepest = 0;
+        auto start = chrono::steady_clock::now();
+        double cpu = thread_ns();
+        for (int i = 0; i < records; ++i) {
+            sink.push(std::move(batch[i]));
+            if ((i & 1023) == 0 && sink.depth() > deepest)
+                deepest = sink.depth();
+        }
+        cpu = thread_ns() - cpu;
+        sink.flush();
+        chrono::duration<double, milli> drained = chrono::steady_clock::now() - start;
+
+        cout << run.name << cpu / records << " ns per push, "
+             << sink.dropped() << " dropped, deepest queue " << deepest
+             << ", all written after " << drained.count() << " ms" << endl;
+    }
+
+    // a record a millisecond for 200 ms: a flush every 50 ms or so, not 200
+    {
+        counting c;
+        ostream out(&c);
+        {
+            dye::async_sink<string> sink(out);
+            for (int i = 0; i != 200; ++i) {
+                sink.push("tick " + to_string(i));
+                this_thread::sleep_for(chrono::milliseconds(1));
+            }
+            sink.flush();
+        }
+        cout << endl << "200 records over 200 ms: " << c.flushes << " flushes" << endl;
+        if (c.flushes > 20) {
+            cout << "    EXPECTED about 5" << endl;
+            right = false;
+        }
+    }
+
+    // 2000 records through a queue of 16 into a stream taking 50 us a
+    // write: push() and flush() sleep while they wait
+    {
+        counting c;
+        c.delay = chrono::microseconds(50);
+        ostream out(&c);
+        dye::async_sink<string> sink(out, 16);
+        auto start = chrono::steady_clock::now();
+        double cpu = thread_ns();
+        for (int i = 0; i != 2000; ++i)
+            sink.push("slow " + to_string(i));
+        sink.flush();
+        cpu = thread_ns() - cpu;
+        chrono::duration<double, nano> waited = chrono::steady_clock::now() - start;
+        cout << "push() and flush() on a slow stream: " << cpu / 1e6 << " ms of CPU in " << waited.count() / 1e6
+             << " ms" << endl;
+        if (cpu > waited.count() / 10) {
+            cout << "    EXPECTED under a tenth" << endl;
+            right = false;
+        }
+    }
+    return right ? 0 : 1;
+}
@@ -0,0 +1,72 @@
+// hue::stoc against the std::map lookup it replaced
+//
+//     g++ -std=c++11 -O2 -I../include stoc.cpp -o stoc
+
+#include "../include/color.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+static_assert(hue::stoc("Light_Red") == hue::LIGHT_RED, "stoc is usable at compile time");
+
+// the lookup as it was: copy, fold in place, then find + at on std::map
+int map_stoc(string a)
+{
+    transform(a.begin(), a.end(), a.begin(), [](char c)
+              {
+                  if ('A' <= c && c <= 'Z')
+                      c = c - 'A' + 'a';
+                  else if (c == '_' || c == '-')
+                      c = ' ';
+                  return c;
+              });
+    return (hue::CODES.find(a) != hue::CODES.end()) ? hue::CODES.at(a) : hue::BAD_COLOR;
+}
+
+template<typename F>
+double time_ns(const vector<string> & names, int rounds, F f, long & sink)
+{
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i)
+        for (const auto & name : names)
+            sink += f(name);
+    chrono::duration<double, nano> d = chrono::steady_clock::now() - start;
+    return d.count() / (double(rounds) * names.size());
+}
+
+int main()
+{
+    vector<string> names;
+    for (const auto & code : hue::CODES) {
+        string name = code.first;
+        names.push_back(name);
+        replace(name.begin(), name.end(), ' ', '_');
+        transform(name.begin(), name.end(), name.begin(), ::toupper);
+        names.push_back(name);
+    }
+    names.push_back("light-red");
+    names.push_back("not a color");
+    names.push_back("");
+
+    for (const auto & name : names) {
+        if (hue::stoc(name) != map_stoc(name)) {
+            cerr << "mismatch on \"" << name << "\"" << endl;
+            return 1;
+        }
+    }
+
+    const int rounds = 200000;
+    long sink = 0;
+    double m = time_ns(names, rounds, [](const string & s) { return map_stoc(s); }, sink);
+    double h = time_ns(names, rounds, [](const string & s) { return hue::stoc(s); }, sink);
+
+    cout << "std::map lookup   " << m << " ns/name" << endl;
+    cout << "perfect hash      " << h << " ns/name" << endl;
+    cout << "speedup           " << m / h << "x" << endl;
+    return sink == 42 ? 2 : 0;
+}
@@ -0,0 +1,394 @@
+// the benchmark suite: building dyed objects, chaining them, rendering them,
+// and the hue manipulators, each case timed and with every heap allocation
+// counted.  Built against the recording backend, so that what is timed is
+// the library and not a terminal, and the colors each case sets are counted
+// too.  Writes one line a case, and JSON for comparing two builds:
+//
+//     g++ -std=c++11 -O2 -DCOLOR_CONSOLE_RECORD -I../include suite.cpp -o suite
+//     ./suite --output before.json
+//     ./suite --baseline before.json
+//     ./suite --json render
+//
+// A name given on the command line runs only the cases whose names hold it.
+// Against a baseline, a case more than 20% slower (or --threshold percent),
+// or allocating more, is marked as a regression and the exit status is 1;
+// runs on a busy machine differ by 10% and more.
+
+#include "../include/color.hpp"
+#include "alloc.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#if !defined(COLOR_CONSOLE_RECORD)
+#error "the suite is built with -DCOLOR_CONSOLE_RECORD"
+#endif
+
+using namespace std;
+
+// keeps the optimizer from dropping what a case builds
+template<typename T>
+void keep(T & t)
+{
+#if defined(__GNUC__)
+    asm volatile("" : : "g"(&t) : "memory");
+#else
+    static void * volatile sink;
+    sink = &t;
+#endif
+}
+
+// a file that throws its bytes away, buffered as a file would be
+class discard : public streambuf
+{
+    char buf[1 << 16];
+
+public:
+    size_t size = 0;
+
+    discard()
+    {
+        setp(buf, buf + sizeof buf);
+    }
+
+protected:
+    int_type overflow(int_type c) override
+    {
+        size += static_cast<size_t>(pptr() - pbase());
+        setp(buf, buf + sizeof buf);
+        if (!traits_type::eq_int_type(c, traits_type::eof()))
+            sputc(traits_type::to_char_type(c));
+        return traits_type::not_eof(c);
+    }
+
+    int sync() override
+    {
+        overflow(traits_type::eof());
+        return 0;
+    }
+};
+
+struct result
+{
+    string name;
+    double ns;
+    double allocations;
+    double bytes;
+    double colors;
+};
+
+// each case is run with twice the rounds until a run takes 20 ms, then five
+// times more; the fastest run counts.  Allocations and colors are counted
+// over the first run of the five, and the colors recorded are cleared after
+// every round so that the log never grows.
+template<typename F>
+result measure(const string & name, F f)
+{
+    auto & log = hue::record::changes();
+    log.reserve(1 << 16);
+    auto time = [&](long rounds)
+    {
+        auto start = chrono::steady_clock::now();
+        for (long i = 0; i != rounds; ++i) {
+            f(i);
+            log.clear();
+        }
+        chrono::duration<double, nano> d = chrono::steady_clock::now() - start;
+        return d.count();
+    };
+
+    long rounds = 1;
+    while (time(rounds) < 20e6 && rounds < (1L << 30))
+        rounds *= 2;
+
+    result r = {name, 0, 0, 0, 0};
+    long a = allocations, colors = 0;
+    size_t b = allocated;
+    for (long i = 0; i != rounds; ++i) {
+        f(i);
+        colors += static_cast<long>(log.size());
+        log.clear();
+    }
+    r.allocations = double(allocations - a) / rounds;
+    r.bytes = double(allocated - b) / rounds;
+    r.colors = double(colors) / rounds;
+
+    r.ns = time(rounds);
+    for (int k = 1; k != 5; ++k)
+        r.ns = min(r.ns, time(rounds));
+    r.ns /= rounds;
+    return r;
+}
+
+const string words[] = {"Shares", "in", "Twitter", "fell", "6%", "to", "$32.17"};
+
+// the examples/mark.cpp pattern: plain words, numbers dyed and keywords
+// dyed and inverted, all += onto one chain
+dye::colorful<dye::text> mark(int count)
+{
+    auto marked = dye::vanilla("");
+    for (int i = 0; i < count; ++i) {
+        const string & word = words[i % 7];
+        if (i % 7 == 2)
+            marked += dye::colorize(word, "yellow").invert();
+        else if (i % 7 >= 4)
+            marked += dye::colorize(word, "yellow");
+        else
+            marked += word;
+        marked += " ";
+    }
+    return marked;
+}
+
+// the cases whose names hold the filter, each timed as it is added
+struct cases
+{
+    string filter;
+    vector<result> results;
+
+    template<typename F>
+    void add(const string & name, F f)
+    {
+        if (name.find(filter) != string::npos)
+            results.push_back(measure(name, f));
+    }
+};
+
+vector<result> run(const string & filter)
+{
+    cases c = {filter, {}};
+
+    discard d;
+    ostream os(&d);
+    const string word = "Twitter";
+    const string name = "light_red";
+
+    c.add("construct/dye::red(int)", [](long i)
+        {
+            auto a = dye::red(static_cast<int>(i));
+            keep(a);
+        });
+    c.add("construct/dye::red(const char *)", [](long)
+        {
+            auto a = dye::red("Twitter");
+            keep(a);
+        });
+    c.add("construct/dye::red(std::string)", [&](long)
+        {
+            auto a = dye::red(word);
+            keep(a);
+        });
+    c.add("construct/dye::colorize(std::string, const char *)", [&](long)
+        {
+            auto a = dye::colorize(word, "light_red");
+            keep(a);
+        });
+    c.add("construct/dye::colorize(std::string, std::string)", [&](long)
+        {
+            auto a = dye::colorize(word, name);
+            keep(a);
+        });
+    c.add("construct/dye::rgb(int)", [](long i)
+        {
+            auto a = dye::rgb(static_cast<int>(i), 255, 128, 0);
+            keep(a);
+        });
+
+    c.add("chain/item + item", [](long i)
+        {
+            auto a = dye::red(static_cast<int>(i)) + dye::blue(static_cast<int>(i));
+            keep(a);
+        });
+    c.add("chain/item + strings", [](long)
+        {
+            auto a = dye::on_white(string("strings")) + " are " + dye::on_white("more") + string(" flexible");
+            keep(a);
+        });
+    c.add("chain/+= 8 items", [](long i)
+        {
+            auto a = dye::vanilla(static_cast<int>(i));
+            for (int k = 0; k != 8; ++k)
+                a += dye::yellow(k);
+            keep(a);
+        });
+    c.add("chain/mark() 1000 words", [](long)
+        {
+            auto a = mark(1000);
+            keep(a);
+        });
+
+    c.add("render/item", [&](long i)
+        {
+            os << dye::red(static_cast<int>(i));
+        });
+    c.add("render/item + strings", [&](long)
+        {
+            os << dye::on_white(string("strings")) + " are " + dye::on_white("more") + string(" flexible");
+        });
+    {
+        auto marked = mark(1000);
+        c.add("render/mark() 1000 words, built", [&](long)
+            {
+                os << marked;
+            });
+        dye::styled_string styled(marked);
+        c.add("render/styled_string 1000 words", [&](long)
+            {
+                os << styled;
+            });
+    }
+
+    c.add("hue/os << hue::red << text << hue::reset", [&](long)
+        {
+            os << hue::red << "Twitter" << hue::reset;
+        });
+    c.add("hue/os << hue::on_blue", [&](long)
+        {
+            os << hue::on_blue;
+        });
+    c.add("hue/hue::set(os, int)", [&](long i)
+        {
+            hue::set(os, static_cast<int>(i & 255));
+        });
+    c.add("hue/hue::set(os, std::string, std::string)", [&](long)
+        {
+            hue::set(os, "light red", "black");
+        });
+    c.add("hue/hue::stoc(std::string)", [&](long i)
+        {
+            int c = hue::stoc(i & 1 ? name : word);
+            keep(c);
+        });
+
+    os.flush();
+    return c.results;
+}
+
+string quoted(const string & s)
+{
+    string q = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\')
+            q += '\\';
+        q += c;
+    }
+    return q + '"';
+}
+
+// one case to a line, so that a baseline can be read back without a parser
+void write_json(ostream & out, const vector<result> & results)
+{
+#if defined(__clang__)
+    const char * compiler = __VERSION__;
+#elif defined(__GNUC__)
+    const char * compiler = "GCC " __VERSION__;
+#elif defined(_MSC_VER)
+    const string compiler = "MSVC " + to_string(_MSC_VER);
+#else
+    const char * compiler = "unknown";
+#endif
+    out << "{\n  \"backend\": \"record\",\n  \"standard\": " << __cplusplus
+        << ",\n  \"compiler\": " << quoted(compiler) << ",\n  \"cases\": [\n";
+    for (size_t i = 0; i != results.size(); ++i) {
+        const result & r = results[i];
+        out << "    {\"name\": " << quoted(r.name) << ", \"ns\": " << r.ns << ", \"allocations\": " << r.allocations
+            << ", \"bytes\": " << r.bytes << ", \"colors\": " << r.colors << "}"
+            << (i + 1 != results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+}
+
+// the cases of an earlier run, by name
+map<string, result> read_json(const string & path)
+{
+    map<string, result> cases;
+    ifstream in(path);
+    auto number = [](const string & line, const char * key)
+    {
+        size_t at = line.find(key);
+        return at == string::npos ? 0.0 : strtod(line.c_str() + at + strlen(key), nullptr);
+    };
+    for (string line; getline(in, line); ) {
+        size_t a = line.find("{\"name\": \"");
+        if (a == string::npos)
+            continue;
+        string name;
+        for (size_t i = a + 10; i < line.size() && line[i] != '"'; ++i)
+            name += line[i] == '\\' ? line[++i] : line[i];
+        cases[name] = result{name, number(line, "\"ns\": "), number(line, "\"allocations\": "),
+                             number(line, "\"bytes\": "), number(line, "\"colors\": ")};
+    }
+    return cases;
+}
+
+int main(int argc, char * argv[])
+{
+    string filter, output, baseline;
+    double threshold = 20;
+    bool json = false;
+    for (int i = 1; i < argc; ++i) {
+        string a = argv[i];
+        if (a == "--json")
+            json = true;
+        else if (a == "--output" && i + 1 < argc)
+            output = argv[++i];
+        else if (a == "--baseline" && i + 1 < argc)
+            baseline = argv[++i];
+        else if (a == "--threshold" && i + 1 < argc)
+            threshold = strtod(argv[++i], nullptr);
+        else if (a.compare(0, 2, "--"))
+            filter = a;
+        else {
+            cerr << "usage: " << argv[0] << " [--json] [--output FILE] [--baseline FILE] [--threshold PERCENT] [NAME]" << endl;
+            return 2;
+        }
+    }
+
+    map<string, result> before;
+    if (!baseline.empty()) {
+        before = read_json(baseline);
+        if (before.empty()) {
+            cerr << baseline << ": no cases" << endl;
+            return 2;
+        }
+    }
+
+    vector<result> results = run(filter);
+
+    if (!output.empty()) {
+        ofstream out(output);
+        write_json(out, results);
+    }
+    if (json) {
+        write_json(cout, results);
+        return 0;
+    }
+
+    int regressions = 0;
+    for (const auto & r : results) {
+        char line[256];
+        snprintf(line, sizeof line, "%-52s %10.1f ns %7.2f allocs %8.1f B %6.1f colors", r.name.c_str(),
+                 r.ns, r.allocations, r.bytes, r.colors);
+        cout << line;
+        auto b = before.find(r.name);
+        if (b != before.end()) {
+            bool slower = r.ns > b->second.ns * (1 + threshold / 100);
+            bool more = r.allocations > b->second.allocations;
+            regressions += slower || more;
+            snprintf(line, sizeof line, "   x%.2f%s", b->second.ns / r.ns,
+                     slower && more ? "  SLOWER, MORE ALLOCATIONS" : slower ? "  SLOWER" : more ? "  MORE ALLOCATIONS" : "");
+            cout << line;
+        }
+        cout << endl;
+    }
+    return regressions ? 1 : 0;
+}
@@ -0,0 +1,199 @@
+// dye::table against rendering every row to strings first, measuring them,
+// then printing: the text of the two outputs checked to be the same, then
+// the rows a second and the most heap each holds at once, for a million
+// rows (or as many as given)
+//
+//     g++ -std=c++11 -O2 -I../include table.cpp -o table
+//     ./table 5000000
+
+#include "../include/color_table.hpp"
+#include "alloc.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// a file that throws its bytes away, buffered as a file would be; keeps
+// them if asked to
+class discard : public streambuf
+{
+    char buf[1 << 16];
+
+public:
+    size_t size = 0;
+    string * keep = nullptr;
+
+    discard()
+    {
+        setp(buf, buf + sizeof buf);
+    }
+
+protected:
+    int_type overflow(int_type c) override
+    {
+        size += static_cast<size_t>(pptr() - pbase());
+        if (keep)
+            keep->append(pbase(), pptr());
+        setp(buf, buf + sizeof buf);
+        if (!traits_type::eq_int_type(c, traits_type::eof()))
+            sputc(traits_type::to_char_type(c));
+        return traits_type::not_eof(c);
+    }
+
+    int sync() override
+    {
+        overflow(traits_type::eof());
+        return 0;
+    }
+};
+
+const char * hosts[] = {"cache-01", "proxy", "数据库", "worker-β", "shard-7", "キャッシュ"};
+const char * notes[] = {"served from cache", "upstream timeout after retry", "", "ok",
+                           "connection reset by peer while reading the response body"};
+
+// the cells of row i, the same every time it is asked for
+struct row
+{
+    const char * host;
+    unsigned id;
+    bool failed;
+    unsigned ms;
+    const char * message;
+
+    explicit row(size_t i)
+    {
+        // splitmix64, as seeding a generator for every row would cost more
+        // than the row
+        uint64_t x = i * 0x9e3779b97f4a7c15;
+        auto rng = [&x]
+        {
+            uint64_t z = (x += 0x9e3779b97f4a7c15);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+            return static_cast<unsigned>((z ^ (z >> 31)) >> 32);
+        };
+        host = hosts[rng() % 6];
+        id = rng() % 1000000;
+        failed = rng() % 8 == 0;
+        ms = rng() % 2000;
+        message = notes[rng() % 5];
+    }
+};
+
+vector<dye::table::column> columns()
+{
+    using align = dye::table::align;
+    return {{"host"}, {"id", align::right}, {"status", align::center}, {"latency", align::right},
+            {"message", align::left, hue::GREY, 32}};
+}
+
+void streamed(ostream & os, size_t count)
+{
+    dye::table t(os, columns());
+    for (size_t i = 0; i != count; ++i) {
+        row r(i);
+        t.row(dye::aqua(r.host), r.id, r.failed ? dye::light_red("failed") : dye::green("ok"),
+              dye::yellow(to_string(r.ms)) + dye::grey(" ms"), r.message);
+    }
+}
+
+// the old way: every cell rendered and kept, the widths measured over all
+// of them, then the rows printed with the colors set by hand
+void prerendered(ostream & os, size_t count)
+{
+    struct cell
+    {
+        string text;
+        int color;
+    };
+    vector<dye::table::column> cols = columns();
+    vector<vector<vector<cell>>> rows;
+    rows.push_back({});
+    for (const auto & c : cols)
+        rows.back().push_back({{c.title, hue::BAD_COLOR}});
+    for (size_t i = 0; i != count; ++i) {
+        row r(i);
+        rows.push_back({{{r.host, hue::AQUA}}, {{to_string(r.id), hue::DEFAULT_COLOR}},
+                        {{r.failed ? "failed" : "ok", r.failed ? hue::LIGHT_RED : hue::GREEN}},
+                        {{to_string(r.ms), hue::YELLOW}, {" ms", hue::GREY}},
+                        {{r.message, hue::GREY}}});
+    }
+    vector<size_t> widths(cols.size());
+    for (const auto & r : rows)
+        for (size_t k = 0; k != cols.size(); ++k) {
+            size_t w = 0;
+            for (const auto & piece : r[k])
+                w += dye::width(piece.text);
+            widths[k] = max(widths[k], min(w, cols[k].limit ? cols[k].limit : w));
+        }
+    for (const auto & r : rows) {
+        for (size_t k = 0; k != cols.size(); ++k) {
+            string text;
+            for (const auto & piece : r[k])
+                text += piece.text;
+            size_t w = dye::width(text);
+            if (w > widths[k]) {
+                text = text.substr(0, dye::fit(text.data(), text.size(), widths[k] - 1)) + "\xe2\x80\xa6";
+                w = widths[k];
+            }
+            size_t gap = widths[k] - w;
+            size_t left = cols[k].side == dye::table::align::right ? gap :
+                          cols[k].side == dye::table::align::center ? gap / 2 : 0;
+            if (k)
+                os << "  ";
+            os << string(left, ' ');
+            size_t done = 0;
+            for (const auto & piece : r[k]) {
+                if (piece.color != hue::BAD_COLOR)
+                    hue::set(os, piece.color);
+                os << text.substr(min(done, text.size()), piece.text.size());
+                done += piece.text.size();
+                if (piece.color != hue::BAD_COLOR)
+                    hue::reset(os);
+            }
+            if (done < text.size())
+                os << text.substr(done);
+            if (k + 1 != cols.size())
+                os << string(gap - left, ' ');
+        }
+        os << '\n';
+    }
+}
+
+template<typename F>
+void run(const char * name, F f, size_t count, string * keep)
+{
+    discard d;
+    d.keep = keep;
+    ostream os(&d);
+    size_t before = in_use;
+    peak = in_use;
+    auto start = chrono::steady_clock::now();
+    f(os, count);
+    os.flush();
+    chrono::duration<double> s = chrono::steady_clock::now() - start;
+    cout << name << count / s.count() / 1e6 << " M rows/s, " << d.size / 1e6 << " MB written, "
+         << (peak - before) / 1024 << " KB of heap at most" << endl;
+}
+
+int main(int argc, char * argv[])
+{
+    size_t count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000000;
+
+    // a table that fits in one window lines up the same as the old way
+    {
+        string a, b;
+        run("check, streamed     ", streamed, 1000, &a);
+        run("check, prerendered  ", prerendered, 1000, &b);
+        cout << "text of 1000 rows " << (dye::plain(a) == dye::plain(b) ? "the same" : "DIFFERENT") << endl << endl;
+    }
+
+    run("dye::table          ", streamed, count, nullptr);
+    run("prerendered         ", prerendered, count, nullptr);
+    return 0;
+}
@@ -0,0 +1,162 @@
+// dye::width against rendering into a std::ostringstream and counting: the
+// code point widths checked against the C library's wcwidth, the SIMD levels
+// checked against each other, then the time to measure every cell of a
+// table of 100k rows, and the throughput on long text.  The exit status is
+// 1 if the levels disagree, or dye::plain with them.
+//
+//     g++ -std=c++11 -O2 -I../include width.cpp -o width
+
+#include "../include/color_width.hpp"
+#include <chrono>
+#include <clocale>
+#include <cwchar>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+string utf8(uint32_t c)
+{
+    string s;
+    if (c < 0x80) {
+        s += static_cast<char>(c);
+    }
+    else if (c < 0x800) {
+        s += static_cast<char>(0xc0 | c >> 6);
+        s += static_cast<char>(0x80 | (c & 0x3f));
+    }
+    else if (c < 0x10000) {
+        s += static_cast<char>(0xe0 | c >> 12);
+        s += static_cast<char>(0x80 | (c >> 6 & 0x3f));
+        s += static_cast<char>(0x80 | (c & 0x3f));
+    }
+    else {
+        s += static_cast<char>(0xf0 | c >> 18);
+        s += static_cast<char>(0x80 | (c >> 12 & 0x3f));
+        s += static_cast<char>(0x80 | (c >> 6 & 0x3f));
+        s += static_cast<char>(0x80 | (c & 0x3f));
+    }
+    return s;
+}
+
+typedef dye::colorful<dye::text> cell;
+
+int main()
+{
+    // every assigned code point, against wcwidth, where the C library has a
+    // UTF-8 locale; the two may follow different Unicode versions
+#if !defined(_WIN32)
+    if (setlocale(LC_CTYPE, "C.UTF-8") || setlocale(LC_CTYPE, "en_US.UTF-8")) {
+        int differ = 0, known = 0;
+        for (uint32_t c = 0x20; c != 0x110000; ++c) {
+            if (c >= 0xd800 && c <= 0xdfff)
+                continue;
+            int w = wcwidth(static_cast<wchar_t>(c));
+            if (w < 0)
+                continue;
+            ++known;
+            if (w != dye::unicode::width(c) && ++differ <= 5)
+                cout << "U+" << hex << c << dec << ": wcwidth " << w << ", ours " << dye::unicode::width(c) << endl;
+        }
+        cout << known << " code points wcwidth knows, " << differ << " differ" << endl;
+    }
+#endif
+
+    // text mixing ASCII, accents, CJK, emoji, controls and escapes, at
+    // every SIMD level
+    mt19937 rng(9);
+    const char * bits[] = {"hello ", "a", "é", "世界", "😀", "\t", "\x1b[31;40m", "\x1b[0m", "e\xcc\x81",
+                           "ｆｕｌｌ", "\xff", "0123456789abcdefghijklmnopqrstuvwxyz "};
+    bool agree = true;
+    {
+        dye::simd::level best = dye::simd::active();
+        bool same = true;
+        for (int round = 0; round != 20000; ++round) {
+            string s;
+            for (int k = rng() % 20; k; --k)
+                s += bits[rng() % 12];
+            size_t w[3];
+            for (int l = 0; l <= static_cast<int>(best); ++l) {
+                dye::simd::active() = static_cast<dye::simd::level>(l);
+                w[l] = dye::width(s);
+            }
+            for (int l = 1; l <= static_cast<int>(best); ++l)
+                same = same && w[l] == w[0];
+            same = same && dye::width(s) == dye::width(dye::plain(s));
+            // dyed, the escapes in the string are no text either
+            auto dyed = dye::red(s);
+            same = same && dye::plain(dyed) == dye::plain(s) && dye::width(dyed) == dye::width(dye::plain(dyed));
+        }
+        dye::simd::active() = best;
+        cout << "20000 random strings, all levels " << (same ? "agree" : "DISAGREE") << endl;
+        agree = same;
+    }
+
+    // a table of 100k rows of five dyed cells
+    const char * hosts[] = {"cache-01", "proxy", "数据库", "worker-β", "shard-7", "キャッシュ"};
+    vector<cell> cells;
+    for (int row = 0; row != 100000; ++row) {
+        cells.push_back(dye::aqua(hosts[rng() % 6]));
+        cells.push_back(dye::yellow(to_string(rng() % 100000)));
+        cells.push_back(rng() % 4 ? dye::green("ok") : dye::light_red("失败") + dye::grey(" (retry)"));
+        cells.push_back(dye::white(to_string(rng() % 1000)) + dye::grey(" ms"));
+        cells.push_back(dye::purple(string(rng() % 24, '#')));
+    }
+    vector<size_t> widths(cells.size());
+
+    auto start = chrono::steady_clock::now();
+    size_t wrong = 0;
+    for (size_t i = 0; i != cells.size(); ++i) {
+        ostringstream os;
+        os << cells[i];
+        wrong += os.str().size() != dye::width(cells[i]);
+    }
+    chrono::duration<double> d = chrono::steady_clock::now() - start;
+    cout << endl << cells.size() << " cells" << endl;
+    cout << "render and count bytes  " << d.count() * 1e9 / cells.size() << " ns a cell, "
+         << wrong << " cells measured wrong" << endl;
+
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i != cells.size(); ++i) {
+        ostringstream os;
+        os << cells[i];
+        widths[i] = dye::width(os.str());
+    }
+    d = chrono::steady_clock::now() - start;
+    cout << "render and dye::width   " << d.count() * 1e9 / cells.size() << " ns a cell" << endl;
+
+    start = chrono::steady_clock::now();
+    bool same = true;
+    for (size_t i = 0; i != cells.size(); ++i)
+        same = same && dye::width(cells[i]) == widths[i];
+    d = chrono::steady_clock::now() - start;
+    cout << "dye::width              " << d.count() * 1e9 / cells.size() << " ns a cell, "
+         << (same ? "same widths" : "DIFFERENT widths") << endl;
+
+    start = chrono::steady_clock::now();
+    size_t bytes = 0;
+    for (const auto & c : cells)
+        bytes += dye::plain(c).size();
+    d = chrono::steady_clock::now() - start;
+    cout << "dye::plain              " << d.count() * 1e9 / cells.size() << " ns a cell, " << bytes << " bytes" << endl;
+
+    // long lines, mostly ASCII
+    string text;
+    while (text.size() < (64 << 20))
+        text += rng() % 16 ? bits[11] : bits[rng() % 11];
+    cout << endl << text.size() / 1e6 << " MB of text" << endl;
+    dye::simd::level best = dye::simd::active();
+    for (int l = 0; l <= static_cast<int>(best); ++l) {
+        dye::simd::active() = static_cast<dye::simd::level>(l);
+        start = chrono::steady_clock::now();
+        size_t w = dye::width(text);
+        d = chrono::steady_clock::now() - start;
+        cout << "width " << dye::simd::name(dye::simd::active()) << string(8 - strlen(dye::simd::name(dye::simd::active())), ' ')
+             << text.size() / d.count() / 1e6 << " MB/s, " << w << " columns" << endl;
+    }
+    dye::simd::active() = best;
+    return agree ? 0 : 1;
+}
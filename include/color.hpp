@@ -2,13 +2,61 @@
 #define COLOR_HPP
 
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
 #include <iostream>
-#include <list>
 #include <map>
+#include <new>
+#include <sstream>
+#include <stdexcept>
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
+
+// Pick the console backend: the Win32 attribute API (default on Windows), or
+// ANSI/VT escape sequences written straight into the target stream (default
+// elsewhere).  Define one of the two macros before inclusion to override, or
+// COLOR_CONSOLE_RECORD for a backend that writes no colors and keeps every
+// change in memory instead, for benchmarks and tests.
+#if !defined(COLOR_CONSOLE_WIN32) && !defined(COLOR_CONSOLE_ANSI) && !defined(COLOR_CONSOLE_RECORD)
+#   if defined(_WIN32)
+#       define COLOR_CONSOLE_WIN32
+#   else
+#       define COLOR_CONSOLE_ANSI
+#   endif
+#endif
+
+#if defined(COLOR_CONSOLE_WIN32)
 #include <windows.h>
+#endif
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#   define COLOR_CONSOLE_CPP17 1
+#   include <string_view>
+#else
+#   define COLOR_CONSOLE_CPP17 0
+#endif
+
+// Count the work coloring does, in hue::stats, when COLOR_CONSOLE_STATS is
+// defined before inclusion; the counting compiles to nothing otherwise.
+#if defined(COLOR_CONSOLE_STATS)
+#   include <atomic>
+#   include <mutex>
+#   define COLOR_CONSOLE_COUNT(what, n) ::hue::stats::count(::hue::stats::field::what, n)
+#else
+#   define COLOR_CONSOLE_COUNT(what, n) ((void)0)
+#endif
 
 namespace hue
 {
@@ -53,826 +101,2699 @@ namespace hue
         {15, "bright white"}
     };
 
-    inline bool is_good(int c)
+    // compile-time color codes, so that tags need no parsing at run time
+    constexpr int BLACK         =  0;
+    constexpr int BLUE          =  1;
+    constexpr int GREEN         =  2;
+    constexpr int AQUA          =  3;
+    constexpr int RED           =  4;
+    constexpr int PURPLE        =  5;
+    constexpr int YELLOW        =  6;
+    constexpr int WHITE         =  7;
+    constexpr int GREY          =  8;
+    constexpr int LIGHT_BLUE    =  9;
+    constexpr int LIGHT_GREEN   = 10;
+    constexpr int LIGHT_AQUA    = 11;
+    constexpr int LIGHT_RED     = 12;
+    constexpr int LIGHT_PURPLE  = 13;
+    constexpr int LIGHT_YELLOW  = 14;
+    constexpr int BRIGHT_WHITE  = 15;
+
+    constexpr bool is_good(int c)
     {
         return 0 <= c && c < 256;
     }
 
-    inline int itoc(int c)
+    // Colors past the console's 16: an entry of the xterm 256-color palette
+    // or a 24-bit RGB value, for the text, or for the background with the
+    // text left in the terminal's default.  They share the int with the
+    // console codes, flagged above them.  Terminals that cannot show them,
+    // and the Win32 console, get the nearest of the 16 instead.
+    constexpr int EXTENDED      = 1 << 30;
+    constexpr int BACKGROUND    = 1 << 25;  // the color is the background's
+    constexpr int INDEXED       = 1 << 24;  // the low byte is a palette index
+
+    constexpr bool is_extended(int c)
     {
-        return is_good(c) ? c : BAD_COLOR;
+        return (c & ~(BACKGROUND | INDEXED | 0xffffff)) == EXTENDED && (!(c & INDEXED) || !(c & 0xffff00));
     }
 
-    inline int itoc(int a, int b)
+    constexpr int channel(int v)
     {
-        return itoc(a + b * 16);
+        return v < 0 ? 0 : v > 255 ? 255 : v;
     }
 
-    // std::string to color
-    int stoc(std::string a)
+    constexpr int rgb(int r, int g, int b)
     {
-        // convert s to lowercase, and format variants like  "light_blue"
-        std::transform(a.begin(), a.end(), a.begin(), [](char c)
-                       {
-                            if ('A' <= c && c <= 'Z')
-                                c = c - 'A' + 'a';
-                            else if (c == '_' || c == '-')
-                                c = ' ';
-                            return c;
-                        });
+        return EXTENDED | channel(r) << 16 | channel(g) << 8 | channel(b);
+    }
 
-        // operator[] on std::map is non-const, use std::map::at instead
-        return (CODES.find(a) != CODES.end()) ? CODES.at(a) : BAD_COLOR;
+    constexpr int on_rgb(int r, int g, int b)
+    {
+        return rgb(r, g, b) | BACKGROUND;
     }
 
-    int stoc(std::string a, std::string b)
+    constexpr int xterm256(int n)
     {
-        return itoc(stoc(a), stoc(b));
+        return (0 <= n && n < 256) ? EXTENDED | INDEXED | n : BAD_COLOR;
     }
 
-    std::string ctos(int c)
+    constexpr int on_xterm256(int n)
     {
-        return (0 <= c && c < 256) ?
-               "(text) " + NAMES.at(c % 16) + " + " +
-               "(background) " + NAMES.at(c / 16) :
-               "BAD COLOR";
+        return (0 <= n && n < 256) ? EXTENDED | INDEXED | BACKGROUND | n : BAD_COLOR;
     }
 
-    int get()
+    constexpr int itoc(int c)
     {
-        CONSOLE_SCREEN_BUFFER_INFO i;
-        return GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &i) ?
-               i.wAttributes : BAD_COLOR;
+        return (is_good(c) || is_extended(c)) ? c : BAD_COLOR;
     }
 
-    int get_text()
+    constexpr int itoc(int a, int b)
     {
-        return (get() != BAD_COLOR) ? get() % 16 : BAD_COLOR;
+        return itoc(a + b * 16);
     }
 
-    int get_background()
+    namespace lookup
     {
-        return (get() != BAD_COLOR) ? get() / 16 : BAD_COLOR;
+        // compare color names ignoring case, with '_' and '-' read as ' '
+        constexpr char fold(char c)
+        {
+            return ('A' <= c && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') :
+                   (c == '_' || c == '-') ? ' ' : c;
+        }
+
+        constexpr unsigned byte(const char * s, std::size_t i)
+        {
+            return static_cast<unsigned char>(fold(s[i]));
+        }
+
+        // perfect hash of the folded names in CODES, no two land in one slot
+        constexpr std::size_t hash(const char * s, std::size_t n)
+        {
+            return (byte(s, 0) * 3 + byte(s, n - 1) * 3 + n * 4 + byte(s, n / 2) * 8) & 63;
+        }
+
+        struct entry
+        {
+            const char * name;
+            std::size_t size;
+            int code;
+        };
+
+        constexpr entry TABLE[64] = {
+            {"r",             1,         4}, {"",              0, BAD_COLOR},
+            {"lb",            2,         9}, {"black",         5,         0},
+            {"",              0, BAD_COLOR}, {"bright white", 12,        15},
+            {"w",             1,         7}, {"",              0, BAD_COLOR},
+            {"yellow",        6,         6}, {"",              0, BAD_COLOR},
+            {"e",             1,         8}, {"bw",            2,        15},
+            {"",              0, BAD_COLOR}, {"blue",          4,         1},
+            {"",              0, BAD_COLOR}, {"light aqua",   10,        11},
+            {"",              0, BAD_COLOR}, {"",              0, BAD_COLOR},
+            {"a",             1,         3}, {"",              0, BAD_COLOR},
+            {"",              0, BAD_COLOR}, {"",              0, BAD_COLOR},
+            {"",              0, BAD_COLOR}, {"purple",        6,         5},
+            {"grey",          4,         8}, {"",              0, BAD_COLOR},
+            {"",              0, BAD_COLOR}, {"light blue",   10,         9},
+            {"lp",            2,        13}, {"",              0, BAD_COLOR},
+            {"k",             1,         0}, {"",              0, BAD_COLOR},
+            {"b",             1,         1}, {"light yellow", 12,        14},
+            {"y",             1,         6}, {"light purple", 12,        13},
+            {"p",             1,         5}, {"",              0, BAD_COLOR},
+            {"g",             1,         2}, {"",              0, BAD_COLOR},
+            {"",              0, BAD_COLOR}, {"",              0, BAD_COLOR},
+            {"",              0, BAD_COLOR}, {"",              0, BAD_COLOR},
+            {"",              0, BAD_COLOR}, {"",              0, BAD_COLOR},
+            {"",              0, BAD_COLOR}, {"",              0, BAD_COLOR},
+            {"white",         5,         7}, {"",              0, BAD_COLOR},
+            {"lr",            2,        12}, {"",              0, BAD_COLOR},
+            {"light red",     9,        12}, {"",              0, BAD_COLOR},
+            {"red",           3,         4}, {"la",            2,        11},
+            {"",              0, BAD_COLOR}, {"lg",            2,        10},
+            {"light green",  11,        10}, {"green",         5,         2},
+            {"",              0, BAD_COLOR}, {"",              0, BAD_COLOR},
+            {"aqua",          4,         3}, {"ly",            2,        14}
+        };
+
+        constexpr bool equal(const char * s, const char * name, std::size_t n)
+        {
+            return n == 0 || (fold(*s) == *name && equal(s + 1, name + 1, n - 1));
+        }
+
+        constexpr int find(const char * s, std::size_t n, const entry & e)
+        {
+            return (e.size == n && equal(s, e.name, n)) ? e.code : BAD_COLOR;
+        }
+
+        constexpr std::size_t length(const char * s)
+        {
+            return *s ? 1 + length(s + 1) : 0;
+        }
     }
 
-    void set(int c)
+    // color name to color, without allocating
+    constexpr int stoc(const char * s, std::size_t n)
     {
-        if (is_good(c))
-            SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), c);
+        return n == 0 ? BAD_COLOR : lookup::find(s, n, lookup::TABLE[lookup::hash(s, n)]);
     }
 
-    void set(int a, int b)
+    constexpr int stoc(const char * a)
     {
-        set(a + b * 16);
+        return stoc(a, lookup::length(a));
     }
 
-    void set(std::string a, std::string b)
+#if COLOR_CONSOLE_CPP17
+    constexpr int stoc(std::string_view a)
     {
-        set(stoc(a) + stoc(b) * 16);
+        return stoc(a.data(), a.size());
     }
 
-    void set_text(std::string a)
+    constexpr int stoc(std::string_view a, std::string_view b)
     {
-        set(stoc(a), get_background());
+        return itoc(stoc(a), stoc(b));
+    }
+#else
+    inline int stoc(const std::string & a)
+    {
+        return stoc(a.data(), a.size());
     }
 
-    void set_background(std::string b)
+    inline int stoc(const std::string & a, const std::string & b)
     {
-        set(get_text(), stoc(b));
+        return itoc(stoc(a), stoc(b));
     }
+#endif
 
-    void reset()
+    inline std::string ctos(int c)
     {
-        set(DEFAULT_COLOR);
+        if (is_extended(c))
+            return std::string(c & BACKGROUND ? "(background) " : "(text) ") +
+                   (c & INDEXED ? "xterm " + std::to_string(c & 0xff) :
+                    "rgb " + std::to_string(c >> 16 & 0xff) + " " + std::to_string(c >> 8 & 0xff) +
+                    " " + std::to_string(c & 0xff));
+        return (0 <= c && c < 256) ?
+               "(text) " + NAMES.at(c % 16) + " + " +
+               "(background) " + NAMES.at(c / 16) :
+               "BAD COLOR";
     }
 
-    int invert(int c)
+    // what coloring has cost since the last reset(), over all threads
+    namespace stats
     {
-        if (is_good(c)) {
-            int a = c % 16;
-            int b = c / 16;
-            return b + a * 16;
+        struct counters
+        {
+            unsigned long long sets;            // calls to hue::set, resets included
+            unsigned long long resets;          // calls to hue::reset
+            unsigned long long redundant;       // sets of the color already set
+            unsigned long long queries;         // colors read from the console, not a stream's shadow
+            unsigned long long console_calls;   // calls into the Win32 console API
+            unsigned long long escape_bytes;    // bytes of SGR sequences written
+            unsigned long long items;           // dyed items, and builder and styled_string runs, rendered
+            unsigned long long allocations;     // heap blocks taken by dye::colorful chains
+        };
+
+#if defined(COLOR_CONSOLE_STATS)
+        constexpr bool enabled = true;
+
+        enum class field
+        {
+            sets,
+            resets,
+            redundant,
+            queries,
+            console_calls,
+            escape_bytes,
+            items,
+            allocations,
+            count
+        };
+
+        constexpr std::size_t FIELDS = static_cast<std::size_t>(field::count);
+
+        // each thread counts into a block of its own, with no lock and no
+        // read-modify-write; a thread that ends adds its counts to ended
+        struct block
+        {
+            std::atomic<unsigned long long> n[FIELDS];
+
+            block();
+            ~block();
+        };
+
+        struct registry
+        {
+            std::mutex lock;
+            std::vector<block *> live;
+            unsigned long long ended[FIELDS] = {};
+            unsigned long long zero[FIELDS] = {};
+        };
+
+        // never destroyed, as threads may end after static destruction
+        inline registry & all()
+        {
+            static registry * r = new registry;
+            return *r;
         }
-        else
-            return BAD_COLOR;
+
+        inline block::block()
+        {
+            for (auto & k : n)
+                k.store(0, std::memory_order_relaxed);
+            std::lock_guard<std::mutex> hold(all().lock);
+            all().live.push_back(this);
+        }
+
+        inline block::~block()
+        {
+            registry & r = all();
+            std::lock_guard<std::mutex> hold(r.lock);
+            for (std::size_t i = 0; i != FIELDS; ++i)
+                r.ended[i] += n[i].load(std::memory_order_relaxed);
+            r.live.erase(std::find(r.live.begin(), r.live.end(), this));
+        }
+
+        // the block is reached through a plain pointer, which needs no
+        // guard on every access as the block itself would
+        inline block & local()
+        {
+            static thread_local block * fast = nullptr;
+            if (!fast) {
+                static thread_local block b;
+                fast = &b;
+            }
+            return *fast;
+        }
+
+        // only this thread writes its block, so a plain load and store will do
+        inline void count(field f, unsigned long long k)
+        {
+            std::atomic<unsigned long long> & c = local().n[static_cast<std::size_t>(f)];
+            c.store(c.load(std::memory_order_relaxed) + k, std::memory_order_relaxed);
+        }
+
+        inline void total(registry & r, unsigned long long (&sum)[FIELDS])
+        {
+            for (std::size_t i = 0; i != FIELDS; ++i)
+                sum[i] = r.ended[i];
+            for (const block * b : r.live)
+                for (std::size_t i = 0; i != FIELDS; ++i)
+                    sum[i] += b->n[i].load(std::memory_order_relaxed);
+        }
+
+        inline counters snapshot()
+        {
+            registry & r = all();
+            unsigned long long sum[FIELDS];
+            {
+                std::lock_guard<std::mutex> hold(r.lock);
+                total(r, sum);
+                for (std::size_t i = 0; i != FIELDS; ++i)
+                    sum[i] -= r.zero[i];
+            }
+            return counters{sum[0], sum[1], sum[2], sum[3], sum[4], sum[5], sum[6], sum[7]};
+        }
+
+        // counting starts over from here; no thread's block is written to
+        inline void reset()
+        {
+            registry & r = all();
+            std::lock_guard<std::mutex> hold(r.lock);
+            total(r, r.zero);
+        }
+#else
+        constexpr bool enabled = false;
+
+        inline counters snapshot()
+        {
+            return counters{0, 0, 0, 0, 0, 0, 0, 0};
+        }
+
+        inline void reset()
+        {
+        }
+#endif
     }
 
-    std::ostream & reset(std::ostream & os)                 { reset();                return os; }
-    std::ostream & black(std::ostream & os)                 { set_text("k");          return os; }
-    std::ostream & blue(std::ostream & os)                  { set_text("b");          return os; }
-    std::ostream & green(std::ostream & os)                 { set_text("g");          return os; }
-    std::ostream & aqua(std::ostream & os)                  { set_text("a");          return os; }
-    std::ostream & red(std::ostream & os)                   { set_text("r");          return os; }
-    std::ostream & purple(std::ostream & os)                { set_text("p");          return os; }
-    std::ostream & yellow(std::ostream & os)                { set_text("y");          return os; }
-    std::ostream & white(std::ostream & os)                 { set_text("w");          return os; }
-    std::ostream & grey(std::ostream & os)                  { set_text("e");          return os; }
-    std::ostream & light_blue(std::ostream & os)            { set_text("lb");         return os; }
-    std::ostream & light_green(std::ostream & os)           { set_text("lg");         return os; }
-    std::ostream & light_aqua(std::ostream & os)            { set_text("la");         return os; }
-    std::ostream & light_red(std::ostream & os)             { set_text("lr");         return os; }
-    std::ostream & light_purple(std::ostream & os)          { set_text("lp");         return os; }
-    std::ostream & light_yellow(std::ostream & os)          { set_text("ly");         return os; }
-    std::ostream & bright_white(std::ostream & os)          { set_text("bw");         return os; }
-    std::ostream & on_black(std::ostream & os)              { set_background("k");    return os; }
-    std::ostream & on_blue(std::ostream & os)               { set_background("b");    return os; }
-    std::ostream & on_green(std::ostream & os)              { set_background("g");    return os; }
-    std::ostream & on_aqua(std::ostream & os)               { set_background("a");    return os; }
-    std::ostream & on_red(std::ostream & os)                { set_background("r");    return os; }
-    std::ostream & on_purple(std::ostream & os)             { set_background("p");    return os; }
-    std::ostream & on_yellow(std::ostream & os)             { set_background("y");    return os; }
-    std::ostream & on_white(std::ostream & os)              { set_background("w");    return os; }
-    std::ostream & on_grey(std::ostream & os)               { set_background("e");    return os; }
-    std::ostream & on_light_blue(std::ostream & os)         { set_background("lb");   return os; }
-    std::ostream & on_light_green(std::ostream & os)        { set_background("lg");   return os; }
-    std::ostream & on_light_aqua(std::ostream & os)         { set_background("la");   return os; }
-    std::ostream & on_light_red(std::ostream & os)          { set_background("lr");   return os; }
-    std::ostream & on_light_purple(std::ostream & os)       { set_background("lp");   return os; }
-    std::ostream & on_light_yellow(std::ostream & os)       { set_background("ly");   return os; }
-    std::ostream & on_bright_white(std::ostream & os)       { set_background("bw");   return os; }
-    std::ostream & black_on_black(std::ostream & os)               { set("k", "k");   return os; }
-    std::ostream & black_on_blue(std::ostream & os)                { set("k", "b");   return os; }
-    std::ostream & black_on_green(std::ostream & os)               { set("k", "g");   return os; }
-    std::ostream & black_on_aqua(std::ostream & os)                { set("k", "a");   return os; }
-    std::ostream & black_on_red(std::ostream & os)                 { set("k", "r");   return os; }
-    std::ostream & black_on_purple(std::ostream & os)              { set("k", "p");   return os; }
-    std::ostream & black_on_yellow(std::ostream & os)              { set("k", "y");   return os; }
-    std::ostream & black_on_white(std::ostream & os)               { set("k", "w");   return os; }
-    std::ostream & black_on_grey(std::ostream & os)                { set("k", "e");   return os; }
-    std::ostream & black_on_light_blue(std::ostream & os)          { set("k", "lb");  return os; }
-    std::ostream & black_on_light_green(std::ostream & os)         { set("k", "lg");  return os; }
-    std::ostream & black_on_light_aqua(std::ostream & os)          { set("k", "la");  return os; }
-    std::ostream & black_on_light_red(std::ostream & os)           { set("k", "lr");  return os; }
-    std::ostream & black_on_light_purple(std::ostream & os)        { set("k", "lp");  return os; }
-    std::ostream & black_on_light_yellow(std::ostream & os)        { set("k", "ly");  return os; }
-    std::ostream & black_on_bright_white(std::ostream & os)        { set("k", "bw");  return os; }
-    std::ostream & blue_on_black(std::ostream & os)                { set("b", "k");   return os; }
-    std::ostream & blue_on_blue(std::ostream & os)                 { set("b", "b");   return os; }
-    std::ostream & blue_on_green(std::ostream & os)                { set("b", "g");   return os; }
-    std::ostream & blue_on_aqua(std::ostream & os)                 { set("b", "a");   return os; }
-    std::ostream & blue_on_red(std::ostream & os)                  { set("b", "r");   return os; }
-    std::ostream & blue_on_purple(std::ostream & os)               { set("b", "p");   return os; }
-    std::ostream & blue_on_yellow(std::ostream & os)               { set("b", "y");   return os; }
-    std::ostream & blue_on_white(std::ostream & os)                { set("b", "w");   return os; }
-    std::ostream & blue_on_grey(std::ostream & os)                 { set("b", "e");   return os; }
-    std::ostream & blue_on_light_blue(std::ostream & os)           { set("b", "lb");  return os; }
-    std::ostream & blue_on_light_green(std::ostream & os)          { set("b", "lg");  return os; }
-    std::ostream & blue_on_light_aqua(std::ostream & os)           { set("b", "la");  return os; }
-    std::ostream & blue_on_light_red(std::ostream & os)            { set("b", "lr");  return os; }
-    std::ostream & blue_on_light_purple(std::ostream & os)         { set("b", "lp");  return os; }
-    std::ostream & blue_on_light_yellow(std::ostream & os)         { set("b", "ly");  return os; }
-    std::ostream & blue_on_bright_white(std::ostream & os)         { set("b", "bw");  return os; }
-    std::ostream & green_on_black(std::ostream & os)               { set("g", "k");   return os; }
-    std::ostream & green_on_blue(std::ostream & os)                { set("g", "b");   return os; }
-    std::ostream & green_on_green(std::ostream & os)               { set("g", "g");   return os; }
-    std::ostream & green_on_aqua(std::ostream & os)                { set("g", "a");   return os; }
-    std::ostream & green_on_red(std::ostream & os)                 { set("g", "r");   return os; }
-    std::ostream & green_on_purple(std::ostream & os)              { set("g", "p");   return os; }
-    std::ostream & green_on_yellow(std::ostream & os)              { set("g", "y");   return os; }
-    std::ostream & green_on_white(std::ostream & os)               { set("g", "w");   return os; }
-    std::ostream & green_on_grey(std::ostream & os)                { set("g", "e");   return os; }
-    std::ostream & green_on_light_blue(std::ostream & os)          { set("g", "lb");  return os; }
-    std::ostream & green_on_light_green(std::ostream & os)         { set("g", "lg");  return os; }
-    std::ostream & green_on_light_aqua(std::ostream & os)          { set("g", "la");  return os; }
-    std::ostream & green_on_light_red(std::ostream & os)           { set("g", "lr");  return os; }
-    std::ostream & green_on_light_purple(std::ostream & os)        { set("g", "lp");  return os; }
-    std::ostream & green_on_light_yellow(std::ostream & os)        { set("g", "ly");  return os; }
-    std::ostream & green_on_bright_white(std::ostream & os)        { set("g", "bw");  return os; }
-    std::ostream & aqua_on_black(std::ostream & os)                { set("a", "k");   return os; }
-    std::ostream & aqua_on_blue(std::ostream & os)                 { set("a", "b");   return os; }
-    std::ostream & aqua_on_green(std::ostream & os)                { set("a", "g");   return os; }
-    std::ostream & aqua_on_aqua(std::ostream & os)                 { set("a", "a");   return os; }
-    std::ostream & aqua_on_red(std::ostream & os)                  { set("a", "r");   return os; }
-    std::ostream & aqua_on_purple(std::ostream & os)               { set("a", "p");   return os; }
-    std::ostream & aqua_on_yellow(std::ostream & os)               { set("a", "y");   return os; }
-    std::ostream & aqua_on_white(std::ostream & os)                { set("a", "w");   return os; }
-    std::ostream & aqua_on_grey(std::ostream & os)                 { set("a", "e");   return os; }
-    std::ostream & aqua_on_light_blue(std::ostream & os)           { set("a", "lb");  return os; }
-    std::ostream & aqua_on_light_green(std::ostream & os)          { set("a", "lg");  return os; }
-    std::ostream & aqua_on_light_aqua(std::ostream & os)           { set("a", "la");  return os; }
-    std::ostream & aqua_on_light_red(std::ostream & os)            { set("a", "lr");  return os; }
-    std::ostream & aqua_on_light_purple(std::ostream & os)         { set("a", "lp");  return os; }
-    std::ostream & aqua_on_light_yellow(std::ostream & os)         { set("a", "ly");  return os; }
-    std::ostream & aqua_on_bright_white(std::ostream & os)         { set("a", "bw");  return os; }
-    std::ostream & red_on_black(std::ostream & os)                 { set("r", "k");   return os; }
-    std::ostream & red_on_blue(std::ostream & os)                  { set("r", "b");   return os; }
-    std::ostream & red_on_green(std::ostream & os)                 { set("r", "g");   return os; }
-    std::ostream & red_on_aqua(std::ostream & os)                  { set("r", "a");   return os; }
-    std::ostream & red_on_red(std::ostream & os)                   { set("r", "r");   return os; }
-    std::ostream & red_on_purple(std::ostream & os)                { set("r", "p");   return os; }
-    std::ostream & red_on_yellow(std::ostream & os)                { set("r", "y");   return os; }
-    std::ostream & red_on_white(std::ostream & os)                 { set("r", "w");   return os; }
-    std::ostream & red_on_grey(std::ostream & os)                  { set("r", "e");   return os; }
-    std::ostream & red_on_light_blue(std::ostream & os)            { set("r", "lb");  return os; }
-    std::ostream & red_on_light_green(std::ostream & os)           { set("r", "lg");  return os; }
-    std::ostream & red_on_light_aqua(std::ostream & os)            { set("r", "la");  return os; }
-    std::ostream & red_on_light_red(std::ostream & os)             { set("r", "lr");  return os; }
-    std::ostream & red_on_light_purple(std::ostream & os)          { set("r", "lp");  return os; }
-    std::ostream & red_on_light_yellow(std::ostream & os)          { set("r", "ly");  return os; }
-    std::ostream & red_on_bright_white(std::ostream & os)          { set("r", "bw");  return os; }
-    std::ostream & purple_on_black(std::ostream & os)              { set("p", "k");   return os; }
-    std::ostream & purple_on_blue(std::ostream & os)               { set("p", "b");   return os; }
-    std::ostream & purple_on_green(std::ostream & os)              { set("p", "g");   return os; }
-    std::ostream & purple_on_aqua(std::ostream & os)               { set("p", "a");   return os; }
-    std::ostream & purple_on_red(std::ostream & os)                { set("p", "r");   return os; }
-    std::ostream & purple_on_purple(std::ostream & os)             { set("p", "p");   return os; }
-    std::ostream & purple_on_yellow(std::ostream & os)             { set("p", "y");   return os; }
-    std::ostream & purple_on_white(std::ostream & os)              { set("p", "w");   return os; }
-    std::ostream & purple_on_grey(std::ostream & os)               { set("p", "e");   return os; }
-    std::ostream & purple_on_light_blue(std::ostream & os)         { set("p", "lb");  return os; }
-    std::ostream & purple_on_light_green(std::ostream & os)        { set("p", "lg");  return os; }
-    std::ostream & purple_on_light_aqua(std::ostream & os)         { set("p", "la");  return os; }
-    std::ostream & purple_on_light_red(std::ostream & os)          { set("p", "lr");  return os; }
-    std::ostream & purple_on_light_purple(std::ostream & os)       { set("p", "lp");  return os; }
-    std::ostream & purple_on_light_yellow(std::ostream & os)       { set("p", "ly");  return os; }
-    std::ostream & purple_on_bright_white(std::ostream & os)       { set("p", "bw");  return os; }
-    std::ostream & yellow_on_black(std::ostream & os)              { set("y", "k");   return os; }
-    std::ostream & yellow_on_blue(std::ostream & os)               { set("y", "b");   return os; }
-    std::ostream & yellow_on_green(std::ostream & os)              { set("y", "g");   return os; }
-    std::ostream & yellow_on_aqua(std::ostream & os)               { set("y", "a");   return os; }
-    std::ostream & yellow_on_red(std::ostream & os)                { set("y", "r");   return os; }
-    std::ostream & yellow_on_purple(std::ostream & os)             { set("y", "p");   return os; }
-    std::ostream & yellow_on_yellow(std::ostream & os)             { set("y", "y");   return os; }
-    std::ostream & yellow_on_white(std::ostream & os)              { set("y", "w");   return os; }
-    std::ostream & yellow_on_grey(std::ostream & os)               { set("y", "e");   return os; }
-    std::ostream & yellow_on_light_blue(std::ostream & os)         { set("y", "lb");  return os; }
-    std::ostream & yellow_on_light_green(std::ostream & os)        { set("y", "lg");  return os; }
-    std::ostream & yellow_on_light_aqua(std::ostream & os)         { set("y", "la");  return os; }
-    std::ostream & yellow_on_light_red(std::ostream & os)          { set("y", "lr");  return os; }
-    std::ostream & yellow_on_light_purple(std::ostream & os)       { set("y", "lp");  return os; }
-    std::ostream & yellow_on_light_yellow(std::ostream & os)       { set("y", "ly");  return os; }
-    std::ostream & yellow_on_bright_white(std::ostream & os)       { set("y", "bw");  return os; }
-    std::ostream & white_on_black(std::ostream & os)               { set("w", "k");   return os; }
-    std::ostream & white_on_blue(std::ostream & os)                { set("w", "b");   return os; }
-    std::ostream & white_on_green(std::ostream & os)               { set("w", "g");   return os; }
-    std::ostream & white_on_aqua(std::ostream & os)                { set("w", "a");   return os; }
-    std::ostream & white_on_red(std::ostream & os)                 { set("w", "r");   return os; }
-    std::ostream & white_on_purple(std::ostream & os)              { set("w", "p");   return os; }
-    std::ostream & white_on_yellow(std::ostream & os)              { set("w", "y");   return os; }
-    std::ostream & white_on_white(std::ostream & os)               { set("w", "w");   return os; }
-    std::ostream & white_on_grey(std::ostream & os)                { set("w", "e");   return os; }
-    std::ostream & white_on_light_blue(std::ostream & os)          { set("w", "lb");  return os; }
-    std::ostream & white_on_light_green(std::ostream & os)         { set("w", "lg");  return os; }
-    std::ostream & white_on_light_aqua(std::ostream & os)          { set("w", "la");  return os; }
-    std::ostream & white_on_light_red(std::ostream & os)           { set("w", "lr");  return os; }
-    std::ostream & white_on_light_purple(std::ostream & os)        { set("w", "lp");  return os; }
-    std::ostream & white_on_light_yellow(std::ostream & os)        { set("w", "ly");  return os; }
-    std::ostream & white_on_bright_white(std::ostream & os)        { set("w", "bw");  return os; }
-    std::ostream & grey_on_black(std::ostream & os)                { set("e", "k");   return os; }
-    std::ostream & grey_on_blue(std::ostream & os)                 { set("e", "b");   return os; }
-    std::ostream & grey_on_green(std::ostream & os)                { set("e", "g");   return os; }
-    std::ostream & grey_on_aqua(std::ostream & os)                 { set("e", "a");   return os; }
-    std::ostream & grey_on_red(std::ostream & os)                  { set("e", "r");   return os; }
-    std::ostream & grey_on_purple(std::ostream & os)               { set("e", "p");   return os; }
-    std::ostream & grey_on_yellow(std::ostream & os)               { set("e", "y");   return os; }
-    std::ostream & grey_on_white(std::ostream & os)                { set("e", "w");   return os; }
-    std::ostream & grey_on_grey(std::ostream & os)                 { set("e", "e");   return os; }
-    std::ostream & grey_on_light_blue(std::ostream & os)           { set("e", "lb");  return os; }
-    std::ostream & grey_on_light_green(std::ostream & os)          { set("e", "lg");  return os; }
-    std::ostream & grey_on_light_aqua(std::ostream & os)           { set("e", "la");  return os; }
-    std::ostream & grey_on_light_red(std::ostream & os)            { set("e", "lr");  return os; }
-    std::ostream & grey_on_light_purple(std::ostream & os)         { set("e", "lp");  return os; }
-    std::ostream & grey_on_light_yellow(std::ostream & os)         { set("e", "ly");  return os; }
-    std::ostream & grey_on_bright_white(std::ostream & os)         { set("e", "bw");  return os; }
-    std::ostream & light_blue_on_black(std::ostream & os)          { set("lb", "k");  return os; }
-    std::ostream & light_blue_on_blue(std::ostream & os)           { set("lb", "b");  return os; }
-    std::ostream & light_blue_on_green(std::ostream & os)          { set("lb", "g");  return os; }
-    std::ostream & light_blue_on_aqua(std::ostream & os)           { set("lb", "a");  return os; }
-    std::ostream & light_blue_on_red(std::ostream & os)            { set("lb", "r");  return os; }
-    std::ostream & light_blue_on_purple(std::ostream & os)         { set("lb", "p");  return os; }
-    std::ostream & light_blue_on_yellow(std::ostream & os)         { set("lb", "y");  return os; }
-    std::ostream & light_blue_on_white(std::ostream & os)          { set("lb", "w");  return os; }
-    std::ostream & light_blue_on_grey(std::ostream & os)           { set("lb", "e");  return os; }
-    std::ostream & light_blue_on_light_blue(std::ostream & os)     { set("lb", "lb"); return os; }
-    std::ostream & light_blue_on_light_green(std::ostream & os)    { set("lb", "lg"); return os; }
-    std::ostream & light_blue_on_light_aqua(std::ostream & os)     { set("lb", "la"); return os; }
-    std::ostream & light_blue_on_light_red(std::ostream & os)      { set("lb", "lr"); return os; }
-    std::ostream & light_blue_on_light_purple(std::ostream & os)   { set("lb", "lp"); return os; }
-    std::ostream & light_blue_on_light_yellow(std::ostream & os)   { set("lb", "ly"); return os; }
-    std::ostream & light_blue_on_bright_white(std::ostream & os)   { set("lb", "bw"); return os; }
-    std::ostream & light_green_on_black(std::ostream & os)         { set("lg", "k");  return os; }
-    std::ostream & light_green_on_blue(std::ostream & os)          { set("lg", "b");  return os; }
-    std::ostream & light_green_on_green(std::ostream & os)         { set("lg", "g");  return os; }
-    std::ostream & light_green_on_aqua(std::ostream & os)          { set("lg", "a");  return os; }
-    std::ostream & light_green_on_red(std::ostream & os)           { set("lg", "r");  return os; }
-    std::ostream & light_green_on_purple(std::ostream & os)        { set("lg", "p");  return os; }
-    std::ostream & light_green_on_yellow(std::ostream & os)        { set("lg", "y");  return os; }
-    std::ostream & light_green_on_white(std::ostream & os)         { set("lg", "w");  return os; }
-    std::ostream & light_green_on_grey(std::ostream & os)          { set("lg", "e");  return os; }
-    std::ostream & light_green_on_light_blue(std::ostream & os)    { set("lg", "lb"); return os; }
-    std::ostream & light_green_on_light_green(std::ostream & os)   { set("lg", "lg"); return os; }
-    std::ostream & light_green_on_light_aqua(std::ostream & os)    { set("lg", "la"); return os; }
-    std::ostream & light_green_on_light_red(std::ostream & os)     { set("lg", "lr"); return os; }
-    std::ostream & light_green_on_light_purple(std::ostream & os)  { set("lg", "lp"); return os; }
-    std::ostream & light_green_on_light_yellow(std::ostream & os)  { set("lg", "ly"); return os; }
-    std::ostream & light_green_on_bright_white(std::ostream & os)  { set("lg", "bw"); return os; }
-    std::ostream & light_aqua_on_black(std::ostream & os)          { set("la", "k");  return os; }
-    std::ostream & light_aqua_on_blue(std::ostream & os)           { set("la", "b");  return os; }
-    std::ostream & light_aqua_on_green(std::ostream & os)          { set("la", "g");  return os; }
-    std::ostream & light_aqua_on_aqua(std::ostream & os)           { set("la", "a");  return os; }
-    std::ostream & light_aqua_on_red(std::ostream & os)            { set("la", "r");  return os; }
-    std::ostream & light_aqua_on_purple(std::ostream & os)         { set("la", "p");  return os; }
-    std::ostream & light_aqua_on_yellow(std::ostream & os)         { set("la", "y");  return os; }
-    std::ostream & light_aqua_on_white(std::ostream & os)          { set("la", "w");  return os; }
-    std::ostream & light_aqua_on_grey(std::ostream & os)           { set("la", "e");  return os; }
-    std::ostream & light_aqua_on_light_blue(std::ostream & os)     { set("la", "lb"); return os; }
-    std::ostream & light_aqua_on_light_green(std::ostream & os)    { set("la", "lg"); return os; }
-    std::ostream & light_aqua_on_light_aqua(std::ostream & os)     { set("la", "la"); return os; }
-    std::ostream & light_aqua_on_light_red(std::ostream & os)      { set("la", "lr"); return os; }
-    std::ostream & light_aqua_on_light_purple(std::ostream & os)   { set("la", "lp"); return os; }
-    std::ostream & light_aqua_on_light_yellow(std::ostream & os)   { set("la", "ly"); return os; }
-    std::ostream & light_aqua_on_bright_white(std::ostream & os)   { set("la", "bw"); return os; }
-    std::ostream & light_red_on_black(std::ostream & os)           { set("lr", "k");  return os; }
-    std::ostream & light_red_on_blue(std::ostream & os)            { set("lr", "b");  return os; }
-    std::ostream & light_red_on_green(std::ostream & os)           { set("lr", "g");  return os; }
-    std::ostream & light_red_on_aqua(std::ostream & os)            { set("lr", "a");  return os; }
-    std::ostream & light_red_on_red(std::ostream & os)             { set("lr", "r");  return os; }
-    std::ostream & light_red_on_purple(std::ostream & os)          { set("lr", "p");  return os; }
-    std::ostream & light_red_on_yellow(std::ostream & os)          { set("lr", "y");  return os; }
-    std::ostream & light_red_on_white(std::ostream & os)           { set("lr", "w");  return os; }
-    std::ostream & light_red_on_grey(std::ostream & os)            { set("lr", "e");  return os; }
-    std::ostream & light_red_on_light_blue(std::ostream & os)      { set("lr", "lb"); return os; }
-    std::ostream & light_red_on_light_green(std::ostream & os)     { set("lr", "lg"); return os; }
-    std::ostream & light_red_on_light_aqua(std::ostream & os)      { set("lr", "la"); return os; }
-    std::ostream & light_red_on_light_red(std::ostream & os)       { set("lr", "lr"); return os; }
-    std::ostream & light_red_on_light_purple(std::ostream & os)    { set("lr", "lp"); return os; }
-    std::ostream & light_red_on_light_yellow(std::ostream & os)    { set("lr", "ly"); return os; }
-    std::ostream & light_red_on_bright_white(std::ostream & os)    { set("lr", "bw"); return os; }
-    std::ostream & light_purple_on_black(std::ostream & os)        { set("lp", "k");  return os; }
-    std::ostream & light_purple_on_blue(std::ostream & os)         { set("lp", "b");  return os; }
-    std::ostream & light_purple_on_green(std::ostream & os)        { set("lp", "g");  return os; }
-    std::ostream & light_purple_on_aqua(std::ostream & os)         { set("lp", "a");  return os; }
-    std::ostream & light_purple_on_red(std::ostream & os)          { set("lp", "r");  return os; }
-    std::ostream & light_purple_on_purple(std::ostream & os)       { set("lp", "p");  return os; }
-    std::ostream & light_purple_on_yellow(std::ostream & os)       { set("lp", "y");  return os; }
-    std::ostream & light_purple_on_white(std::ostream & os)        { set("lp", "w");  return os; }
-    std::ostream & light_purple_on_grey(std::ostream & os)         { set("lp", "e");  return os; }
-    std::ostream & light_purple_on_light_blue(std::ostream & os)   { set("lp", "lb"); return os; }
-    std::ostream & light_purple_on_light_green(std::ostream & os)  { set("lp", "lg"); return os; }
-    std::ostream & light_purple_on_light_aqua(std::ostream & os)   { set("lp", "la"); return os; }
-    std::ostream & light_purple_on_light_red(std::ostream & os)    { set("lp", "lr"); return os; }
-    std::ostream & light_purple_on_light_purple(std::ostream & os) { set("lp", "lp"); return os; }
-    std::ostream & light_purple_on_light_yellow(std::ostream & os) { set("lp", "ly"); return os; }
-    std::ostream & light_purple_on_bright_white(std::ostream & os) { set("lp", "bw"); return os; }
-    std::ostream & light_yellow_on_black(std::ostream & os)        { set("ly", "k");  return os; }
-    std::ostream & light_yellow_on_blue(std::ostream & os)         { set("ly", "b");  return os; }
-    std::ostream & light_yellow_on_green(std::ostream & os)        { set("ly", "g");  return os; }
-    std::ostream & light_yellow_on_aqua(std::ostream & os)         { set("ly", "a");  return os; }
-    std::ostream & light_yellow_on_red(std::ostream & os)          { set("ly", "r");  return os; }
-    std::ostream & light_yellow_on_purple(std::ostream & os)       { set("ly", "p");  return os; }
-    std::ostream & light_yellow_on_yellow(std::ostream & os)       { set("ly", "y");  return os; }
-    std::ostream & light_yellow_on_white(std::ostream & os)        { set("ly", "w");  return os; }
-    std::ostream & light_yellow_on_grey(std::ostream & os)         { set("ly", "e");  return os; }
-    std::ostream & light_yellow_on_light_blue(std::ostream & os)   { set("ly", "lb"); return os; }
-    std::ostream & light_yellow_on_light_green(std::ostream & os)  { set("ly", "lg"); return os; }
-    std::ostream & light_yellow_on_light_aqua(std::ostream & os)   { set("ly", "la"); return os; }
-    std::ostream & light_yellow_on_light_red(std::ostream & os)    { set("ly", "lr"); return os; }
-    std::ostream & light_yellow_on_light_purple(std::ostream & os) { set("ly", "lp"); return os; }
-    std::ostream & light_yellow_on_light_yellow(std::ostream & os) { set("ly", "ly"); return os; }
-    std::ostream & light_yellow_on_bright_white(std::ostream & os) { set("ly", "bw"); return os; }
-    std::ostream & bright_white_on_black(std::ostream & os)        { set("bw", "k");  return os; }
-    std::ostream & bright_white_on_blue(std::ostream & os)         { set("bw", "b");  return os; }
-    std::ostream & bright_white_on_green(std::ostream & os)        { set("bw", "g");  return os; }
-    std::ostream & bright_white_on_aqua(std::ostream & os)         { set("bw", "a");  return os; }
-    std::ostream & bright_white_on_red(std::ostream & os)          { set("bw", "r");  return os; }
-    std::ostream & bright_white_on_purple(std::ostream & os)       { set("bw", "p");  return os; }
-    std::ostream & bright_white_on_yellow(std::ostream & os)       { set("bw", "y");  return os; }
-    std::ostream & bright_white_on_white(std::ostream & os)        { set("bw", "w");  return os; }
-    std::ostream & bright_white_on_grey(std::ostream & os)         { set("bw", "e");  return os; }
-    std::ostream & bright_white_on_light_blue(std::ostream & os)   { set("bw", "lb"); return os; }
-    std::ostream & bright_white_on_light_green(std::ostream & os)  { set("bw", "lg"); return os; }
-    std::ostream & bright_white_on_light_aqua(std::ostream & os)   { set("bw", "la"); return os; }
-    std::ostream & bright_white_on_light_red(std::ostream & os)    { set("bw", "lr"); return os; }
-    std::ostream & bright_white_on_light_purple(std::ostream & os) { set("bw", "lp"); return os; }
-    std::ostream & bright_white_on_light_yellow(std::ostream & os) { set("bw", "ly"); return os; }
-    std::ostream & bright_white_on_bright_white(std::ostream & os) { set("bw", "bw"); return os; }
-}
+    namespace ansi
+    {
+        // console attributes are BGR-ordered, SGR colors are RGB-ordered
+        constexpr int SGR[8] = {0, 4, 2, 6, 1, 5, 3, 7};
 
+        // write c as one SGR sequence; DEFAULT_COLOR means the terminal's own
+        // colors, and a black background, the console's own, the terminal's
+        // background (49), so that light themes get no black boxes
+        inline void write(std::ostream & os, int c)
+        {
+            if (c == DEFAULT_COLOR) {
+                os.write("\x1b[0m", 4);
+                COLOR_CONSOLE_COUNT(escape_bytes, 4);
+            }
+            else {
+                int a = c % 16;
+                int b = c / 16;
+                char buf[] = {'\x1b', '[', '3', '0', ';', '4', '0', 'm', '\0', '\0'};
+                int n = 0;
+                if (a & 8) {
+                    buf[2] = '9';
+                }
+                buf[3] = static_cast<char>('0' + SGR[a & 7]);
+                if (b & 8) {
+                    // bright background is 10x, one digit longer
+                    buf[5] = '1';
+                    buf[6] = '0';
+                    buf[7] = static_cast<char>('0' + SGR[b & 7]);
+                    buf[8] = 'm';
+                    n = 9;
+                }
+                else {
+                    buf[6] = b ? static_cast<char>('0' + SGR[b & 7]) : '9';
+                    n = 8;
+                }
+                os.write(buf, n);
+                COLOR_CONSOLE_COUNT(escape_bytes, n);
+            }
+        }
+    }
 
-namespace dye
-{
-    template<typename T>
-    using bar = typename std::conditional<std::is_same<T, const char *>::value, std::string, T>::type;
+    namespace palette
+    {
+        // the console colors as RGB, in console order, as VGA showed them
+        constexpr std::uint32_t CONSOLE[16] = {
+            0x000000, 0x000080, 0x008000, 0x008080, 0x800000, 0x800080, 0x808000, 0xc0c0c0,
+            0x808080, 0x0000ff, 0x00ff00, 0x00ffff, 0xff0000, 0xff00ff, 0xffff00, 0xffffff
+        };
 
-    template<typename T> class colorful;
-    template<typename T> class item;
+        constexpr int LEVELS[6] = {0, 95, 135, 175, 215, 255};
 
-    template<typename T>
-    class colorful : private std::list<item<T>>
+        // entry n of the xterm palette as RGB; the first 16 are the console's
+        // in ANSI order
+        constexpr std::uint32_t xterm(int n)
+        {
+            return n < 16 ? CONSOLE[ansi::SGR[n & 7] | (n & 8)] :
+                   n < 232 ? static_cast<std::uint32_t>(LEVELS[(n - 16) / 36] << 16 |
+                                                        LEVELS[(n - 16) / 6 % 6] << 8 | LEVELS[(n - 16) % 6]) :
+                   static_cast<std::uint32_t>((8 + 10 * (n - 232)) * 0x010101);
+        }
+
+        // squared distance, weighted for the eye's sensitivity to green
+        inline int distance(std::uint32_t a, std::uint32_t b)
+        {
+            int r = static_cast<int>(a >> 16 & 0xff) - static_cast<int>(b >> 16 & 0xff);
+            int g = static_cast<int>(a >> 8 & 0xff) - static_cast<int>(b >> 8 & 0xff);
+            int l = static_cast<int>(a & 0xff) - static_cast<int>(b & 0xff);
+            return 2 * r * r + 4 * g * g + 3 * l * l;
+        }
+
+        // the tables below have one entry per cell of 32 x 32 x 32, the top
+        // five bits of each channel
+        constexpr int cell(std::uint32_t rgb)
+        {
+            return static_cast<int>((rgb >> 9 & 0x7c00) | (rgb >> 6 & 0x3e0) | (rgb >> 3 & 0x1f));
+        }
+
+        inline std::uint32_t center(int cell)
+        {
+            return static_cast<std::uint32_t>(((cell >> 10) << 3 | 4) << 16 |
+                                              ((cell >> 5 & 31) << 3 | 4) << 8 | ((cell & 31) << 3 | 4));
+        }
+
+        // the nearest console color to each cell, built on first use; padded
+        // so that it can be read four bytes at a time
+        inline const unsigned char * console_table()
+        {
+            static const std::vector<unsigned char> table = []
+            {
+                std::vector<unsigned char> t(32 * 32 * 32 + 3);
+                for (int k = 0; k != 32 * 32 * 32; ++k) {
+                    int best = 0;
+                    for (int c = 1; c != 16; ++c)
+                        if (distance(center(k), CONSOLE[c]) < distance(center(k), CONSOLE[best]))
+                            best = c;
+                    t[static_cast<std::size_t>(k)] = static_cast<unsigned char>(best);
+                }
+                return t;
+            }();
+            return table.data();
+        }
+
+        // the nearest xterm entry to each cell, leaving out the first 16,
+        // which terminals are free to redefine
+        inline const unsigned char * xterm_table()
+        {
+            static const std::vector<unsigned char> table = []
+            {
+                std::vector<unsigned char> t(32 * 32 * 32 + 3);
+                for (int k = 0; k != 32 * 32 * 32; ++k) {
+                    std::uint32_t c = center(k);
+                    // the nearest cube entry is the nearest level per
+                    // channel; the nearest grey is near the mean
+                    int cube = 16;
+                    for (int shift = 16, weight = 36; shift >= 0; shift -= 8, weight /= 6) {
+                        int v = static_cast<int>(c >> shift & 0xff);
+                        int level = 0;
+                        for (int l = 1; l != 6; ++l)
+                            if (std::abs(LEVELS[l] - v) < std::abs(LEVELS[level] - v))
+                                level = l;
+                        cube += level * weight;
+                    }
+                    int mean = static_cast<int>((c >> 16 & 0xff) + (c >> 8 & 0xff) + (c & 0xff)) / 3;
+                    int grey = mean < 8 ? 232 : mean > 238 ? 255 : 232 + (mean - 3) / 10;
+                    int best = cube;
+                    for (int g = grey > 232 ? grey - 1 : grey; g <= grey + 1 && g < 256; ++g)
+                        if (distance(c, xterm(g)) < distance(c, xterm(best)))
+                            best = g;
+                    t[static_cast<std::size_t>(k)] = static_cast<unsigned char>(best);
+                }
+                return t;
+            }();
+            return table.data();
+        }
+    }
+
+    // the console color nearest to an RGB value, 0xrrggbb: one table read
+    inline int nearest(std::uint32_t rgb)
     {
-    public:
-        using std::list<item<T>>::list;
+        return palette::console_table()[palette::cell(rgb)];
+    }
 
-        colorful<T> & operator+=(const colorful<T> & rhs)
+    // a color as a console code: extended colors go to the nearest of the
+    // 16, the other half of the code taken from DEFAULT_COLOR
+    inline int console(int c)
+    {
+        if (!is_extended(c))
+            return is_good(c) ? c : BAD_COLOR;
+        int n = c & 0xff;
+        int k = !(c & INDEXED) ? nearest(static_cast<std::uint32_t>(c & 0xffffff)) :
+                n < 16 ? ansi::SGR[n & 7] | (n & 8) : nearest(palette::xterm(n));
+        return (c & BACKGROUND) ? DEFAULT_COLOR % 16 + k * 16 : k + DEFAULT_COLOR / 16 * 16;
+    }
+
+    namespace ansi
+    {
+        inline char * decimal(char * p, int v)
         {
-            this->insert(this->end(), rhs.begin(), rhs.end());
-            return *this;
+            if (v >= 100)
+                *p++ = static_cast<char>('0' + v / 100);
+            if (v >= 10)
+                *p++ = static_cast<char>('0' + v / 10 % 10);
+            *p++ = static_cast<char>('0' + v % 10);
+            return p;
         }
 
-        colorful<T> & operator+=(colorful<T> && rhs)
+        // write an extended color as well as a terminal showing colors
+        // colors can: as is, as the nearest of the xterm palette, or as the
+        // nearest console color
+        inline void write(std::ostream & os, int c, long colors)
         {
-            this->splice(this->end(), std::move(rhs));
-            return *this;
+            if (!is_extended(c) || colors == 16) {
+                write(os, console(c));
+                return;
+            }
+            char buf[24] = {'\x1b', '[', '0', ';', (c & BACKGROUND) ? '4' : '3', '8', ';'};
+            char * p = buf + 7;
+            if ((c & INDEXED) || colors == 256) {
+                int n = (c & INDEXED) ? c & 0xff : palette::xterm_table()[palette::cell(static_cast<std::uint32_t>(c))];
+                *p++ = '5';
+                *p++ = ';';
+                p = decimal(p, n);
+            }
+            else {
+                *p++ = '2';
+                for (int shift = 16; shift >= 0; shift -= 8) {
+                    *p++ = ';';
+                    p = decimal(p, c >> shift & 0xff);
+                }
+            }
+            *p++ = 'm';
+            os.write(buf, p - buf);
+            COLOR_CONSOLE_COUNT(escape_bytes, static_cast<unsigned long long>(p - buf));
         }
 
-        colorful<T> & operator+=(T t)
+        // what a terminal shows after a color is written: an SGR key for the
+        // text and one for the background.  A key is the SGR number itself
+        // (39 and 49 for the terminal's own colors), 1000 plus an xterm
+        // index, or 1 << 24 plus an RGB value.
+        struct state
         {
-            this->push_back(std::move(t));
-            return *this;
+            int text;
+            int background;
+        };
+
+        inline bool operator==(state a, state b)
+        {
+            return a.text == b.text && a.background == b.background;
         }
 
-        void push_front(T t)
+        inline bool operator!=(state a, state b)
         {
-            this->std::list<item<T>>::push_front(item<T>(std::move(t)));
+            return !(a == b);
         }
 
-        void push_back(T t)
+        // what a terminal we have not written to may be showing
+        constexpr state UNKNOWN = {-1, -1};
+
+        inline state shows(int c, long colors);
+
+        inline state shows_extended(int c, long colors)
         {
-            this->std::list<item<T>>::push_back(item<T>(std::move(t)));
+            if (colors == 16)
+                c = console(c);
+            else {
+                int key = (c & INDEXED) ? 1000 + (c & 0xff) :
+                          colors == 256 ? 1000 + palette::xterm_table()[palette::cell(static_cast<std::uint32_t>(c))] :
+                          1 << 24 | (c & 0xffffff);
+                return (c & BACKGROUND) ? state{39, key} : state{key, 49};
+            }
+            return shows(c, 16);
         }
 
-        colorful<T> & invert()
+        // black, the console's default background, shows as the terminal's
+        inline state shows(int c, long colors)
         {
-            for (auto & elem : *this)
-                elem.invert();
-            return *this;
+            // the keys of the console colors, by attribute
+            static constexpr int TEXT[16] = {30, 34, 32, 36, 31, 35, 33, 37, 90, 94, 92, 96, 91, 95, 93, 97};
+            static constexpr int BACK[16] = {49, 44, 42, 46, 41, 45, 43, 47, 100, 104, 102, 106, 101, 105, 103, 107};
+            if (is_extended(c))
+                return shows_extended(c, colors);
+            if (c == DEFAULT_COLOR)
+                return state{39, 49};
+            return state{TEXT[c & 15], BACK[c >> 4 & 15]};
         }
 
-        template<typename U>
-        friend std::ostream & operator<<(std::ostream &, const colorful<U> &);
+        inline char * parameter(char * p, int key, bool background)
+        {
+            // SGR numbers are all of 30 to 107
+            if (key < 100) {
+                p[0] = static_cast<char>('0' + key / 10);
+                p[1] = static_cast<char>('0' + key % 10);
+                return p + 2;
+            }
+            if (key < 1000)
+                return decimal(p, key);
+            *p++ = background ? '4' : '3';
+            *p++ = '8';
+            *p++ = ';';
+            if (key < 1 << 24) {
+                *p++ = '5';
+                *p++ = ';';
+                return decimal(p, key - 1000);
+            }
+            *p++ = '2';
+            for (int shift = 16; shift >= 0; shift -= 8) {
+                *p++ = ';';
+                p = decimal(p, key >> shift & 0xff);
+            }
+            return p;
+        }
 
-        template<typename U>
-        friend colorful<U> invert(colorful<U> col);
-    };
+        // the length of a key written as SGR parameters
+        inline std::size_t width(int key)
+        {
+            auto digits = [](int v) -> std::size_t { return v < 10 ? 1 : v < 100 ? 2 : 3; };
+            if (key < 1000)
+                return key < 100 ? 2 : 3;
+            if (key < 1 << 24)
+                return 5 + digits(key - 1000);
+            return 10 + digits(key >> 16 & 0xff) + digits(key >> 8 & 0xff) + digits(key & 0xff);
+        }
 
-    template<typename T>
-    colorful<T> operator+(colorful<T> lhs, colorful<T> rhs)
+        // the shortest sequence taking a terminal from showing one state to
+        // showing another, into buf (48 bytes will do), and its length:
+        // nothing when they are the same, else either the keys that change
+        // or a reset followed by the keys that are not the default, which
+        // ever is shorter; a reset also clears attributes others have set,
+        // so it is taken only when strictly shorter
+        inline std::size_t delta(char * buf, state from, state to)
+        {
+            if (from == to)
+                return 0;
+            bool text = from.text != to.text;
+            bool background = from.background != to.background;
+            std::size_t keys = (text ? width(to.text) : 0) + (background ? width(to.background) : 0) + (text && background);
+            std::size_t reset = 1 + (to.text != 39 ? 1 + width(to.text) : 0) + (to.background != 49 ? 1 + width(to.background) : 0);
+            char * p = buf;
+            *p++ = '\x1b';
+            *p++ = '[';
+            if (reset < keys) {
+                *p++ = '0';
+                text = to.text != 39;
+                background = to.background != 49;
+                if (text || background)
+                    *p++ = ';';
+            }
+            if (text)
+                p = parameter(p, to.text, false);
+            if (background) {
+                if (text)
+                    *p++ = ';';
+                p = parameter(p, to.background, true);
+            }
+            *p++ = 'm';
+            return static_cast<std::size_t>(p - buf);
+        }
+
+        // whether a stream takes every color in full, as when it shares its
+        // terminal with other writers, rather than what changes
+        inline long & full(std::ostream & os)
+        {
+            static const int index = std::ios_base::xalloc();
+            return os.iword(index);
+        }
+    }
+
+    // whether a stream takes escape sequences even under the Win32 backend,
+    // like the buffers that dye::line renders records into
+    inline long & escaped(std::ostream & os)
     {
-        colorful<T> res(std::move(lhs));
-        return res += rhs;
+        static const int index = std::ios_base::xalloc();
+        return os.iword(index);
     }
 
-    template<typename T>
-    colorful<T> operator+(colorful<T> lhs, std::string rhs)
+    // ask the console itself for its color; a terminal cannot be asked, so
+    // the ANSI backend takes it to start out in its default colors
+    inline int query(std::ostream & os)
     {
-        colorful<T> res(std::move(lhs));
-        res.push_back(std::move(rhs));
-        return res;
+        COLOR_CONSOLE_COUNT(queries, 1);
+#if defined(COLOR_CONSOLE_WIN32)
+        CONSOLE_SCREEN_BUFFER_INFO i;
+        if (escaped(os))
+            return DEFAULT_COLOR;
+        COLOR_CONSOLE_COUNT(console_calls, 1);
+        return GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &i) ?
+               i.wAttributes : BAD_COLOR;
+#else
+        (void)os;
+        return DEFAULT_COLOR;
+#endif
     }
 
-    template<typename T>
-    colorful<T> operator+(const std::string & lhs, colorful<T> rhs)
+    // how many colors the terminal behind a stream can show: 16, 256, or
+    // 1 << 24 for any RGB color.  0, the default, means all of them under
+    // the ANSI backend and on escaped streams, and 16 on a Win32 console.
+    inline long & depth(std::ostream & os)
     {
-        colorful<T> res(std::move(rhs));
-        res.push_front(std::move(lhs));
-        return res;
+        static const int index = std::ios_base::xalloc();
+        return os.iword(index);
     }
 
-    template<typename T>
-    std::ostream & operator<<(std::ostream & os, const colorful<T> & colorful)
+    // the color a stream last left its console in, kept in the stream itself
+    // (0 until first synced, the color plus one after that)
+    inline long & shadow(std::ostream & os)
     {
-         for (const auto & elem : colorful)
-             os << elem;
-         return os;
+        static const int index = std::ios_base::xalloc();
+        return os.iword(index);
     }
 
-    template<typename T>
-    colorful<T> invert(colorful<T> col)
+    // whether a stream gets its text alone: dye then writes each thing as
+    // plain os << thing would, and hue sets no color and keeps no state
+    inline long & muted(std::ostream & os)
     {
-        colorful<T> res(std::move(col));
-        for (auto & elem : res)
-            elem.invert();
-        return res;
+        static const int index = std::ios_base::xalloc();
+        return os.iword(index);
     }
 
-    template<typename T>
-    class item
+    // when cout, cerr and clog get colors, as in ls --color=WHEN
+    enum class policy
     {
-        T thing;
-        int color;
+        automatic,
+        always,
+        never
+    };
 
-    public:
-        item(T t)                               :  thing(std::move(t)), color(hue::get())       {}
-        item(T t, int a)                        :  thing(std::move(t)), color(hue::itoc(a))     {}
-        item(T t, int a, int b)                 :  thing(std::move(t)), color(hue::itoc(a, b))  {}
-        item(T t, std::string a)                :  thing(std::move(t)), color(hue::stoc(a))     {}
-        item(T t, std::string a, std::string b) :  thing(std::move(t)), color(hue::stoc(a, b))  {}
+    namespace terminal
+    {
+        inline bool set_in(const char * name)
+        {
+            const char * v = std::getenv(name);
+            return v && *v && std::string(v) != "0";
+        }
 
-        item<T> & invert()
+        // how many colors the terminal behind a file descriptor, 1 or 2, can
+        // show: 0 when it is not a terminal, or NO_COLOR or TERM=dumb says
+        // not to color it, unless forced by CLICOLOR_FORCE or FORCE_COLOR
+        inline long detect(int fd, bool force = false)
         {
-            color = hue::invert(color);
-            return *this;
+            force = force || set_in("CLICOLOR_FORCE") || set_in("FORCE_COLOR");
+            const char * term = std::getenv("TERM");
+            const char * colorterm = std::getenv("COLORTERM");
+            if (!force) {
+                const char * no = std::getenv("NO_COLOR");
+                if ((no && *no) || (term && std::string(term) == "dumb"))
+                    return 0;
+#if defined(COLOR_CONSOLE_WIN32)
+                DWORD mode;
+                if (!GetConsoleMode(GetStdHandle(fd == 2 ? STD_ERROR_HANDLE : STD_OUTPUT_HANDLE), &mode))
+                    return 0;
+#elif defined(_WIN32)
+                if (!_isatty(fd))
+                    return 0;
+#else
+                if (!isatty(fd))
+                    return 0;
+#endif
+            }
+#if defined(COLOR_CONSOLE_WIN32)
+            (void)term;
+            (void)colorterm;
+            return 16;
+#else
+            std::string t = term ? term : "", ct = colorterm ? colorterm : "";
+            if (ct == "truecolor" || ct == "24bit" || t.find("direct") != std::string::npos)
+                return 1L << 24;
+            return t.find("256color") != std::string::npos ? 256 : 16;
+#endif
         }
 
-        template<typename U>
-        friend class colorful;
+        inline bool & decided()
+        {
+            static bool d = false;
+            return d;
+        }
+    }
 
-        template<typename U>
-        friend std::ostream & operator<<(std::ostream &, const item<U> &);
-    };
+    // decide for cout, cerr and clog whether they get colors, and how many;
+    // done once before main() with policy::automatic, and again whenever
+    // called
+    inline void apply(policy p)
+    {
+        terminal::decided() = true;
+        std::ostream * streams[] = {&std::cout, &std::cerr, &std::clog};
+        for (std::ostream * os : streams) {
+            int fd = os == &std::cout ? 1 : 2;
+            long colors = p == policy::never ? 0 : terminal::detect(fd, p == policy::always);
+            muted(*os) = colors == 0;
+            depth(*os) = colors == 1L << 24 ? 0 : colors;
+        }
+    }
 
-    template<typename T>
-    std::ostream & operator<<(std::ostream & os, const item<T> & it)
+    namespace terminal
     {
-        hue::set(it.color);
-        os << it.thing;
-        hue::reset();
-        return os;
+        inline bool startup()
+        {
+            if (!decided())
+                apply(policy::automatic);
+            return true;
+        }
+
+        // every file including this header asks, before main(); only the
+        // first does any work, and none does once apply() has been called
+        static const bool started = startup();
     }
 
-    template<typename T> using R = colorful<bar<T>>;
-    template<typename T> using S = item<bar<T>>;
+    // re-read the console, e.g. after another process has changed its color
+    inline int resync(std::ostream & os)
+    {
+        int c = query(os);
+        shadow(os) = c + 1;
+        return c;
+    }
+
+    inline int resync()
+    {
+        return resync(std::cout);
+    }
+
+    // a muted stream keeps no state, and is never looked up
+    inline int get(std::ostream & os)
+    {
+        if (muted(os))
+            return DEFAULT_COLOR;
+        long s = shadow(os);
+        return s ? static_cast<int>(s - 1) : resync(os);
+    }
+
+    inline int get_text(std::ostream & os)
+    {
+        int c = console(get(os));
+        return (c != BAD_COLOR) ? c % 16 : BAD_COLOR;
+    }
+
+    inline int get_background(std::ostream & os)
+    {
+        int c = console(get(os));
+        return (c != BAD_COLOR) ? c / 16 : BAD_COLOR;
+    }
+
+    inline int get()
+    {
+        return get(std::cout);
+    }
+
+    inline int get_text()
+    {
+        return get_text(std::cout);
+    }
+
+    inline int get_background()
+    {
+        return get_background(std::cout);
+    }
+
+#if defined(COLOR_CONSOLE_RECORD)
+    namespace record
+    {
+        struct change
+        {
+            const std::ostream * os;
+            int color;
+        };
+
+        // every color set on a stream by this thread, in order, until cleared
+        inline std::vector<change> & changes()
+        {
+            static thread_local std::vector<change> kept;
+            return kept;
+        }
+    }
+#endif
+
+    // the hue::deferred holding back the colors of a stream, if any
+    inline void *& deferring(std::ostream & os)
+    {
+        static const int index = std::ios_base::xalloc();
+        return os.pword(index);
+    }
+
+    // Holds back the colors set on a stream until text that shows them is
+    // written to it.  The reset ending one dyed item and the color starting
+    // the next then cost one short sequence, or none, and spaces and line
+    // breaks between items of one background cost none:
+    //
+    //     hue::deferred held(std::cout);
+    //     std::cout << dye::yellow("Google") << ", " << dye::yellow("Twitter");
+    //
+    // A flush writes out what is held, so a terminal never shows a color it
+    // should not while the program waits; so does the destructor, which
+    // gives the stream its own buffer back.
+    class deferred : public std::streambuf
+    {
+        std::ostream & os;
+        std::streambuf * inner;
+        ansi::state shown;      // what the terminal shows
+        ansi::state wanted;     // what the text written next is to show
+        bool held;              // the put area is kept empty while they differ
+        char buf[4096];
+
+    public:
+        explicit deferred(std::ostream & os)
+            : os(os), inner(os.rdbuf()), shown(ansi::UNKNOWN), wanted(ansi::UNKNOWN), held(false)
+        {
+            os.flush();
+            if (long s = shadow(os))
+                shown = wanted = ansi::shows(static_cast<int>(s - 1), depth(os));
+            setp(buf, buf + sizeof buf);
+            os.rdbuf(this);
+            deferring(os) = this;
+        }
+
+        deferred(const deferred &) = delete;
+        deferred & operator=(const deferred &) = delete;
+
+        ~deferred()
+        {
+            sync();
+            os.rdbuf(inner);
+            deferring(os) = nullptr;
+        }
+
+        void want(ansi::state to)
+        {
+            wanted = to;
+            held = wanted != shown;
+            open();
+        }
+
+    protected:
+        int_type overflow(int_type c) override
+        {
+            if (traits_type::eq_int_type(c, traits_type::eof()))
+                return traits_type::not_eof(c);
+            char ch = traits_type::to_char_type(c);
+            if (held && !(blank(ch) && wanted.background == shown.background))
+                show();
+            put(&ch, 1);
+            return c;
+        }
+
+        std::streamsize xsputn(const char * p, std::streamsize n) override
+        {
+            std::size_t k = 0, size = static_cast<std::size_t>(n);
+            if (held) {
+                if (wanted.background == shown.background)
+                    while (k != size && blank(p[k]))
+                        ++k;
+                put(p, k);
+                if (k != size)
+                    show();
+            }
+            put(p + k, size - k);
+            return n;
+        }
+
+        int sync() override
+        {
+            show();
+            drain();
+            return inner->pubsync();
+        }
+
+    private:
+        // text that shows the background alone
+        static bool blank(char c)
+        {
+            return c == ' ' || c == '\n';
+        }
+
+        // the put area ends where the text does while a change is held, so
+        // that the next text comes through overflow or xsputn
+        void open()
+        {
+            std::size_t used = static_cast<std::size_t>(pptr() - buf);
+            setp(buf, held ? buf + used : buf + sizeof buf);
+            pbump(static_cast<int>(used));
+        }
+
+        void drain()
+        {
+            inner->sputn(buf, pptr() - buf);
+            setp(buf, held ? buf : buf + sizeof buf);
+        }
+
+        void put(const char * p, std::size_t n)
+        {
+            while (n) {
+                if (pptr() == buf + sizeof buf)
+                    drain();
+                std::size_t used = static_cast<std::size_t>(pptr() - buf);
+                std::size_t k = std::min(n, sizeof buf - used);
+                std::memcpy(buf + used, p, k);
+                setp(buf, held ? buf + used + k : buf + sizeof buf);
+                pbump(static_cast<int>(used + k));
+                p += k;
+                n -= k;
+            }
+        }
+
+        void show()
+        {
+            if (!held)
+                return;
+            char seq[48];
+            std::size_t n = ansi::delta(seq, shown, wanted);
+            COLOR_CONSOLE_COUNT(escape_bytes, n);
+            shown = wanted;
+            held = false;
+            open();
+            put(seq, n);
+        }
+    };
+
+    // write the sequence for c to an escaped stream: in full if asked to,
+    // else what changes from the color the stream last took, or nothing
+    // yet if the stream is held back by hue::deferred
+    inline void emit(std::ostream & os, int c)
+    {
+        if (ansi::full(os)) {
+            if (is_extended(c))
+                ansi::write(os, c, depth(os));
+            else
+                ansi::write(os, c);
+            return;
+        }
+        ansi::state to = ansi::shows(c, is_extended(c) ? depth(os) : 16);
+        if (void * d = deferring(os)) {
+            static_cast<deferred *>(d)->want(to);
+            return;
+        }
+        long s = shadow(os);
+        char seq[48];
+        int from = static_cast<int>(s - 1);
+        std::size_t n = ansi::delta(seq, s ? ansi::shows(from, is_extended(from) ? depth(os) : 16) : ansi::UNKNOWN, to);
+        if (n) {
+            os.write(seq, static_cast<std::streamsize>(n));
+            COLOR_CONSOLE_COUNT(escape_bytes, n);
+        }
+    }
+
+    inline void set(std::ostream & os, int c)
+    {
+        COLOR_CONSOLE_COUNT(sets, 1);
+        if (muted(os))
+            return;
+#if defined(COLOR_CONSOLE_STATS)
+        if (shadow(os) == c + 1L)
+            COLOR_CONSOLE_COUNT(redundant, 1);
+#endif
+        if (is_good(c) || is_extended(c)) {
+#if defined(COLOR_CONSOLE_RECORD)
+            record::changes().push_back(record::change{&os, c});
+#elif defined(COLOR_CONSOLE_WIN32)
+            if (escaped(os))
+                emit(os, c);
+            else {
+                SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), static_cast<WORD>(console(c)));
+                COLOR_CONSOLE_COUNT(console_calls, 1);
+            }
+#else
+            emit(os, c);
+#endif
+            shadow(os) = c + 1;
+        }
+    }
+
+    inline void set(std::ostream & os, int a, int b)
+    {
+        set(os, a + b * 16);
+    }
+
+    inline void set(std::ostream & os, std::string a, std::string b)
+    {
+        set(os, stoc(a) + stoc(b) * 16);
+    }
+
+    inline void set_text(std::ostream & os, int a)
+    {
+        set(os, a, get_background(os));
+    }
+
+    inline void set_background(std::ostream & os, int b)
+    {
+        set(os, get_text(os), b);
+    }
+
+    inline void set_text(std::ostream & os, std::string a)
+    {
+        set_text(os, stoc(a));
+    }
+
+    inline void set_background(std::ostream & os, std::string b)
+    {
+        set_background(os, stoc(b));
+    }
+
+    inline void set(int c)
+    {
+        set(std::cout, c);
+    }
+
+    inline void set(int a, int b)
+    {
+        set(std::cout, a, b);
+    }
+
+    inline void set(std::string a, std::string b)
+    {
+        set(std::cout, a, b);
+    }
+
+    inline void set_text(std::string a)
+    {
+        set_text(std::cout, a);
+    }
+
+    inline void set_background(std::string b)
+    {
+        set_background(std::cout, b);
+    }
+
+    inline void reset()
+    {
+        COLOR_CONSOLE_COUNT(resets, 1);
+        set(DEFAULT_COLOR);
+    }
+
+    inline int invert(int c)
+    {
+        if (is_extended(c))
+            return c ^ BACKGROUND;
+        if (is_good(c)) {
+            int a = c % 16;
+            int b = c / 16;
+            return b + a * 16;
+        }
+        else
+            return BAD_COLOR;
+    }
+
+    inline std::ostream & reset(std::ostream & os)                 { COLOR_CONSOLE_COUNT(resets, 1); set(os, DEFAULT_COLOR); return os; }
+
+    inline std::ostream & black(std::ostream & os)                 { set_text(os, BLACK);                 return os; }
+    inline std::ostream & blue(std::ostream & os)                  { set_text(os, BLUE);                  return os; }
+    inline std::ostream & green(std::ostream & os)                 { set_text(os, GREEN);                 return os; }
+    inline std::ostream & aqua(std::ostream & os)                  { set_text(os, AQUA);                  return os; }
+    inline std::ostream & red(std::ostream & os)                   { set_text(os, RED);                   return os; }
+    inline std::ostream & purple(std::ostream & os)                { set_text(os, PURPLE);                return os; }
+    inline std::ostream & yellow(std::ostream & os)                { set_text(os, YELLOW);                return os; }
+    inline std::ostream & white(std::ostream & os)                 { set_text(os, WHITE);                 return os; }
+    inline std::ostream & grey(std::ostream & os)                  { set_text(os, GREY);                  return os; }
+    inline std::ostream & light_blue(std::ostream & os)            { set_text(os, LIGHT_BLUE);            return os; }
+    inline std::ostream & light_green(std::ostream & os)           { set_text(os, LIGHT_GREEN);           return os; }
+    inline std::ostream & light_aqua(std::ostream & os)            { set_text(os, LIGHT_AQUA);            return os; }
+    inline std::ostream & light_red(std::ostream & os)             { set_text(os, LIGHT_RED);             return os; }
+    inline std::ostream & light_purple(std::ostream & os)          { set_text(os, LIGHT_PURPLE);          return os; }
+    inline std::ostream & light_yellow(std::ostream & os)          { set_text(os, LIGHT_YELLOW);          return os; }
+    inline std::ostream & bright_white(std::ostream & os)          { set_text(os, BRIGHT_WHITE);          return os; }
+    inline std::ostream & on_black(std::ostream & os)              { set_background(os, BLACK);           return os; }
+    inline std::ostream & on_blue(std::ostream & os)               { set_background(os, BLUE);            return os; }
+    inline std::ostream & on_green(std::ostream & os)              { set_background(os, GREEN);           return os; }
+    inline std::ostream & on_aqua(std::ostream & os)               { set_background(os, AQUA);            return os; }
+    inline std::ostream & on_red(std::ostream & os)                { set_background(os, RED);             return os; }
+    inline std::ostream & on_purple(std::ostream & os)             { set_background(os, PURPLE);          return os; }
+    inline std::ostream & on_yellow(std::ostream & os)             { set_background(os, YELLOW);          return os; }
+    inline std::ostream & on_white(std::ostream & os)              { set_background(os, WHITE);           return os; }
+    inline std::ostream & on_grey(std::ostream & os)               { set_background(os, GREY);            return os; }
+    inline std::ostream & on_light_blue(std::ostream & os)         { set_background(os, LIGHT_BLUE);      return os; }
+    inline std::ostream & on_light_green(std::ostream & os)        { set_background(os, LIGHT_GREEN);     return os; }
+    inline std::ostream & on_light_aqua(std::ostream & os)         { set_background(os, LIGHT_AQUA);      return os; }
+    inline std::ostream & on_light_red(std::ostream & os)          { set_background(os, LIGHT_RED);       return os; }
+    inline std::ostream & on_light_purple(std::ostream & os)       { set_background(os, LIGHT_PURPLE);    return os; }
+    inline std::ostream & on_light_yellow(std::ostream & os)       { set_background(os, LIGHT_YELLOW);    return os; }
+    inline std::ostream & on_bright_white(std::ostream & os)       { set_background(os, BRIGHT_WHITE);    return os; }
+    inline std::ostream & black_on_black(std::ostream & os)               { set(os, BLACK, BLACK);               return os; }
+    inline std::ostream & black_on_blue(std::ostream & os)                { set(os, BLACK, BLUE);                return os; }
+    inline std::ostream & black_on_green(std::ostream & os)               { set(os, BLACK, GREEN);               return os; }
+    inline std::ostream & black_on_aqua(std::ostream & os)                { set(os, BLACK, AQUA);                return os; }
+    inline std::ostream & black_on_red(std::ostream & os)                 { set(os, BLACK, RED);                 return os; }
+    inline std::ostream & black_on_purple(std::ostream & os)              { set(os, BLACK, PURPLE);              return os; }
+    inline std::ostream & black_on_yellow(std::ostream & os)              { set(os, BLACK, YELLOW);              return os; }
+    inline std::ostream & black_on_white(std::ostream & os)               { set(os, BLACK, WHITE);               return os; }
+    inline std::ostream & black_on_grey(std::ostream & os)                { set(os, BLACK, GREY);                return os; }
+    inline std::ostream & black_on_light_blue(std::ostream & os)          { set(os, BLACK, LIGHT_BLUE);          return os; }
+    inline std::ostream & black_on_light_green(std::ostream & os)         { set(os, BLACK, LIGHT_GREEN);         return os; }
+    inline std::ostream & black_on_light_aqua(std::ostream & os)          { set(os, BLACK, LIGHT_AQUA);          return os; }
+    inline std::ostream & black_on_light_red(std::ostream & os)           { set(os, BLACK, LIGHT_RED);           return os; }
+    inline std::ostream & black_on_light_purple(std::ostream & os)        { set(os, BLACK, LIGHT_PURPLE);        return os; }
+    inline std::ostream & black_on_light_yellow(std::ostream & os)        { set(os, BLACK, LIGHT_YELLOW);        return os; }
+    inline std::ostream & black_on_bright_white(std::ostream & os)        { set(os, BLACK, BRIGHT_WHITE);        return os; }
+    inline std::ostream & blue_on_black(std::ostream & os)                { set(os, BLUE, BLACK);                return os; }
+    inline std::ostream & blue_on_blue(std::ostream & os)                 { set(os, BLUE, BLUE);                 return os; }
+    inline std::ostream & blue_on_green(std::ostream & os)                { set(os, BLUE, GREEN);                return os; }
+    inline std::ostream & blue_on_aqua(std::ostream & os)                 { set(os, BLUE, AQUA);                 return os; }
+    inline std::ostream & blue_on_red(std::ostream & os)                  { set(os, BLUE, RED);                  return os; }
+    inline std::ostream & blue_on_purple(std::ostream & os)               { set(os, BLUE, PURPLE);               return os; }
+    inline std::ostream & blue_on_yellow(std::ostream & os)               { set(os, BLUE, YELLOW);               return os; }
+    inline std::ostream & blue_on_white(std::ostream & os)                { set(os, BLUE, WHITE);                return os; }
+    inline std::ostream & blue_on_grey(std::ostream & os)                 { set(os, BLUE, GREY);                 return os; }
+    inline std::ostream & blue_on_light_blue(std::ostream & os)           { set(os, BLUE, LIGHT_BLUE);           return os; }
+    inline std::ostream & blue_on_light_green(std::ostream & os)          { set(os, BLUE, LIGHT_GREEN);          return os; }
+    inline std::ostream & blue_on_light_aqua(std::ostream & os)           { set(os, BLUE, LIGHT_AQUA);           return os; }
+    inline std::ostream & blue_on_light_red(std::ostream & os)            { set(os, BLUE, LIGHT_RED);            return os; }
+    inline std::ostream & blue_on_light_purple(std::ostream & os)         { set(os, BLUE, LIGHT_PURPLE);         return os; }
+    inline std::ostream & blue_on_light_yellow(std::ostream & os)         { set(os, BLUE, LIGHT_YELLOW);         return os; }
+    inline std::ostream & blue_on_bright_white(std::ostream & os)         { set(os, BLUE, BRIGHT_WHITE);         return os; }
+    inline std::ostream & green_on_black(std::ostream & os)               { set(os, GREEN, BLACK);               return os; }
+    inline std::ostream & green_on_blue(std::ostream & os)                { set(os, GREEN, BLUE);                return os; }
+    inline std::ostream & green_on_green(std::ostream & os)               { set(os, GREEN, GREEN);               return os; }
+    inline std::ostream & green_on_aqua(std::ostream & os)                { set(os, GREEN, AQUA);                return os; }
+    inline std::ostream & green_on_red(std::ostream & os)                 { set(os, GREEN, RED);                 return os; }
+    inline std::ostream & green_on_purple(std::ostream & os)              { set(os, GREEN, PURPLE);              return os; }
+    inline std::ostream & green_on_yellow(std::ostream & os)              { set(os, GREEN, YELLOW);              return os; }
+    inline std::ostream & green_on_white(std::ostream & os)               { set(os, GREEN, WHITE);               return os; }
+    inline std::ostream & green_on_grey(std::ostream & os)                { set(os, GREEN, GREY);                return os; }
+    inline std::ostream & green_on_light_blue(std::ostream & os)          { set(os, GREEN, LIGHT_BLUE);          return os; }
+    inline std::ostream & green_on_light_green(std::ostream & os)         { set(os, GREEN, LIGHT_GREEN);         return os; }
+    inline std::ostream & green_on_light_aqua(std::ostream & os)          { set(os, GREEN, LIGHT_AQUA);          return os; }
+    inline std::ostream & green_on_light_red(std::ostream & os)           { set(os, GREEN, LIGHT_RED);           return os; }
+    inline std::ostream & green_on_light_purple(std::ostream & os)        { set(os, GREEN, LIGHT_PURPLE);        return os; }
+    inline std::ostream & green_on_light_yellow(std::ostream & os)        { set(os, GREEN, LIGHT_YELLOW);        return os; }
+    inline std::ostream & green_on_bright_white(std::ostream & os)        { set(os, GREEN, BRIGHT_WHITE);        return os; }
+    inline std::ostream & aqua_on_black(std::ostream & os)                { set(os, AQUA, BLACK);                return os; }
+    inline std::ostream & aqua_on_blue(std::ostream & os)                 { set(os, AQUA, BLUE);                 return os; }
+    inline std::ostream & aqua_on_green(std::ostream & os)                { set(os, AQUA, GREEN);                return os; }
+    inline std::ostream & aqua_on_aqua(std::ostream & os)                 { set(os, AQUA, AQUA);                 return os; }
+    inline std::ostream & aqua_on_red(std::ostream & os)                  { set(os, AQUA, RED);                  return os; }
+    inline std::ostream & aqua_on_purple(std::ostream & os)               { set(os, AQUA, PURPLE);               return os; }
+    inline std::ostream & aqua_on_yellow(std::ostream & os)               { set(os, AQUA, YELLOW);               return os; }
+    inline std::ostream & aqua_on_white(std::ostream & os)                { set(os, AQUA, WHITE);                return os; }
+    inline std::ostream & aqua_on_grey(std::ostream & os)                 { set(os, AQUA, GREY);                 return os; }
+    inline std::ostream & aqua_on_light_blue(std::ostream & os)           { set(os, AQUA, LIGHT_BLUE);           return os; }
+    inline std::ostream & aqua_on_light_green(std::ostream & os)          { set(os, AQUA, LIGHT_GREEN);          return os; }
+    inline std::ostream & aqua_on_light_aqua(std::ostream & os)           { set(os, AQUA, LIGHT_AQUA);           return os; }
+    inline std::ostream & aqua_on_light_red(std::ostream & os)            { set(os, AQUA, LIGHT_RED);            return os; }
+    inline std::ostream & aqua_on_light_purple(std::ostream & os)         { set(os, AQUA, LIGHT_PURPLE);         return os; }
+    inline std::ostream & aqua_on_light_yellow(std::ostream & os)         { set(os, AQUA, LIGHT_YELLOW);         return os; }
+    inline std::ostream & aqua_on_bright_white(std::ostream & os)         { set(os, AQUA, BRIGHT_WHITE);         return os; }
+    inline std::ostream & red_on_black(std::ostream & os)                 { set(os, RED, BLACK);                 return os; }
+    inline std::ostream & red_on_blue(std::ostream & os)                  { set(os, RED, BLUE);                  return os; }
+    inline std::ostream & red_on_green(std::ostream & os)                 { set(os, RED, GREEN);                 return os; }
+    inline std::ostream & red_on_aqua(std::ostream & os)                  { set(os, RED, AQUA);                  return os; }
+    inline std::ostream & red_on_red(std::ostream & os)                   { set(os, RED, RED);                   return os; }
+    inline std::ostream & red_on_purple(std::ostream & os)                { set(os, RED, PURPLE);                return os; }
+    inline std::ostream & red_on_yellow(std::ostream & os)                { set(os, RED, YELLOW);                return os; }
+    inline std::ostream & red_on_white(std::ostream & os)                 { set(os, RED, WHITE);                 return os; }
+    inline std::ostream & red_on_grey(std::ostream & os)                  { set(os, RED, GREY);                  return os; }
+    inline std::ostream & red_on_light_blue(std::ostream & os)            { set(os, RED, LIGHT_BLUE);            return os; }
+    inline std::ostream & red_on_light_green(std::ostream & os)           { set(os, RED, LIGHT_GREEN);           return os; }
+    inline std::ostream & red_on_light_aqua(std::ostream & os)            { set(os, RED, LIGHT_AQUA);            return os; }
+    inline std::ostream & red_on_light_red(std::ostream & os)             { set(os, RED, LIGHT_RED);             return os; }
+    inline std::ostream & red_on_light_purple(std::ostream & os)          { set(os, RED, LIGHT_PURPLE);          return os; }
+    inline std::ostream & red_on_light_yellow(std::ostream & os)          { set(os, RED, LIGHT_YELLOW);          return os; }
+    inline std::ostream & red_on_bright_white(std::ostream & os)          { set(os, RED, BRIGHT_WHITE);          return os; }
+    inline std::ostream & purple_on_black(std::ostream & os)              { set(os, PURPLE, BLACK);              return os; }
+    inline std::ostream & purple_on_blue(std::ostream & os)               { set(os, PURPLE, BLUE);               return os; }
+    inline std::ostream & purple_on_green(std::ostream & os)              { set(os, PURPLE, GREEN);              return os; }
+    inline std::ostream & purple_on_aqua(std::ostream & os)               { set(os, PURPLE, AQUA);               return os; }
+    inline std::ostream & purple_on_red(std::ostream & os)                { set(os, PURPLE, RED);                return os; }
+    inline std::ostream & purple_on_purple(std::ostream & os)             { set(os, PURPLE, PURPLE);             return os; }
+    inline std::ostream & purple_on_yellow(std::ostream & os)             { set(os, PURPLE, YELLOW);             return os; }
+    inline std::ostream & purple_on_white(std::ostream & os)              { set(os, PURPLE, WHITE);              return os; }
+    inline std::ostream & purple_on_grey(std::ostream & os)               { set(os, PURPLE, GREY);               return os; }
+    inline std::ostream & purple_on_light_blue(std::ostream & os)         { set(os, PURPLE, LIGHT_BLUE);         return os; }
+    inline std::ostream & purple_on_light_green(std::ostream & os)        { set(os, PURPLE, LIGHT_GREEN);        return os; }
+    inline std::ostream & purple_on_light_aqua(std::ostream & os)         { set(os, PURPLE, LIGHT_AQUA);         return os; }
+    inline std::ostream & purple_on_light_red(std::ostream & os)          { set(os, PURPLE, LIGHT_RED);          return os; }
+    inline std::ostream & purple_on_light_purple(std::ostream & os)       { set(os, PURPLE, LIGHT_PURPLE);       return os; }
+    inline std::ostream & purple_on_light_yellow(std::ostream & os)       { set(os, PURPLE, LIGHT_YELLOW);       return os; }
+    inline std::ostream & purple_on_bright_white(std::ostream & os)       { set(os, PURPLE, BRIGHT_WHITE);       return os; }
+    inline std::ostream & yellow_on_black(std::ostream & os)              { set(os, YELLOW, BLACK);              return os; }
+    inline std::ostream & yellow_on_blue(std::ostream & os)               { set(os, YELLOW, BLUE);               return os; }
+    inline std::ostream & yellow_on_green(std::ostream & os)              { set(os, YELLOW, GREEN);              return os; }
+    inline std::ostream & yellow_on_aqua(std::ostream & os)               { set(os, YELLOW, AQUA);               return os; }
+    inline std::ostream & yellow_on_red(std::ostream & os)                { set(os, YELLOW, RED);                return os; }
+    inline std::ostream & yellow_on_purple(std::ostream & os)             { set(os, YELLOW, PURPLE);             return os; }
+    inline std::ostream & yellow_on_yellow(std::ostream & os)             { set(os, YELLOW, YELLOW);             return os; }
+    inline std::ostream & yellow_on_white(std::ostream & os)              { set(os, YELLOW, WHITE);              return os; }
+    inline std::ostream & yellow_on_grey(std::ostream & os)               { set(os, YELLOW, GREY);               return os; }
+    inline std::ostream & yellow_on_light_blue(std::ostream & os)         { set(os, YELLOW, LIGHT_BLUE);         return os; }
+    inline std::ostream & yellow_on_light_green(std::ostream & os)        { set(os, YELLOW, LIGHT_GREEN);        return os; }
+    inline std::ostream & yellow_on_light_aqua(std::ostream & os)         { set(os, YELLOW, LIGHT_AQUA);         return os; }
+    inline std::ostream & yellow_on_light_red(std::ostream & os)          { set(os, YELLOW, LIGHT_RED);          return os; }
+    inline std::ostream & yellow_on_light_purple(std::ostream & os)       { set(os, YELLOW, LIGHT_PURPLE);       return os; }
+    inline std::ostream & yellow_on_light_yellow(std::ostream & os)       { set(os, YELLOW, LIGHT_YELLOW);       return os; }
+    inline std::ostream & yellow_on_bright_white(std::ostream & os)       { set(os, YELLOW, BRIGHT_WHITE);       return os; }
+    inline std::ostream & white_on_black(std::ostream & os)               { set(os, WHITE, BLACK);               return os; }
+    inline std::ostream & white_on_blue(std::ostream & os)                { set(os, WHITE, BLUE);                return os; }
+    inline std::ostream & white_on_green(std::ostream & os)               { set(os, WHITE, GREEN);               return os; }
+    inline std::ostream & white_on_aqua(std::ostream & os)                { set(os, WHITE, AQUA);                return os; }
+    inline std::ostream & white_on_red(std::ostream & os)                 { set(os, WHITE, RED);                 return os; }
+    inline std::ostream & white_on_purple(std::ostream & os)              { set(os, WHITE, PURPLE);              return os; }
+    inline std::ostream & white_on_yellow(std::ostream & os)              { set(os, WHITE, YELLOW);              return os; }
+    inline std::ostream & white_on_white(std::ostream & os)               { set(os, WHITE, WHITE);               return os; }
+    inline std::ostream & white_on_grey(std::ostream & os)                { set(os, WHITE, GREY);                return os; }
+    inline std::ostream & white_on_light_blue(std::ostream & os)          { set(os, WHITE, LIGHT_BLUE);          return os; }
+    inline std::ostream & white_on_light_green(std::ostream & os)         { set(os, WHITE, LIGHT_GREEN);         return os; }
+    inline std::ostream & white_on_light_aqua(std::ostream & os)          { set(os, WHITE, LIGHT_AQUA);          return os; }
+    inline std::ostream & white_on_light_red(std::ostream & os)           { set(os, WHITE, LIGHT_RED);           return os; }
+    inline std::ostream & white_on_light_purple(std::ostream & os)        { set(os, WHITE, LIGHT_PURPLE);        return os; }
+    inline std::ostream & white_on_light_yellow(std::ostream & os)        { set(os, WHITE, LIGHT_YELLOW);        return os; }
+    inline std::ostream & white_on_bright_white(std::ostream & os)        { set(os, WHITE, BRIGHT_WHITE);        return os; }
+    inline std::ostream & grey_on_black(std::ostream & os)                { set(os, GREY, BLACK);                return os; }
+    inline std::ostream & grey_on_blue(std::ostream & os)                 { set(os, GREY, BLUE);                 return os; }
+    inline std::ostream & grey_on_green(std::ostream & os)                { set(os, GREY, GREEN);                return os; }
+    inline std::ostream & grey_on_aqua(std::ostream & os)                 { set(os, GREY, AQUA);                 return os; }
+    inline std::ostream & grey_on_red(std::ostream & os)                  { set(os, GREY, RED);                  return os; }
+    inline std::ostream & grey_on_purple(std::ostream & os)               { set(os, GREY, PURPLE);               return os; }
+    inline std::ostream & grey_on_yellow(std::ostream & os)               { set(os, GREY, YELLOW);               return os; }
+    inline std::ostream & grey_on_white(std::ostream & os)                { set(os, GREY, WHITE);                return os; }
+    inline std::ostream & grey_on_grey(std::ostream & os)                 { set(os, GREY, GREY);                 return os; }
+    inline std::ostream & grey_on_light_blue(std::ostream & os)           { set(os, GREY, LIGHT_BLUE);           return os; }
+    inline std::ostream & grey_on_light_green(std::ostream & os)          { set(os, GREY, LIGHT_GREEN);          return os; }
+    inline std::ostream & grey_on_light_aqua(std::ostream & os)           { set(os, GREY, LIGHT_AQUA);           return os; }
+    inline std::ostream & grey_on_light_red(std::ostream & os)            { set(os, GREY, LIGHT_RED);            return os; }
+    inline std::ostream & grey_on_light_purple(std::ostream & os)         { set(os, GREY, LIGHT_PURPLE);         return os; }
+    inline std::ostream & grey_on_light_yellow(std::ostream & os)         { set(os, GREY, LIGHT_YELLOW);         return os; }
+    inline std::ostream & grey_on_bright_white(std::ostream & os)         { set(os, GREY, BRIGHT_WHITE);         return os; }
+    inline std::ostream & light_blue_on_black(std::ostream & os)          { set(os, LIGHT_BLUE, BLACK);          return os; }
+    inline std::ostream & light_blue_on_blue(std::ostream & os)           { set(os, LIGHT_BLUE, BLUE);           return os; }
+    inline std::ostream & light_blue_on_green(std::ostream & os)          { set(os, LIGHT_BLUE, GREEN);          return os; }
+    inline std::ostream & light_blue_on_aqua(std::ostream & os)           { set(os, LIGHT_BLUE, AQUA);           return os; }
+    inline std::ostream & light_blue_on_red(std::ostream & os)            { set(os, LIGHT_BLUE, RED);            return os; }
+    inline std::ostream & light_blue_on_purple(std::ostream & os)         { set(os, LIGHT_BLUE, PURPLE);         return os; }
+    inline std::ostream & light_blue_on_yellow(std::ostream & os)         { set(os, LIGHT_BLUE, YELLOW);         return os; }
+    inline std::ostream & light_blue_on_white(std::ostream & os)          { set(os, LIGHT_BLUE, WHITE);          return os; }
+    inline std::ostream & light_blue_on_grey(std::ostream & os)           { set(os, LIGHT_BLUE, GREY);           return os; }
+    inline std::ostream & light_blue_on_light_blue(std::ostream & os)     { set(os, LIGHT_BLUE, LIGHT_BLUE);     return os; }
+    inline std::ostream & light_blue_on_light_green(std::ostream & os)    { set(os, LIGHT_BLUE, LIGHT_GREEN);    return os; }
+    inline std::ostream & light_blue_on_light_aqua(std::ostream & os)     { set(os, LIGHT_BLUE, LIGHT_AQUA);     return os; }
+    inline std::ostream & light_blue_on_light_red(std::ostream & os)      { set(os, LIGHT_BLUE, LIGHT_RED);      return os; }
+    inline std::ostream & light_blue_on_light_purple(std::ostream & os)   { set(os, LIGHT_BLUE, LIGHT_PURPLE);   return os; }
+    inline std::ostream & light_blue_on_light_yellow(std::ostream & os)   { set(os, LIGHT_BLUE, LIGHT_YELLOW);   return os; }
+    inline std::ostream & light_blue_on_bright_white(std::ostream & os)   { set(os, LIGHT_BLUE, BRIGHT_WHITE);   return os; }
+    inline std::ostream & light_green_on_black(std::ostream & os)         { set(os, LIGHT_GREEN, BLACK);         return os; }
+    inline std::ostream & light_green_on_blue(std::ostream & os)          { set(os, LIGHT_GREEN, BLUE);          return os; }
+    inline std::ostream & light_green_on_green(std::ostream & os)         { set(os, LIGHT_GREEN, GREEN);         return os; }
+    inline std::ostream & light_green_on_aqua(std::ostream & os)          { set(os, LIGHT_GREEN, AQUA);          return os; }
+    inline std::ostream & light_green_on_red(std::ostream & os)           { set(os, LIGHT_GREEN, RED);           return os; }
+    inline std::ostream & light_green_on_purple(std::ostream & os)        { set(os, LIGHT_GREEN, PURPLE);        return os; }
+    inline std::ostream & light_green_on_yellow(std::ostream & os)        { set(os, LIGHT_GREEN, YELLOW);        return os; }
+    inline std::ostream & light_green_on_white(std::ostream & os)         { set(os, LIGHT_GREEN, WHITE);         return os; }
+    inline std::ostream & light_green_on_grey(std::ostream & os)          { set(os, LIGHT_GREEN, GREY);          return os; }
+    inline std::ostream & light_green_on_light_blue(std::ostream & os)    { set(os, LIGHT_GREEN, LIGHT_BLUE);    return os; }
+    inline std::ostream & light_green_on_light_green(std::ostream & os)   { set(os, LIGHT_GREEN, LIGHT_GREEN);   return os; }
+    inline std::ostream & light_green_on_light_aqua(std::ostream & os)    { set(os, LIGHT_GREEN, LIGHT_AQUA);    return os; }
+    inline std::ostream & light_green_on_light_red(std::ostream & os)     { set(os, LIGHT_GREEN, LIGHT_RED);     return os; }
+    inline std::ostream & light_green_on_light_purple(std::ostream & os)  { set(os, LIGHT_GREEN, LIGHT_PURPLE);  return os; }
+    inline std::ostream & light_green_on_light_yellow(std::ostream & os)  { set(os, LIGHT_GREEN, LIGHT_YELLOW);  return os; }
+    inline std::ostream & light_green_on_bright_white(std::ostream & os)  { set(os, LIGHT_GREEN, BRIGHT_WHITE);  return os; }
+    inline std::ostream & light_aqua_on_black(std::ostream & os)          { set(os, LIGHT_AQUA, BLACK);          return os; }
+    inline std::ostream & light_aqua_on_blue(std::ostream & os)           { set(os, LIGHT_AQUA, BLUE);           return os; }
+    inline std::ostream & light_aqua_on_green(std::ostream & os)          { set(os, LIGHT_AQUA, GREEN);          return os; }
+    inline std::ostream & light_aqua_on_aqua(std::ostream & os)           { set(os, LIGHT_AQUA, AQUA);           return os; }
+    inline std::ostream & light_aqua_on_red(std::ostream & os)            { set(os, LIGHT_AQUA, RED);            return os; }
+    inline std::ostream & light_aqua_on_purple(std::ostream & os)         { set(os, LIGHT_AQUA, PURPLE);         return os; }
+    inline std::ostream & light_aqua_on_yellow(std::ostream & os)         { set(os, LIGHT_AQUA, YELLOW);         return os; }
+    inline std::ostream & light_aqua_on_white(std::ostream & os)          { set(os, LIGHT_AQUA, WHITE);          return os; }
+    inline std::ostream & light_aqua_on_grey(std::ostream & os)           { set(os, LIGHT_AQUA, GREY);           return os; }
+    inline std::ostream & light_aqua_on_light_blue(std::ostream & os)     { set(os, LIGHT_AQUA, LIGHT_BLUE);     return os; }
+    inline std::ostream & light_aqua_on_light_green(std::ostream & os)    { set(os, LIGHT_AQUA, LIGHT_GREEN);    return os; }
+    inline std::ostream & light_aqua_on_light_aqua(std::ostream & os)     { set(os, LIGHT_AQUA, LIGHT_AQUA);     return os; }
+    inline std::ostream & light_aqua_on_light_red(std::ostream & os)      { set(os, LIGHT_AQUA, LIGHT_RED);      return os; }
+    inline std::ostream & light_aqua_on_light_purple(std::ostream & os)   { set(os, LIGHT_AQUA, LIGHT_PURPLE);   return os; }
+    inline std::ostream & light_aqua_on_light_yellow(std::ostream & os)   { set(os, LIGHT_AQUA, LIGHT_YELLOW);   return os; }
+    inline std::ostream & light_aqua_on_bright_white(std::ostream & os)   { set(os, LIGHT_AQUA, BRIGHT_WHITE);   return os; }
+    inline std::ostream & light_red_on_black(std::ostream & os)           { set(os, LIGHT_RED, BLACK);           return os; }
+    inline std::ostream & light_red_on_blue(std::ostream & os)            { set(os, LIGHT_RED, BLUE);            return os; }
+    inline std::ostream & light_red_on_green(std::ostream & os)           { set(os, LIGHT_RED, GREEN);           return os; }
+    inline std::ostream & light_red_on_aqua(std::ostream & os)            { set(os, LIGHT_RED, AQUA);            return os; }
+    inline std::ostream & light_red_on_red(std::ostream & os)             { set(os, LIGHT_RED, RED);             return os; }
+    inline std::ostream & light_red_on_purple(std::ostream & os)          { set(os, LIGHT_RED, PURPLE);          return os; }
+    inline std::ostream & light_red_on_yellow(std::ostream & os)          { set(os, LIGHT_RED, YELLOW);          return os; }
+    inline std::ostream & light_red_on_white(std::ostream & os)           { set(os, LIGHT_RED, WHITE);           return os; }
+    inline std::ostream & light_red_on_grey(std::ostream & os)            { set(os, LIGHT_RED, GREY);            return os; }
+    inline std::ostream & light_red_on_light_blue(std::ostream & os)      { set(os, LIGHT_RED, LIGHT_BLUE);      return os; }
+    inline std::ostream & light_red_on_light_green(std::ostream & os)     { set(os, LIGHT_RED, LIGHT_GREEN);     return os; }
+    inline std::ostream & light_red_on_light_aqua(std::ostream & os)      { set(os, LIGHT_RED, LIGHT_AQUA);      return os; }
+    inline std::ostream & light_red_on_light_red(std::ostream & os)       { set(os, LIGHT_RED, LIGHT_RED);       return os; }
+    inline std::ostream & light_red_on_light_purple(std::ostream & os)    { set(os, LIGHT_RED, LIGHT_PURPLE);    return os; }
+    inline std::ostream & light_red_on_light_yellow(std::ostream & os)    { set(os, LIGHT_RED, LIGHT_YELLOW);    return os; }
+    inline std::ostream & light_red_on_bright_white(std::ostream & os)    { set(os, LIGHT_RED, BRIGHT_WHITE);    return os; }
+    inline std::ostream & light_purple_on_black(std::ostream & os)        { set(os, LIGHT_PURPLE, BLACK);        return os; }
+    inline std::ostream & light_purple_on_blue(std::ostream & os)         { set(os, LIGHT_PURPLE, BLUE);         return os; }
+    inline std::ostream & light_purple_on_green(std::ostream & os)        { set(os, LIGHT_PURPLE, GREEN);        return os; }
+    inline std::ostream & light_purple_on_aqua(std::ostream & os)         { set(os, LIGHT_PURPLE, AQUA);         return os; }
+    inline std::ostream & light_purple_on_red(std::ostream & os)          { set(os, LIGHT_PURPLE, RED);          return os; }
+    inline std::ostream & light_purple_on_purple(std::ostream & os)       { set(os, LIGHT_PURPLE, PURPLE);       return os; }
+    inline std::ostream & light_purple_on_yellow(std::ostream & os)       { set(os, LIGHT_PURPLE, YELLOW);       return os; }
+    inline std::ostream & light_purple_on_white(std::ostream & os)        { set(os, LIGHT_PURPLE, WHITE);        return os; }
+    inline std::ostream & light_purple_on_grey(std::ostream & os)         { set(os, LIGHT_PURPLE, GREY);         return os; }
+    inline std::ostream & light_purple_on_light_blue(std::ostream & os)   { set(os, LIGHT_PURPLE, LIGHT_BLUE);   return os; }
+    inline std::ostream & light_purple_on_light_green(std::ostream & os)  { set(os, LIGHT_PURPLE, LIGHT_GREEN);  return os; }
+    inline std::ostream & light_purple_on_light_aqua(std::ostream & os)   { set(os, LIGHT_PURPLE, LIGHT_AQUA);   return os; }
+    inline std::ostream & light_purple_on_light_red(std::ostream & os)    { set(os, LIGHT_PURPLE, LIGHT_RED);    return os; }
+    inline std::ostream & light_purple_on_light_purple(std::ostream & os) { set(os, LIGHT_PURPLE, LIGHT_PURPLE); return os; }
+    inline std::ostream & light_purple_on_light_yellow(std::ostream & os) { set(os, LIGHT_PURPLE, LIGHT_YELLOW); return os; }
+    inline std::ostream & light_purple_on_bright_white(std::ostream & os) { set(os, LIGHT_PURPLE, BRIGHT_WHITE); return os; }
+    inline std::ostream & light_yellow_on_black(std::ostream & os)        { set(os, LIGHT_YELLOW, BLACK);        return os; }
+    inline std::ostream & light_yellow_on_blue(std::ostream & os)         { set(os, LIGHT_YELLOW, BLUE);         return os; }
+    inline std::ostream & light_yellow_on_green(std::ostream & os)        { set(os, LIGHT_YELLOW, GREEN);        return os; }
+    inline std::ostream & light_yellow_on_aqua(std::ostream & os)         { set(os, LIGHT_YELLOW, AQUA);         return os; }
+    inline std::ostream & light_yellow_on_red(std::ostream & os)          { set(os, LIGHT_YELLOW, RED);          return os; }
+    inline std::ostream & light_yellow_on_purple(std::ostream & os)       { set(os, LIGHT_YELLOW, PURPLE);       return os; }
+    inline std::ostream & light_yellow_on_yellow(std::ostream & os)       { set(os, LIGHT_YELLOW, YELLOW);       return os; }
+    inline std::ostream & light_yellow_on_white(std::ostream & os)        { set(os, LIGHT_YELLOW, WHITE);        return os; }
+    inline std::ostream & light_yellow_on_grey(std::ostream & os)         { set(os, LIGHT_YELLOW, GREY);         return os; }
+    inline std::ostream & light_yellow_on_light_blue(std::ostream & os)   { set(os, LIGHT_YELLOW, LIGHT_BLUE);   return os; }
+    inline std::ostream & light_yellow_on_light_green(std::ostream & os)  { set(os, LIGHT_YELLOW, LIGHT_GREEN);  return os; }
+    inline std::ostream & light_yellow_on_light_aqua(std::ostream & os)   { set(os, LIGHT_YELLOW, LIGHT_AQUA);   return os; }
+    inline std::ostream & light_yellow_on_light_red(std::ostream & os)    { set(os, LIGHT_YELLOW, LIGHT_RED);    return os; }
+    inline std::ostream & light_yellow_on_light_purple(std::ostream & os) { set(os, LIGHT_YELLOW, LIGHT_PURPLE); return os; }
+    inline std::ostream & light_yellow_on_light_yellow(std::ostream & os) { set(os, LIGHT_YELLOW, LIGHT_YELLOW); return os; }
+    inline std::ostream & light_yellow_on_bright_white(std::ostream & os) { set(os, LIGHT_YELLOW, BRIGHT_WHITE); return os; }
+    inline std::ostream & bright_white_on_black(std::ostream & os)        { set(os, BRIGHT_WHITE, BLACK);        return os; }
+    inline std::ostream & bright_white_on_blue(std::ostream & os)         { set(os, BRIGHT_WHITE, BLUE);         return os; }
+    inline std::ostream & bright_white_on_green(std::ostream & os)        { set(os, BRIGHT_WHITE, GREEN);        return os; }
+    inline std::ostream & bright_white_on_aqua(std::ostream & os)         { set(os, BRIGHT_WHITE, AQUA);         return os; }
+    inline std::ostream & bright_white_on_red(std::ostream & os)          { set(os, BRIGHT_WHITE, RED);          return os; }
+    inline std::ostream & bright_white_on_purple(std::ostream & os)       { set(os, BRIGHT_WHITE, PURPLE);       return os; }
+    inline std::ostream & bright_white_on_yellow(std::ostream & os)       { set(os, BRIGHT_WHITE, YELLOW);       return os; }
+    inline std::ostream & bright_white_on_white(std::ostream & os)        { set(os, BRIGHT_WHITE, WHITE);        return os; }
+    inline std::ostream & bright_white_on_grey(std::ostream & os)         { set(os, BRIGHT_WHITE, GREY);         return os; }
+    inline std::ostream & bright_white_on_light_blue(std::ostream & os)   { set(os, BRIGHT_WHITE, LIGHT_BLUE);   return os; }
+    inline std::ostream & bright_white_on_light_green(std::ostream & os)  { set(os, BRIGHT_WHITE, LIGHT_GREEN);  return os; }
+    inline std::ostream & bright_white_on_light_aqua(std::ostream & os)   { set(os, BRIGHT_WHITE, LIGHT_AQUA);   return os; }
+    inline std::ostream & bright_white_on_light_red(std::ostream & os)    { set(os, BRIGHT_WHITE, LIGHT_RED);    return os; }
+    inline std::ostream & bright_white_on_light_purple(std::ostream & os) { set(os, BRIGHT_WHITE, LIGHT_PURPLE); return os; }
+    inline std::ostream & bright_white_on_light_yellow(std::ostream & os) { set(os, BRIGHT_WHITE, LIGHT_YELLOW); return os; }
+    inline std::ostream & bright_white_on_bright_white(std::ostream & os) { set(os, BRIGHT_WHITE, BRIGHT_WHITE); return os; }
+}
+
+
+namespace dye
+{
+    // A non-owning handle on an object, so that dyeing it costs a pointer
+    // instead of a copy.  The object must outlive whatever is dyed with it,
+    // which is why temporaries are turned away:
+    //
+    //     std::cout << dye::red(dye::ref(big)) << std::endl;
+    template<typename T>
+    class view
+    {
+        const T * p;
+
+    public:
+        explicit view(const T & t) : p(&t) {}
+        view(const T &&) = delete;
+        view(std::reference_wrapper<T> r) : p(&r.get()) {}
+        view(std::reference_wrapper<const T> r) : p(&r.get()) {}
+
+        const T & get() const
+        {
+            return *p;
+        }
+
+        friend std::ostream & operator<<(std::ostream & os, const view & v)
+        {
+            return os << *v.p;
+        }
+    };
+
+    template<typename T>
+    view<T> ref(const T & t)
+    {
+        return view<T>(t);
+    }
+
+    template<typename T>
+    void ref(const T &&) = delete;
+
+    // A piece of text to dye: either a view on a literal or a string_view,
+    // which costs nothing to make, or a std::string of its own.  A view must
+    // not outlive the characters it looks at; dye::copy makes an owning one.
+    // A text is a pointer and a size either way, so that an item of text is
+    // smaller than one of std::string: a string owned is kept in place of
+    // the pointer when it fits there, and on the heap when it does not.
+    class text
+    {
+        static constexpr std::size_t OWNED = static_cast<std::size_t>(-1);
+        static constexpr std::size_t SHORT = OWNED - 2 * sizeof(const char *);
+
+        union
+        {
+            const char * p;                     // the characters viewed
+            std::string * own;                  // the string owned, when n is OWNED
+            char chars[sizeof(const char *)];   // the characters owned, when n is SHORT + size
+        };
+        std::size_t n;
+
+    public:
+        text() : p(""), n(0) {}
+        text(const char * s) : p(s), n(std::char_traits<char>::length(s)) {}
+        text(const char * s, std::size_t n) : p(s), n(n) {}
+
+        text(std::string s)
+        {
+            if (s.size() <= sizeof chars) {
+                std::memcpy(chars, s.data(), s.size());
+                n = SHORT + s.size();
+            }
+            else {
+                own = new std::string(std::move(s));
+                n = OWNED;
+            }
+        }
+
+        text(const text & t) : n(t.n)
+        {
+            if (n == OWNED)
+                own = new std::string(*t.own);
+            else
+                std::memcpy(chars, t.chars, sizeof chars);
+        }
+
+        text(text && t) noexcept : n(t.n)
+        {
+            std::memcpy(chars, t.chars, sizeof chars);
+            t.p = "";
+            t.n = 0;
+        }
+
+        text & operator=(text t) noexcept
+        {
+            char c[sizeof chars];
+            std::memcpy(c, chars, sizeof chars);
+            std::memcpy(chars, t.chars, sizeof chars);
+            std::memcpy(t.chars, c, sizeof chars);
+            std::swap(n, t.n);
+            return *this;
+        }
+
+        ~text()
+        {
+            if (n == OWNED)
+                delete own;
+        }
+#if COLOR_CONSOLE_CPP17
+        text(std::string_view s) : p(s.data()), n(s.size()) {}
+
+        operator std::string_view() const
+        {
+            return std::string_view(data(), size());
+        }
+#endif
+
+        const char * data() const
+        {
+            return n < SHORT ? p : n == OWNED ? own->data() : chars;
+        }
+
+        std::size_t size() const
+        {
+            return n < SHORT ? n : n == OWNED ? own->size() : n - SHORT;
+        }
+
+        bool owning() const
+        {
+            return n >= SHORT;
+        }
+
+        std::string str() const
+        {
+            return std::string(data(), size());
+        }
+
+        friend std::ostream & operator<<(std::ostream & os, const text & t)
+        {
+            // padding goes through the formatted std::string path
+            if (os.width() > 0)
+                return os << t.str();
+            os.write(t.data(), static_cast<std::streamsize>(t.size()));
+            return os;
+        }
+    };
+
+#if COLOR_CONSOLE_CPP17
+    inline text copy(std::string_view s)
+    {
+        return text(std::string(s));
+    }
+#else
+    inline text copy(const char * s)
+    {
+        return text(std::string(s));
+    }
+
+    inline text copy(const std::string & s)
+    {
+        return text(s);
+    }
+#endif
+
+    // what an item keeps of the T it is dyed from: literals, strings and
+    // string_views become text, and std::ref/std::cref a view
+    template<typename T>
+    struct stored
+    {
+        using type = T;
+    };
+
+    template<>
+    struct stored<const char *>
+    {
+        using type = text;
+    };
+
+    template<>
+    struct stored<std::string>
+    {
+        using type = text;
+    };
+
+#if COLOR_CONSOLE_CPP17
+    template<>
+    struct stored<std::string_view>
+    {
+        using type = text;
+    };
+#endif
+
+    template<typename T>
+    struct stored<std::reference_wrapper<T>>
+    {
+        using type = view<typename std::remove_const<T>::type>;
+    };
+
+    template<typename T>
+    using bar = typename stored<T>::type;
+
+    template<typename T> class colorful;
+    template<typename T> class item;
+    class builder;
+    class styled_string;
+    struct measure;
+
+    // a vector whose first N elements live inline, growing geometrically
+    // onto the heap after that; a block grown for a push to the front keeps
+    // its new room at the front, so prepends cost amortized O(1) as appends do
+    template<typename T, std::size_t N>
+    class small_vector
+    {
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type local[N];
+        T * first;
+        std::size_t count;
+        std::size_t capacity;       // the slots in the block, lead included
+        std::size_t lead;           // free slots before first
+
+    public:
+        small_vector() noexcept : first(inline_data()), count(0), capacity(N), lead(0) {}
+
+        small_vector(std::initializer_list<T> init) : small_vector()
+        {
+            append(init.begin(), init.size());
+        }
+
+        small_vector(const small_vector & rhs) : small_vector()
+        {
+            append(rhs.first, rhs.count);
+        }
+
+        small_vector(small_vector && rhs) noexcept(std::is_nothrow_move_constructible<T>::value)
+            : small_vector()
+        {
+            steal(rhs);
+        }
+
+        small_vector & operator=(const small_vector & rhs)
+        {
+            if (this != &rhs) {
+                clear();
+                append(rhs.first, rhs.count);
+            }
+            return *this;
+        }
+
+        small_vector & operator=(small_vector && rhs) noexcept(std::is_nothrow_move_constructible<T>::value)
+        {
+            if (this != &rhs) {
+                clear();
+                release();
+                steal(rhs);
+            }
+            return *this;
+        }
+
+        ~small_vector()
+        {
+            clear();
+            release();
+        }
+
+        T * begin()                 { return first; }
+        T * end()                   { return first + count; }
+        const T * begin() const     { return first; }
+        const T * end() const       { return first + count; }
+        std::size_t size() const    { return count; }
+        bool empty() const          { return count == 0; }
+
+        void reserve(std::size_t n)
+        {
+            if (lead + n > capacity)
+                grow(std::max(lead + n, capacity * 2), lead);
+        }
+
+        template<typename... A>
+        void emplace_back(A &&... a)
+        {
+            if (lead + count == capacity)
+                grow(capacity * 2, lead);
+            ::new (static_cast<void *>(first + count)) T(std::forward<A>(a)...);
+            ++count;
+        }
+
+        template<typename... A>
+        void emplace_front(A &&... a)
+        {
+            // all the room a grown block adds goes in front
+            if (lead == 0)
+                grow(capacity * 2, capacity);
+            ::new (static_cast<void *>(first - 1)) T(std::forward<A>(a)...);
+            --first;
+            --lead;
+            ++count;
+        }
+
+        // copy n elements from p, which may point into this vector
+        void append(const T * p, std::size_t n)
+        {
+            std::less<const T *> before;
+            bool self = !before(p, first) && before(p, first + count);
+            std::size_t offset = self ? p - first : 0;
+            reserve(count + n);
+            if (self)
+                p = first + offset;
+            for (std::size_t i = 0; i != n; ++i)
+                emplace_back(p[i]);
+        }
+
+        // take over rhs: its heap block if this is empty, its elements if not
+        void append(small_vector && rhs)
+        {
+            if (empty()) {
+                release();
+                steal(rhs);
+            }
+            else if (this != &rhs) {
+                reserve(count + rhs.count);
+                for (auto & elem : rhs)
+                    emplace_back(std::move(elem));
+                rhs.clear();
+            }
+            else {
+                append(first, count);
+            }
+        }
+
+        void clear()
+        {
+            for (auto & elem : *this)
+                elem.~T();
+            count = 0;
+            first -= lead;
+            lead = 0;
+        }
+
+    private:
+        T * inline_data()
+        {
+            return reinterpret_cast<T *>(&local[0]);
+        }
+
+        bool is_inline() const
+        {
+            return first - lead == reinterpret_cast<const T *>(&local[0]);
+        }
+
+        // move the elements into a block of n slots, after the first ahead
+        // free ones; the old elements are destroyed only once all are moved,
+        // so a copy that throws leaves this as it was
+        void grow(std::size_t n, std::size_t ahead)
+        {
+            T * p = static_cast<T *>(::operator new(n * sizeof(T)));
+            COLOR_CONSOLE_COUNT(allocations, 1);
+            std::size_t i = 0;
+            try {
+                for (; i != count; ++i)
+                    ::new (static_cast<void *>(p + ahead + i)) T(std::move_if_noexcept(first[i]));
+            }
+            catch (...) {
+                while (i)
+                    p[ahead + --i].~T();
+                ::operator delete(p);
+                throw;
+            }
+            std::size_t k = count;
+            clear();
+            release();
+            first = p + ahead;
+            count = k;
+            capacity = n;
+            lead = ahead;
+        }
+
+        // give back the heap block, if any; only called when empty
+        void release()
+        {
+            if (!is_inline())
+                ::operator delete(first - lead);
+            first = inline_data();
+            capacity = N;
+            lead = 0;
+        }
+
+        // move rhs into this, which must be empty and inline
+        void steal(small_vector & rhs)
+        {
+            if (rhs.is_inline()) {
+                for (auto & elem : rhs)
+                    emplace_back(std::move(elem));
+                rhs.clear();
+            }
+            else {
+                first = rhs.first;
+                count = rhs.count;
+                capacity = rhs.capacity;
+                lead = rhs.lead;
+                rhs.first = rhs.inline_data();
+                rhs.count = 0;
+                rhs.capacity = N;
+                rhs.lead = 0;
+            }
+        }
+    };
+
+    template<typename T>
+    class colorful : private small_vector<item<T>, 2>
+    {
+        using base = small_vector<item<T>, 2>;
+
+    public:
+        using base::base;
+
+        colorful() = default;
+
+        // one item, moved in rather than copied out of an initializer_list
+        explicit colorful(item<T> && it)
+        {
+            this->emplace_back(std::move(it));
+        }
+
+        // a chain of text converts to one of std::string, the type dyed
+        // literals and strings had before they became text
+        template<typename U, typename = typename std::enable_if<std::is_same<T, std::string>::value &&
+                                                                std::is_same<U, text>::value>::type>
+        colorful(const colorful<U> & rhs)
+        {
+            this->reserve(rhs.size());
+            for (const auto & elem : rhs) {
+                this->emplace_back(elem.thing.str(), hue::DEFAULT_COLOR);
+                (this->end() - 1)->color = elem.color;
+            }
+        }
+
+        colorful<T> & operator+=(const colorful<T> & rhs)
+        {
+            this->append(rhs.begin(), rhs.size());
+            return *this;
+        }
+
+        colorful<T> & operator+=(colorful<T> && rhs)
+        {
+            this->append(std::move(static_cast<base &>(rhs)));
+            return *this;
+        }
+
+        colorful<T> & operator+=(T t)
+        {
+            this->push_back(std::move(t));
+            return *this;
+        }
+
+        void push_front(T t)
+        {
+            this->emplace_front(std::move(t));
+        }
+
+        void push_back(T t)
+        {
+            this->emplace_back(std::move(t));
+        }
+
+        colorful<T> & invert()
+        {
+            for (auto & elem : *this)
+                elem.invert();
+            return *this;
+        }
+
+        template<typename U>
+        friend class colorful;
+
+        template<typename U>
+        friend std::ostream & operator<<(std::ostream &, const colorful<U> &);
+
+        template<typename U>
+        friend colorful<U> invert(colorful<U> col);
+
+        friend class builder;
+        friend class styled_string;
+        friend struct measure;
+    };
+
+    template<typename T>
+    colorful<T> operator+(colorful<T> lhs, colorful<T> rhs)
+    {
+        colorful<T> res(std::move(lhs));
+        res += std::move(rhs);
+        return res;
+    }
+
+    template<typename T>
+    colorful<T> operator+(colorful<T> lhs, std::string rhs)
+    {
+        colorful<T> res(std::move(lhs));
+        res.push_back(std::move(rhs));
+        return res;
+    }
+
+    template<typename T>
+    colorful<T> operator+(const std::string & lhs, colorful<T> rhs)
+    {
+        colorful<T> res(std::move(rhs));
+        res.push_front(std::move(lhs));
+        return res;
+    }
+
+    template<typename T>
+    std::ostream & operator<<(std::ostream & os, const colorful<T> & colorful)
+    {
+        COLOR_CONSOLE_COUNT(items, colorful.size());
+        if (hue::muted(os)) {
+            for (const auto & elem : colorful)
+                os << elem.thing;
+            return os;
+        }
+        // switch color only where it changes along the chain, reset once
+        int current = hue::BAD_COLOR;
+        for (const auto & elem : colorful) {
+            int c = (hue::is_good(elem.color) || hue::is_extended(elem.color)) ? elem.color : hue::DEFAULT_COLOR;
+            if (c != current) {
+                hue::set(os, c);
+                current = c;
+            }
+            os << elem.thing;
+        }
+        if (current != hue::BAD_COLOR && current != hue::DEFAULT_COLOR)
+            hue::reset(os);
+        return os;
+    }
+
+    template<typename T>
+    colorful<T> invert(colorful<T> col)
+    {
+        colorful<T> res(std::move(col));
+        for (auto & elem : res)
+            elem.invert();
+        return res;
+    }
+
+    template<typename T>
+    class item
+    {
+        T thing;
+        int color;
+
+    public:
+        item(T t)                               :  thing(std::move(t)), color(hue::get())       {}
+        item(T t, int a)                        :  thing(std::move(t)), color(hue::itoc(a))     {}
+        item(T t, int a, int b)                 :  thing(std::move(t)), color(hue::itoc(a, b))  {}
+        item(T t, std::string a)                :  thing(std::move(t)), color(hue::stoc(a))     {}
+        item(T t, std::string a, std::string b) :  thing(std::move(t)), color(hue::stoc(a, b))  {}
+
+        item<T> & invert()
+        {
+            color = hue::invert(color);
+            return *this;
+        }
+
+        template<typename U>
+        friend class colorful;
+
+        template<typename U>
+        friend std::ostream & operator<<(std::ostream &, const item<U> &);
+
+        template<typename U>
+        friend std::ostream & operator<<(std::ostream &, const colorful<U> &);
+
+        friend class builder;
+        friend class styled_string;
+        friend struct measure;
+    };
+
+    template<typename T>
+    std::ostream & operator<<(std::ostream & os, const item<T> & it)
+    {
+        COLOR_CONSOLE_COUNT(items, 1);
+        if (hue::muted(os))
+            return os << it.thing;
+        hue::set(os, it.color);
+        os << it.thing;
+        hue::reset(os);
+        return os;
+    }
+
+    // literals and views join a dyed text chain as views, strings as copies
+    inline colorful<text> operator+(colorful<text> lhs, text rhs)
+    {
+        colorful<text> res(std::move(lhs));
+        res.push_back(std::move(rhs));
+        return res;
+    }
+
+    inline colorful<text> operator+(text lhs, colorful<text> rhs)
+    {
+        colorful<text> res(std::move(rhs));
+        res.push_front(std::move(lhs));
+        return res;
+    }
+
+    // builds one long colored text out of many small appends; the text and
+    // its color runs are copied into chunks the builder owns, which grow
+    // geometrically and are freed all at once
+    class builder
+    {
+        struct run
+        {
+            const char * text;
+            std::size_t size;
+            int color;
+        };
+
+        struct chunk
+        {
+            chunk * next;
+        };
+
+        struct segment
+        {
+            segment * next;
+            std::size_t count;
+            std::size_t capacity;
+
+            run * runs()
+            {
+                return reinterpret_cast<run *>(this + 1);
+            }
+
+            const run * runs() const
+            {
+                return reinterpret_cast<const run *>(this + 1);
+            }
+        };
+
+        chunk * chunks;
+        char * cursor;
+        char * limit;
+        std::size_t chunk_size;
+        segment * first;
+        segment * last;
+
+    public:
+        builder() noexcept
+            : chunks(nullptr), cursor(nullptr), limit(nullptr), chunk_size(4096),
+              first(nullptr), last(nullptr) {}
+
+        builder(const builder &) = delete;
+        builder & operator=(const builder &) = delete;
+
+        builder(builder && rhs) noexcept
+            : chunks(rhs.chunks), cursor(rhs.cursor), limit(rhs.limit),
+              chunk_size(rhs.chunk_size), first(rhs.first), last(rhs.last)
+        {
+            rhs.chunks = nullptr;
+            rhs.cursor = rhs.limit = nullptr;
+            rhs.first = rhs.last = nullptr;
+        }
+
+        builder & operator=(builder && rhs) noexcept
+        {
+            if (this != &rhs) {
+                clear();
+                std::swap(chunks, rhs.chunks);
+                std::swap(cursor, rhs.cursor);
+                std::swap(limit, rhs.limit);
+                std::swap(chunk_size, rhs.chunk_size);
+                std::swap(first, rhs.first);
+                std::swap(last, rhs.last);
+            }
+            return *this;
+        }
+
+        ~builder()
+        {
+            clear();
+        }
+
+        // copy n bytes at s in color c, joining the previous run if it can
+        builder & append(const char * s, std::size_t n, int c)
+        {
+            if (n == 0)
+                return *this;
+            c = (hue::is_good(c) || hue::is_extended(c)) ? c : hue::DEFAULT_COLOR;
+            run * back = (last && last->count) ? last->runs() + last->count - 1 : nullptr;
+            char * p = static_cast<char *>(allocate(n, 1));
+            std::copy(s, s + n, p);
+            if (back && back->color == c && back->text + back->size == p)
+                back->size += n;
+            else
+                push({p, n, c});
+            return *this;
+        }
+
+        builder & append(const std::string & s, int c)
+        {
+            return append(s.data(), s.size(), c);
+        }
+
+        builder & operator+=(const std::string & s)
+        {
+            return append(s, hue::get());
+        }
+
+        builder & operator+=(const char * s)
+        {
+            return append(s, std::char_traits<char>::length(s), hue::get());
+        }
+
+        builder & operator+=(const colorful<std::string> & col)
+        {
+            for (const auto & elem : col)
+                append(elem.thing, elem.color);
+            return *this;
+        }
+
+        builder & operator+=(const colorful<dye::text> & col)
+        {
+            for (const auto & elem : col)
+                append(elem.thing.data(), elem.thing.size(), elem.color);
+            return *this;
+        }
+
+        bool empty() const
+        {
+            return !first || first->count == 0;
+        }
+
+        // drop all text and give every chunk back
+        void clear()
+        {
+            while (chunks) {
+                chunk * next = chunks->next;
+                ::operator delete(chunks);
+                chunks = next;
+            }
+            cursor = limit = nullptr;
+            first = last = nullptr;
+            chunk_size = 4096;
+        }
+
+        friend std::ostream & operator<<(std::ostream &, const builder &);
+
+    private:
+        void * allocate(std::size_t n, std::size_t align)
+        {
+            std::size_t pad = (align - reinterpret_cast<std::uintptr_t>(cursor) % align) % align;
+            if (!cursor || static_cast<std::size_t>(limit - cursor) < pad + n) {
+                while (chunk_size < n + sizeof(chunk) + align)
+                    chunk_size *= 2;
+                chunk * c = static_cast<chunk *>(::operator new(chunk_size));
+                c->next = chunks;
+                chunks = c;
+                cursor = reinterpret_cast<char *>(c + 1);
+                limit = reinterpret_cast<char *>(c) + chunk_size;
+                chunk_size *= 2;
+                pad = (align - reinterpret_cast<std::uintptr_t>(cursor) % align) % align;
+            }
+            void * p = cursor + pad;
+            cursor += pad + n;
+            return p;
+        }
+
+        void push(const run & r)
+        {
+            if (!last || last->count == last->capacity) {
+                std::size_t capacity = last ? last->capacity * 2 : 64;
+                void * p = allocate(sizeof(segment) + capacity * sizeof(run), alignof(segment));
+                segment * seg = ::new (p) segment{nullptr, 0, capacity};
+                (last ? last->next : first) = seg;
+                last = seg;
+            }
+            last->runs()[last->count++] = r;
+        }
+    };
+
+    inline std::ostream & operator<<(std::ostream & os, const builder & b)
+    {
+        const bool muted = hue::muted(os) != 0;
+        int current = hue::BAD_COLOR;
+        for (const builder::segment * seg = b.first; seg; seg = seg->next) {
+            COLOR_CONSOLE_COUNT(items, seg->count);
+            for (const builder::run * r = seg->runs(); r != seg->runs() + seg->count; ++r) {
+                if (r->color != current && !muted) {
+                    hue::set(os, r->color);
+                    current = r->color;
+                }
+                os.write(r->text, r->size);
+            }
+        }
+        if (current != hue::BAD_COLOR && current != hue::DEFAULT_COLOR)
+            hue::reset(os);
+        return os;
+    }
+
+    // all text in one buffer, with a (offset, size, color) run per stretch of
+    // one color; neighbouring runs of the same color are always merged.  Runs
+    // count in 32 bits, so appending past 4 GiB of text throws
+    // std::length_error.
+    class styled_string
+    {
+        struct run
+        {
+            std::uint32_t offset;
+            std::uint32_t size;
+            unsigned char color;
+        };
+
+        std::string text;
+        std::vector<run> runs;
+
+    public:
+        styled_string() = default;
+
+        styled_string(const char * s)                   { append(s, std::char_traits<char>::length(s), hue::get()); }
+        styled_string(const std::string & s)            { append(s.data(), s.size(), hue::get()); }
+        styled_string(const std::string & s, int c)     { append(s.data(), s.size(), c); }
+
+        template<typename T>
+        explicit styled_string(const colorful<T> & col)
+        {
+            *this += col;
+        }
+
+        styled_string & append(const char * s, std::size_t n, int c)
+        {
+            if (n == 0)
+                return *this;
+            // runs keep console codes; extended colors take the nearest
+            c = hue::console(c);
+            unsigned char color = static_cast<unsigned char>(hue::is_good(c) ? c : hue::DEFAULT_COLOR);
+            if (n > UINT32_MAX - text.size())
+                throw std::length_error("dye::styled_string: more than 4 GiB of text");
+            auto offset = static_cast<std::uint32_t>(text.size());
+            text.append(s, n);
+            if (!runs.empty() && runs.back().color == color)
+                runs.back().size += static_cast<std::uint32_t>(n);
+            else
+                runs.push_back({offset, static_cast<std::uint32_t>(n), color});
+            return *this;
+        }
+
+        styled_string & operator+=(const styled_string & rhs)
+        {
+            text.reserve(text.size() + rhs.text.size());
+            for (const auto & r : rhs.runs)
+                append(rhs.text.data() + r.offset, r.size, r.color);
+            return *this;
+        }
+
+        styled_string & operator+=(const std::string & s)
+        {
+            return append(s.data(), s.size(), hue::get());
+        }
+
+        styled_string & operator+=(const char * s)
+        {
+            return append(s, std::char_traits<char>::length(s), hue::get());
+        }
+
+        template<typename T>
+        styled_string & operator+=(const colorful<T> & col)
+        {
+            for (const auto & elem : col)
+                append_thing(elem.thing, elem.color);
+            return *this;
+        }
+
+        styled_string & invert()
+        {
+            for (auto & r : runs)
+                r.color = static_cast<unsigned char>(hue::invert(r.color));
+            return *this;
+        }
+
+        // the text without its colors
+        const std::string & str() const
+        {
+            return text;
+        }
+
+        std::size_t size() const
+        {
+            return text.size();
+        }
+
+        bool empty() const
+        {
+            return text.empty();
+        }
+
+        friend std::ostream & operator<<(std::ostream &, const styled_string &);
+
+    private:
+        void append_thing(const std::string & s, int c)
+        {
+            append(s.data(), s.size(), c);
+        }
+
+        void append_thing(const dye::text & s, int c)
+        {
+            append(s.data(), s.size(), c);
+        }
+
+        template<typename T>
+        void append_thing(const T & t, int c)
+        {
+            std::ostringstream oss;
+            oss << t;
+            append_thing(oss.str(), c);
+        }
+    };
+
+    inline styled_string operator+(styled_string lhs, const styled_string & rhs)
+    {
+        lhs += rhs;
+        return lhs;
+    }
+
+    inline styled_string operator+(styled_string lhs, const std::string & rhs)
+    {
+        lhs += rhs;
+        return lhs;
+    }
+
+    inline styled_string operator+(styled_string lhs, const char * rhs)
+    {
+        lhs += rhs;
+        return lhs;
+    }
+
+    inline styled_string operator+(const std::string & lhs, const styled_string & rhs)
+    {
+        styled_string res(lhs);
+        res += rhs;
+        return res;
+    }
+
+    inline styled_string operator+(const char * lhs, const styled_string & rhs)
+    {
+        styled_string res(lhs);
+        res += rhs;
+        return res;
+    }
+
+    inline styled_string invert(styled_string s)
+    {
+        s.invert();
+        return s;
+    }
+
+    inline std::ostream & operator<<(std::ostream & os, const styled_string & s)
+    {
+        COLOR_CONSOLE_COUNT(items, s.runs.size());
+        if (hue::muted(os))
+            return os.write(s.text.data(), static_cast<std::streamsize>(s.text.size()));
+        // runs are merged by color, so each one is a single write
+        for (const auto & r : s.runs) {
+            hue::set(os, r.color);
+            os.write(s.text.data() + r.offset, r.size);
+        }
+        if (!s.runs.empty() && s.runs.back().color != hue::DEFAULT_COLOR)
+            hue::reset(os);
+        return os;
+    }
+
+    template<typename T> using R = colorful<bar<T>>;
+    template<typename T> using S = item<bar<T>>;
+
+#if COLOR_CONSOLE_CPP17
+    template<typename T> R<T> colorize(T t, std::string_view a) { return R<T>(S<T>(std::move(t), hue::stoc(a))); }
+#else
+    template<typename T> R<T> colorize(T t, const char * a)     { return R<T>(S<T>(std::move(t), hue::stoc(a))); }
+    template<typename T> R<T> colorize(T t, const std::string & a) { return R<T>(S<T>(std::move(t), hue::stoc(a))); }
+#endif
+    template<typename T> R<T> vanilla(T t)                      { return R<T>(S<T>(std::move(t))); }
+    template<typename T> R<T> black(T t)                        { return R<T>(S<T>(std::move(t), hue::BLACK)); }
+    template<typename T> R<T> blue(T t)                         { return R<T>(S<T>(std::move(t), hue::BLUE)); }
+    template<typename T> R<T> green(T t)                        { return R<T>(S<T>(std::move(t), hue::GREEN)); }
+    template<typename T> R<T> aqua(T t)                         { return R<T>(S<T>(std::move(t), hue::AQUA)); }
+    template<typename T> R<T> red(T t)                          { return R<T>(S<T>(std::move(t), hue::RED)); }
+    template<typename T> R<T> purple(T t)                       { return R<T>(S<T>(std::move(t), hue::PURPLE)); }
+    template<typename T> R<T> yellow(T t)                       { return R<T>(S<T>(std::move(t), hue::YELLOW)); }
+    template<typename T> R<T> white(T t)                        { return R<T>(S<T>(std::move(t), hue::WHITE)); }
+    template<typename T> R<T> grey(T t)                         { return R<T>(S<T>(std::move(t), hue::GREY)); }
+    template<typename T> R<T> light_blue(T t)                   { return R<T>(S<T>(std::move(t), hue::LIGHT_BLUE)); }
+    template<typename T> R<T> light_green(T t)                  { return R<T>(S<T>(std::move(t), hue::LIGHT_GREEN)); }
+    template<typename T> R<T> light_aqua(T t)                   { return R<T>(S<T>(std::move(t), hue::LIGHT_AQUA)); }
+    template<typename T> R<T> light_red(T t)                    { return R<T>(S<T>(std::move(t), hue::LIGHT_RED)); }
+    template<typename T> R<T> light_purple(T t)                 { return R<T>(S<T>(std::move(t), hue::LIGHT_PURPLE)); }
+    template<typename T> R<T> light_yellow(T t)                 { return R<T>(S<T>(std::move(t), hue::LIGHT_YELLOW)); }
+    template<typename T> R<T> bright_white(T t)                 { return R<T>(S<T>(std::move(t), hue::BRIGHT_WHITE)); }
+    template<typename T> R<T> on_black(T t)                     { return R<T>(S<T>(std::move(t), hue::BLACK, hue::BLACK)); }
+    template<typename T> R<T> on_blue(T t)                      { return R<T>(S<T>(std::move(t), hue::BLACK, hue::BLUE)); }
+    template<typename T> R<T> on_green(T t)                     { return R<T>(S<T>(std::move(t), hue::BLACK, hue::GREEN)); }
+    template<typename T> R<T> on_aqua(T t)                      { return R<T>(S<T>(std::move(t), hue::BLACK, hue::AQUA)); }
+    template<typename T> R<T> on_red(T t)                       { return R<T>(S<T>(std::move(t), hue::BLACK, hue::RED)); }
+    template<typename T> R<T> on_purple(T t)                    { return R<T>(S<T>(std::move(t), hue::BLACK, hue::PURPLE)); }
+    template<typename T> R<T> on_yellow(T t)                    { return R<T>(S<T>(std::move(t), hue::BLACK, hue::YELLOW)); }
+    template<typename T> R<T> on_white(T t)                     { return R<T>(S<T>(std::move(t), hue::BLACK, hue::WHITE)); }
+    template<typename T> R<T> on_grey(T t)                      { return R<T>(S<T>(std::move(t), hue::BLACK, hue::GREY)); }
+    template<typename T> R<T> on_light_blue(T t)                { return R<T>(S<T>(std::move(t), hue::BLACK, hue::LIGHT_BLUE)); }
+    template<typename T> R<T> on_light_green(T t)               { return R<T>(S<T>(std::move(t), hue::BLACK, hue::LIGHT_GREEN)); }
+    template<typename T> R<T> on_light_aqua(T t)                { return R<T>(S<T>(std::move(t), hue::BLACK, hue::LIGHT_AQUA)); }
+    template<typename T> R<T> on_light_red(T t)                 { return R<T>(S<T>(std::move(t), hue::BLACK, hue::LIGHT_RED)); }
+    template<typename T> R<T> on_light_purple(T t)              { return R<T>(S<T>(std::move(t), hue::BLACK, hue::LIGHT_PURPLE)); }
+    template<typename T> R<T> on_light_yellow(T t)              { return R<T>(S<T>(std::move(t), hue::BLACK, hue::LIGHT_YELLOW)); }
+    template<typename T> R<T> on_bright_white(T t)              { return R<T>(S<T>(std::move(t), hue::BLACK, hue::BRIGHT_WHITE)); }
+    template<typename T> R<T> black_on_black(T t)               { return R<T>(S<T>(std::move(t), hue::BLACK, hue::BLACK)); }
+    template<typename T> R<T> black_on_blue(T t)                { return R<T>(S<T>(std::move(t), hue::BLACK, hue::BLUE)); }
+    template<typename T> R<T> black_on_green(T t)               { return R<T>(S<T>(std::move(t), hue::BLACK, hue::GREEN)); }
+    template<typename T> R<T> black_on_aqua(T t)                { return R<T>(S<T>(std::move(t), hue::BLACK, hue::AQUA)); }
+    template<typename T> R<T> black_on_red(T t)                 { return R<T>(S<T>(std::move(t), hue::BLACK, hue::RED)); }
+    template<typename T> R<T> black_on_purple(T t)              { return R<T>(S<T>(std::move(t), hue::BLACK, hue::PURPLE)); }
+    template<typename T> R<T> black_on_yellow(T t)              { return R<T>(S<T>(std::move(t), hue::BLACK, hue::YELLOW)); }
+    template<typename T> R<T> black_on_white(T t)               { return R<T>(S<T>(std::move(t), hue::BLACK, hue::WHITE)); }
+    template<typename T> R<T> black_on_grey(T t)                { return R<T>(S<T>(std::move(t), hue::BLACK, hue::GREY)); }
+    template<typename T> R<T> black_on_light_blue(T t)          { return R<T>(S<T>(std::move(t), hue::BLACK, hue::LIGHT_BLUE)); }
+    template<typename T> R<T> black_on_light_green(T t)         { return R<T>(S<T>(std::move(t), hue::BLACK, hue::LIGHT_GREEN)); }
+    template<typename T> R<T> black_on_light_aqua(T t)          { return R<T>(S<T>(std::move(t), hue::BLACK, hue::LIGHT_AQUA)); }
+    template<typename T> R<T> black_on_light_red(T t)           { return R<T>(S<T>(std::move(t), hue::BLACK, hue::LIGHT_RED)); }
+    template<typename T> R<T> black_on_light_purple(T t)        { return R<T>(S<T>(std::move(t), hue::BLACK, hue::LIGHT_PURPLE)); }
+    template<typename T> R<T> black_on_light_yellow(T t)        { return R<T>(S<T>(std::move(t), hue::BLACK, hue::LIGHT_YELLOW)); }
+    template<typename T> R<T> black_on_bright_white(T t)        { return R<T>(S<T>(std::move(t), hue::BLACK, hue::BRIGHT_WHITE)); }
+    template<typename T> R<T> blue_on_black(T t)                { return R<T>(S<T>(std::move(t), hue::BLUE, hue::BLACK)); }
+    template<typename T> R<T> blue_on_blue(T t)                 { return R<T>(S<T>(std::move(t), hue::BLUE, hue::BLUE)); }
+    template<typename T> R<T> blue_on_green(T t)                { return R<T>(S<T>(std::move(t), hue::BLUE, hue::GREEN)); }
+    template<typename T> R<T> blue_on_aqua(T t)                 { return R<T>(S<T>(std::move(t), hue::BLUE, hue::AQUA)); }
+    template<typename T> R<T> blue_on_red(T t)                  { return R<T>(S<T>(std::move(t), hue::BLUE, hue::RED)); }
+    template<typename T> R<T> blue_on_purple(T t)               { return R<T>(S<T>(std::move(t), hue::BLUE, hue::PURPLE)); }
+    template<typename T> R<T> blue_on_yellow(T t)               { return R<T>(S<T>(std::move(t), hue::BLUE, hue::YELLOW)); }
+    template<typename T> R<T> blue_on_white(T t)                { return R<T>(S<T>(std::move(t), hue::BLUE, hue::WHITE)); }
+    template<typename T> R<T> blue_on_grey(T t)                 { return R<T>(S<T>(std::move(t), hue::BLUE, hue::GREY)); }
+    template<typename T> R<T> blue_on_light_blue(T t)           { return R<T>(S<T>(std::move(t), hue::BLUE, hue::LIGHT_BLUE)); }
+    template<typename T> R<T> blue_on_light_green(T t)          { return R<T>(S<T>(std::move(t), hue::BLUE, hue::LIGHT_GREEN)); }
+    template<typename T> R<T> blue_on_light_aqua(T t)           { return R<T>(S<T>(std::move(t), hue::BLUE, hue::LIGHT_AQUA)); }
+    template<typename T> R<T> blue_on_light_red(T t)            { return R<T>(S<T>(std::move(t), hue::BLUE, hue::LIGHT_RED)); }
+    template<typename T> R<T> blue_on_light_purple(T t)         { return R<T>(S<T>(std::move(t), hue::BLUE, hue::LIGHT_PURPLE)); }
+    template<typename T> R<T> blue_on_light_yellow(T t)         { return R<T>(S<T>(std::move(t), hue::BLUE, hue::LIGHT_YELLOW)); }
+    template<typename T> R<T> blue_on_bright_white(T t)         { return R<T>(S<T>(std::move(t), hue::BLUE, hue::BRIGHT_WHITE)); }
+    template<typename T> R<T> green_on_black(T t)               { return R<T>(S<T>(std::move(t), hue::GREEN, hue::BLACK)); }
+    template<typename T> R<T> green_on_blue(T t)                { return R<T>(S<T>(std::move(t), hue::GREEN, hue::BLUE)); }
+    template<typename T> R<T> green_on_green(T t)               { return R<T>(S<T>(std::move(t), hue::GREEN, hue::GREEN)); }
+    template<typename T> R<T> green_on_aqua(T t)                { return R<T>(S<T>(std::move(t), hue::GREEN, hue::AQUA)); }
+    template<typename T> R<T> green_on_red(T t)                 { return R<T>(S<T>(std::move(t), hue::GREEN, hue::RED)); }
+    template<typename T> R<T> green_on_purple(T t)              { return R<T>(S<T>(std::move(t), hue::GREEN, hue::PURPLE)); }
+    template<typename T> R<T> green_on_yellow(T t)              { return R<T>(S<T>(std::move(t), hue::GREEN, hue::YELLOW)); }
+    template<typename T> R<T> green_on_white(T t)               { return R<T>(S<T>(std::move(t), hue::GREEN, hue::WHITE)); }
+    template<typename T> R<T> green_on_grey(T t)                { return R<T>(S<T>(std::move(t), hue::GREEN, hue::GREY)); }
+    template<typename T> R<T> green_on_light_blue(T t)          { return R<T>(S<T>(std::move(t), hue::GREEN, hue::LIGHT_BLUE)); }
+    template<typename T> R<T> green_on_light_green(T t)         { return R<T>(S<T>(std::move(t), hue::GREEN, hue::LIGHT_GREEN)); }
+    template<typename T> R<T> green_on_light_aqua(T t)          { return R<T>(S<T>(std::move(t), hue::GREEN, hue::LIGHT_AQUA)); }
+    template<typename T> R<T> green_on_light_red(T t)           { return R<T>(S<T>(std::move(t), hue::GREEN, hue::LIGHT_RED)); }
+    template<typename T> R<T> green_on_light_purple(T t)        { return R<T>(S<T>(std::move(t), hue::GREEN, hue::LIGHT_PURPLE)); }
+    template<typename T> R<T> green_on_light_yellow(T t)        { return R<T>(S<T>(std::move(t), hue::GREEN, hue::LIGHT_YELLOW)); }
+    template<typename T> R<T> green_on_bright_white(T t)        { return R<T>(S<T>(std::move(t), hue::GREEN, hue::BRIGHT_WHITE)); }
+    template<typename T> R<T> aqua_on_black(T t)                { return R<T>(S<T>(std::move(t), hue::AQUA, hue::BLACK)); }
+    template<typename T> R<T> aqua_on_blue(T t)                 { return R<T>(S<T>(std::move(t), hue::AQUA, hue::BLUE)); }
+    template<typename T> R<T> aqua_on_green(T t)                { return R<T>(S<T>(std::move(t), hue::AQUA, hue::GREEN)); }
+    template<typename T> R<T> aqua_on_aqua(T t)                 { return R<T>(S<T>(std::move(t), hue::AQUA, hue::AQUA)); }
+    template<typename T> R<T> aqua_on_red(T t)                  { return R<T>(S<T>(std::move(t), hue::AQUA, hue::RED)); }
+    template<typename T> R<T> aqua_on_purple(T t)               { return R<T>(S<T>(std::move(t), hue::AQUA, hue::PURPLE)); }
+    template<typename T> R<T> aqua_on_yellow(T t)               { return R<T>(S<T>(std::move(t), hue::AQUA, hue::YELLOW)); }
+    template<typename T> R<T> aqua_on_white(T t)                { return R<T>(S<T>(std::move(t), hue::AQUA, hue::WHITE)); }
+    template<typename T> R<T> aqua_on_grey(T t)                 { return R<T>(S<T>(std::move(t), hue::AQUA, hue::GREY)); }
+    template<typename T> R<T> aqua_on_light_blue(T t)           { return R<T>(S<T>(std::move(t), hue::AQUA, hue::LIGHT_BLUE)); }
+    template<typename T> R<T> aqua_on_light_green(T t)          { return R<T>(S<T>(std::move(t), hue::AQUA, hue::LIGHT_GREEN)); }
+    template<typename T> R<T> aqua_on_light_aqua(T t)           { return R<T>(S<T>(std::move(t), hue::AQUA, hue::LIGHT_AQUA)); }
+    template<typename T> R<T> aqua_on_light_red(T t)            { return R<T>(S<T>(std::move(t), hue::AQUA, hue::LIGHT_RED)); }
+    template<typename T> R<T> aqua_on_light_purple(T t)         { return R<T>(S<T>(std::move(t), hue::AQUA, hue::LIGHT_PURPLE)); }
+    template<typename T> R<T> aqua_on_light_yellow(T t)         { return R<T>(S<T>(std::move(t), hue::AQUA, hue::LIGHT_YELLOW)); }
+    template<typename T> R<T> aqua_on_bright_white(T t)         { return R<T>(S<T>(std::move(t), hue::AQUA, hue::BRIGHT_WHITE)); }
+    template<typename T> R<T> red_on_black(T t)                 { return R<T>(S<T>(std::move(t), hue::RED, hue::BLACK)); }
+    template<typename T> R<T> red_on_blue(T t)                  { return R<T>(S<T>(std::move(t), hue::RED, hue::BLUE)); }
+    template<typename T> R<T> red_on_green(T t)                 { return R<T>(S<T>(std::move(t), hue::RED, hue::GREEN)); }
+    template<typename T> R<T> red_on_aqua(T t)                  { return R<T>(S<T>(std::move(t), hue::RED, hue::AQUA)); }
+    template<typename T> R<T> red_on_red(T t)                   { return R<T>(S<T>(std::move(t), hue::RED, hue::RED)); }
+    template<typename T> R<T> red_on_purple(T t)                { return R<T>(S<T>(std::move(t), hue::RED, hue::PURPLE)); }
+    template<typename T> R<T> red_on_yellow(T t)                { return R<T>(S<T>(std::move(t), hue::RED, hue::YELLOW)); }
+    template<typename T> R<T> red_on_white(T t)                 { return R<T>(S<T>(std::move(t), hue::RED, hue::WHITE)); }
+    template<typename T> R<T> red_on_grey(T t)                  { return R<T>(S<T>(std::move(t), hue::RED, hue::GREY)); }
+    template<typename T> R<T> red_on_light_blue(T t)            { return R<T>(S<T>(std::move(t), hue::RED, hue::LIGHT_BLUE)); }
+    template<typename T> R<T> red_on_light_green(T t)           { return R<T>(S<T>(std::move(t), hue::RED, hue::LIGHT_GREEN)); }
+    template<typename T> R<T> red_on_light_aqua(T t)            { return R<T>(S<T>(std::move(t), hue::RED, hue::LIGHT_AQUA)); }
+    template<typename T> R<T> red_on_light_red(T t)             { return R<T>(S<T>(std::move(t), hue::RED, hue::LIGHT_RED)); }
+    template<typename T> R<T> red_on_light_purple(T t)          { return R<T>(S<T>(std::move(t), hue::RED, hue::LIGHT_PURPLE)); }
+    template<typename T> R<T> red_on_light_yellow(T t)          { return R<T>(S<T>(std::move(t), hue::RED, hue::LIGHT_YELLOW)); }
+    template<typename T> R<T> red_on_bright_white(T t)          { return R<T>(S<T>(std::move(t), hue::RED, hue::BRIGHT_WHITE)); }
+    template<typename T> R<T> purple_on_black(T t)              { return R<T>(S<T>(std::move(t), hue::PURPLE, hue::BLACK)); }
+    template<typename T> R<T> purple_on_blue(T t)               { return R<T>(S<T>(std::move(t), hue::PURPLE, hue::BLUE)); }
+    template<typename T> R<T> purple_on_green(T t)              { return R<T>(S<T>(std::move(t), hue::PURPLE, hue::GREEN)); }
+    template<typename T> R<T> purple_on_aqua(T t)               { return R<T>(S<T>(std::move(t), hue::PURPLE, hue::AQUA)); }
+    template<typename T> R<T> purple_on_red(T t)                { return R<T>(S<T>(std::move(t), hue::PURPLE, hue::RED)); }
+    template<typename T> R<T> purple_on_purple(T t)             { return R<T>(S<T>(std::move(t), hue::PURPLE, hue::PURPLE)); }
+    template<typename T> R<T> purple_on_yellow(T t)             { return R<T>(S<T>(std::move(t), hue::PURPLE, hue::YELLOW)); }
+    template<typename T> R<T> purple_on_white(T t)              { return R<T>(S<T>(std::move(t), hue::PURPLE, hue::WHITE)); }
+    template<typename T> R<T> purple_on_grey(T t)               { return R<T>(S<T>(std::move(t), hue::PURPLE, hue::GREY)); }
+    template<typename T> R<T> purple_on_light_blue(T t)         { return R<T>(S<T>(std::move(t), hue::PURPLE, hue::LIGHT_BLUE)); }
+    template<typename T> R<T> purple_on_light_green(T t)        { return R<T>(S<T>(std::move(t), hue::PURPLE, hue::LIGHT_GREEN)); }
+    template<typename T> R<T> purple_on_light_aqua(T t)         { return R<T>(S<T>(std::move(t), hue::PURPLE, hue::LIGHT_AQUA)); }
+    template<typename T> R<T> purple_on_light_red(T t)          { return R<T>(S<T>(std::move(t), hue::PURPLE, hue::LIGHT_RED)); }
+    template<typename T> R<T> purple_on_light_purple(T t)       { return R<T>(S<T>(std::move(t), hue::PURPLE, hue::LIGHT_PURPLE)); }
+    template<typename T> R<T> purple_on_light_yellow(T t)       { return R<T>(S<T>(std::move(t), hue::PURPLE, hue::LIGHT_YELLOW)); }
+    template<typename T> R<T> purple_on_bright_white(T t)       { return R<T>(S<T>(std::move(t), hue::PURPLE, hue::BRIGHT_WHITE)); }
+    template<typename T> R<T> yellow_on_black(T t)              { return R<T>(S<T>(std::move(t), hue::YELLOW, hue::BLACK)); }
+    template<typename T> R<T> yellow_on_blue(T t)               { return R<T>(S<T>(std::move(t), hue::YELLOW, hue::BLUE)); }
+    template<typename T> R<T> yellow_on_green(T t)              { return R<T>(S<T>(std::move(t), hue::YELLOW, hue::GREEN)); }
+    template<typename T> R<T> yellow_on_aqua(T t)               { return R<T>(S<T>(std::move(t), hue::YELLOW, hue::AQUA)); }
+    template<typename T> R<T> yellow_on_red(T t)                { return R<T>(S<T>(std::move(t), hue::YELLOW, hue::RED)); }
+    template<typename T> R<T> yellow_on_purple(T t)             { return R<T>(S<T>(std::move(t), hue::YELLOW, hue::PURPLE)); }
+    template<typename T> R<T> yellow_on_yellow(T t)             { return R<T>(S<T>(std::move(t), hue::YELLOW, hue::YELLOW)); }
+    template<typename T> R<T> yellow_on_white(T t)              { return R<T>(S<T>(std::move(t), hue::YELLOW, hue::WHITE)); }
+    template<typename T> R<T> yellow_on_grey(T t)               { return R<T>(S<T>(std::move(t), hue::YELLOW, hue::GREY)); }
+    template<typename T> R<T> yellow_on_light_blue(T t)         { return R<T>(S<T>(std::move(t), hue::YELLOW, hue::LIGHT_BLUE)); }
+    template<typename T> R<T> yellow_on_light_green(T t)        { return R<T>(S<T>(std::move(t), hue::YELLOW, hue::LIGHT_GREEN)); }
+    template<typename T> R<T> yellow_on_light_aqua(T t)         { return R<T>(S<T>(std::move(t), hue::YELLOW, hue::LIGHT_AQUA)); }
+    template<typename T> R<T> yellow_on_light_red(T t)          { return R<T>(S<T>(std::move(t), hue::YELLOW, hue::LIGHT_RED)); }
+    template<typename T> R<T> yellow_on_light_purple(T t)       { return R<T>(S<T>(std::move(t), hue::YELLOW, hue::LIGHT_PURPLE)); }
+    template<typename T> R<T> yellow_on_light_yellow(T t)       { return R<T>(S<T>(std::move(t), hue::YELLOW, hue::LIGHT_YELLOW)); }
+    template<typename T> R<T> yellow_on_bright_white(T t)       { return R<T>(S<T>(std::move(t), hue::YELLOW, hue::BRIGHT_WHITE)); }
+    template<typename T> R<T> white_on_black(T t)               { return R<T>(S<T>(std::move(t), hue::WHITE, hue::BLACK)); }
+    template<typename T> R<T> white_on_blue(T t)                { return R<T>(S<T>(std::move(t), hue::WHITE, hue::BLUE)); }
+    template<typename T> R<T> white_on_green(T t)               { return R<T>(S<T>(std::move(t), hue::WHITE, hue::GREEN)); }
+    template<typename T> R<T> white_on_aqua(T t)                { return R<T>(S<T>(std::move(t), hue::WHITE, hue::AQUA)); }
+    template<typename T> R<T> white_on_red(T t)                 { return R<T>(S<T>(std::move(t), hue::WHITE, hue::RED)); }
+    template<typename T> R<T> white_on_purple(T t)              { return R<T>(S<T>(std::move(t), hue::WHITE, hue::PURPLE)); }
+    template<typename T> R<T> white_on_yellow(T t)              { return R<T>(S<T>(std::move(t), hue::WHITE, hue::YELLOW)); }
+    template<typename T> R<T> white_on_white(T t)               { return R<T>(S<T>(std::move(t), hue::WHITE, hue::WHITE)); }
+    template<typename T> R<T> white_on_grey(T t)                { return R<T>(S<T>(std::move(t), hue::WHITE, hue::GREY)); }
+    template<typename T> R<T> white_on_light_blue(T t)          { return R<T>(S<T>(std::move(t), hue::WHITE, hue::LIGHT_BLUE)); }
+    template<typename T> R<T> white_on_light_green(T t)         { return R<T>(S<T>(std::move(t), hue::WHITE, hue::LIGHT_GREEN)); }
+    template<typename T> R<T> white_on_light_aqua(T t)          { return R<T>(S<T>(std::move(t), hue::WHITE, hue::LIGHT_AQUA)); }
+    template<typename T> R<T> white_on_light_red(T t)           { return R<T>(S<T>(std::move(t), hue::WHITE, hue::LIGHT_RED)); }
+    template<typename T> R<T> white_on_light_purple(T t)        { return R<T>(S<T>(std::move(t), hue::WHITE, hue::LIGHT_PURPLE)); }
+    template<typename T> R<T> white_on_light_yellow(T t)        { return R<T>(S<T>(std::move(t), hue::WHITE, hue::LIGHT_YELLOW)); }
+    template<typename T> R<T> white_on_bright_white(T t)        { return R<T>(S<T>(std::move(t), hue::WHITE, hue::BRIGHT_WHITE)); }
+    template<typename T> R<T> grey_on_black(T t)                { return R<T>(S<T>(std::move(t), hue::GREY, hue::BLACK)); }
+    template<typename T> R<T> grey_on_blue(T t)                 { return R<T>(S<T>(std::move(t), hue::GREY, hue::BLUE)); }
+    template<typename T> R<T> grey_on_green(T t)                { return R<T>(S<T>(std::move(t), hue::GREY, hue::GREEN)); }
+    template<typename T> R<T> grey_on_aqua(T t)                 { return R<T>(S<T>(std::move(t), hue::GREY, hue::AQUA)); }
+    template<typename T> R<T> grey_on_red(T t)                  { return R<T>(S<T>(std::move(t), hue::GREY, hue::RED)); }
+    template<typename T> R<T> grey_on_purple(T t)               { return R<T>(S<T>(std::move(t), hue::GREY, hue::PURPLE)); }
+    template<typename T> R<T> grey_on_yellow(T t)               { return R<T>(S<T>(std::move(t), hue::GREY, hue::YELLOW)); }
+    template<typename T> R<T> grey_on_white(T t)                { return R<T>(S<T>(std::move(t), hue::GREY, hue::WHITE)); }
+    template<typename T> R<T> grey_on_grey(T t)                 { return R<T>(S<T>(std::move(t), hue::GREY, hue::GREY)); }
+    template<typename T> R<T> grey_on_light_blue(T t)           { return R<T>(S<T>(std::move(t), hue::GREY, hue::LIGHT_BLUE)); }
+    template<typename T> R<T> grey_on_light_green(T t)          { return R<T>(S<T>(std::move(t), hue::GREY, hue::LIGHT_GREEN)); }
+    template<typename T> R<T> grey_on_light_aqua(T t)           { return R<T>(S<T>(std::move(t), hue::GREY, hue::LIGHT_AQUA)); }
+    template<typename T> R<T> grey_on_light_red(T t)            { return R<T>(S<T>(std::move(t), hue::GREY, hue::LIGHT_RED)); }
+    template<typename T> R<T> grey_on_light_purple(T t)         { return R<T>(S<T>(std::move(t), hue::GREY, hue::LIGHT_PURPLE)); }
+    template<typename T> R<T> grey_on_light_yellow(T t)         { return R<T>(S<T>(std::move(t), hue::GREY, hue::LIGHT_YELLOW)); }
+    template<typename T> R<T> grey_on_bright_white(T t)         { return R<T>(S<T>(std::move(t), hue::GREY, hue::BRIGHT_WHITE)); }
+    template<typename T> R<T> light_blue_on_black(T t)          { return R<T>(S<T>(std::move(t), hue::LIGHT_BLUE, hue::BLACK)); }
+    template<typename T> R<T> light_blue_on_blue(T t)           { return R<T>(S<T>(std::move(t), hue::LIGHT_BLUE, hue::BLUE)); }
+    template<typename T> R<T> light_blue_on_green(T t)          { return R<T>(S<T>(std::move(t), hue::LIGHT_BLUE, hue::GREEN)); }
+    template<typename T> R<T> light_blue_on_aqua(T t)           { return R<T>(S<T>(std::move(t), hue::LIGHT_BLUE, hue::AQUA)); }
+    template<typename T> R<T> light_blue_on_red(T t)            { return R<T>(S<T>(std::move(t), hue::LIGHT_BLUE, hue::RED)); }
+    template<typename T> R<T> light_blue_on_purple(T t)         { return R<T>(S<T>(std::move(t), hue::LIGHT_BLUE, hue::PURPLE)); }
+    template<typename T> R<T> light_blue_on_yellow(T t)         { return R<T>(S<T>(std::move(t), hue::LIGHT_BLUE, hue::YELLOW)); }
+    template<typename T> R<T> light_blue_on_white(T t)          { return R<T>(S<T>(std::move(t), hue::LIGHT_BLUE, hue::WHITE)); }
+    template<typename T> R<T> light_blue_on_grey(T t)           { return R<T>(S<T>(std::move(t), hue::LIGHT_BLUE, hue::GREY)); }
+    template<typename T> R<T> light_blue_on_light_blue(T t)     { return R<T>(S<T>(std::move(t), hue::LIGHT_BLUE, hue::LIGHT_BLUE)); }
+    template<typename T> R<T> light_blue_on_light_green(T t)    { return R<T>(S<T>(std::move(t), hue::LIGHT_BLUE, hue::LIGHT_GREEN)); }
+    template<typename T> R<T> light_blue_on_light_aqua(T t)     { return R<T>(S<T>(std::move(t), hue::LIGHT_BLUE, hue::LIGHT_AQUA)); }
+    template<typename T> R<T> light_blue_on_light_red(T t)      { return R<T>(S<T>(std::move(t), hue::LIGHT_BLUE, hue::LIGHT_RED)); }
+    template<typename T> R<T> light_blue_on_light_purple(T t)   { return R<T>(S<T>(std::move(t), hue::LIGHT_BLUE, hue::LIGHT_PURPLE)); }
+    template<typename T> R<T> light_blue_on_light_yellow(T t)   { return R<T>(S<T>(std::move(t), hue::LIGHT_BLUE, hue::LIGHT_YELLOW)); }
+    template<typename T> R<T> light_blue_on_bright_white(T t)   { return R<T>(S<T>(std::move(t), hue::LIGHT_BLUE, hue::BRIGHT_WHITE)); }
+    template<typename T> R<T> light_green_on_black(T t)         { return R<T>(S<T>(std::move(t), hue::LIGHT_GREEN, hue::BLACK)); }
+    template<typename T> R<T> light_green_on_blue(T t)          { return R<T>(S<T>(std::move(t), hue::LIGHT_GREEN, hue::BLUE)); }
+    template<typename T> R<T> light_green_on_green(T t)         { return R<T>(S<T>(std::move(t), hue::LIGHT_GREEN, hue::GREEN)); }
+    template<typename T> R<T> light_green_on_aqua(T t)          { return R<T>(S<T>(std::move(t), hue::LIGHT_GREEN, hue::AQUA)); }
+    template<typename T> R<T> light_green_on_red(T t)           { return R<T>(S<T>(std::move(t), hue::LIGHT_GREEN, hue::RED)); }
+    template<typename T> R<T> light_green_on_purple(T t)        { return R<T>(S<T>(std::move(t), hue::LIGHT_GREEN, hue::PURPLE)); }
+    template<typename T> R<T> light_green_on_yellow(T t)        { return R<T>(S<T>(std::move(t), hue::LIGHT_GREEN, hue::YELLOW)); }
+    template<typename T> R<T> light_green_on_white(T t)         { return R<T>(S<T>(std::move(t), hue::LIGHT_GREEN, hue::WHITE)); }
+    template<typename T> R<T> light_green_on_grey(T t)          { return R<T>(S<T>(std::move(t), hue::LIGHT_GREEN, hue::GREY)); }
+    template<typename T> R<T> light_green_on_light_blue(T t)    { return R<T>(S<T>(std::move(t), hue::LIGHT_GREEN, hue::LIGHT_BLUE)); }
+    template<typename T> R<T> light_green_on_light_green(T t)   { return R<T>(S<T>(std::move(t), hue::LIGHT_GREEN, hue::LIGHT_GREEN)); }
+    template<typename T> R<T> light_green_on_light_aqua(T t)    { return R<T>(S<T>(std::move(t), hue::LIGHT_GREEN, hue::LIGHT_AQUA)); }
+    template<typename T> R<T> light_green_on_light_red(T t)     { return R<T>(S<T>(std::move(t), hue::LIGHT_GREEN, hue::LIGHT_RED)); }
+    template<typename T> R<T> light_green_on_light_purple(T t)  { return R<T>(S<T>(std::move(t), hue::LIGHT_GREEN, hue::LIGHT_PURPLE)); }
+    template<typename T> R<T> light_green_on_light_yellow(T t)  { return R<T>(S<T>(std::move(t), hue::LIGHT_GREEN, hue::LIGHT_YELLOW)); }
+    template<typename T> R<T> light_green_on_bright_white(T t)  { return R<T>(S<T>(std::move(t), hue::LIGHT_GREEN, hue::BRIGHT_WHITE)); }
+    template<typename T> R<T> light_aqua_on_black(T t)          { return R<T>(S<T>(std::move(t), hue::LIGHT_AQUA, hue::BLACK)); }
+    template<typename T> R<T> light_aqua_on_blue(T t)           { return R<T>(S<T>(std::move(t), hue::LIGHT_AQUA, hue::BLUE)); }
+    template<typename T> R<T> light_aqua_on_green(T t)          { return R<T>(S<T>(std::move(t), hue::LIGHT_AQUA, hue::GREEN)); }
+    template<typename T> R<T> light_aqua_on_aqua(T t)           { return R<T>(S<T>(std::move(t), hue::LIGHT_AQUA, hue::AQUA)); }
+    template<typename T> R<T> light_aqua_on_red(T t)            { return R<T>(S<T>(std::move(t), hue::LIGHT_AQUA, hue::RED)); }
+    template<typename T> R<T> light_aqua_on_purple(T t)         { return R<T>(S<T>(std::move(t), hue::LIGHT_AQUA, hue::PURPLE)); }
+    template<typename T> R<T> light_aqua_on_yellow(T t)         { return R<T>(S<T>(std::move(t), hue::LIGHT_AQUA, hue::YELLOW)); }
+    template<typename T> R<T> light_aqua_on_white(T t)          { return R<T>(S<T>(std::move(t), hue::LIGHT_AQUA, hue::WHITE)); }
+    template<typename T> R<T> light_aqua_on_grey(T t)           { return R<T>(S<T>(std::move(t), hue::LIGHT_AQUA, hue::GREY)); }
+    template<typename T> R<T> light_aqua_on_light_blue(T t)     { return R<T>(S<T>(std::move(t), hue::LIGHT_AQUA, hue::LIGHT_BLUE)); }
+    template<typename T> R<T> light_aqua_on_light_green(T t)    { return R<T>(S<T>(std::move(t), hue::LIGHT_AQUA, hue::LIGHT_GREEN)); }
+    template<typename T> R<T> light_aqua_on_light_aqua(T t)     { return R<T>(S<T>(std::move(t), hue::LIGHT_AQUA, hue::LIGHT_AQUA)); }
+    template<typename T> R<T> light_aqua_on_light_red(T t)      { return R<T>(S<T>(std::move(t), hue::LIGHT_AQUA, hue::LIGHT_RED)); }
+    template<typename T> R<T> light_aqua_on_light_purple(T t)   { return R<T>(S<T>(std::move(t), hue::LIGHT_AQUA, hue::LIGHT_PURPLE)); }
+    template<typename T> R<T> light_aqua_on_light_yellow(T t)   { return R<T>(S<T>(std::move(t), hue::LIGHT_AQUA, hue::LIGHT_YELLOW)); }
+    template<typename T> R<T> light_aqua_on_bright_white(T t)   { return R<T>(S<T>(std::move(t), hue::LIGHT_AQUA, hue::BRIGHT_WHITE)); }
+    template<typename T> R<T> light_red_on_black(T t)           { return R<T>(S<T>(std::move(t), hue::LIGHT_RED, hue::BLACK)); }
+    template<typename T> R<T> light_red_on_blue(T t)            { return R<T>(S<T>(std::move(t), hue::LIGHT_RED, hue::BLUE)); }
+    template<typename T> R<T> light_red_on_green(T t)           { return R<T>(S<T>(std::move(t), hue::LIGHT_RED, hue::GREEN)); }
+    template<typename T> R<T> light_red_on_aqua(T t)            { return R<T>(S<T>(std::move(t), hue::LIGHT_RED, hue::AQUA)); }
+    template<typename T> R<T> light_red_on_red(T t)             { return R<T>(S<T>(std::move(t), hue::LIGHT_RED, hue::RED)); }
+    template<typename T> R<T> light_red_on_purple(T t)          { return R<T>(S<T>(std::move(t), hue::LIGHT_RED, hue::PURPLE)); }
+    template<typename T> R<T> light_red_on_yellow(T t)          { return R<T>(S<T>(std::move(t), hue::LIGHT_RED, hue::YELLOW)); }
+    template<typename T> R<T> light_red_on_white(T t)           { return R<T>(S<T>(std::move(t), hue::LIGHT_RED, hue::WHITE)); }
+    template<typename T> R<T> light_red_on_grey(T t)            { return R<T>(S<T>(std::move(t), hue::LIGHT_RED, hue::GREY)); }
+    template<typename T> R<T> light_red_on_light_blue(T t)      { return R<T>(S<T>(std::move(t), hue::LIGHT_RED, hue::LIGHT_BLUE)); }
+    template<typename T> R<T> light_red_on_light_green(T t)     { return R<T>(S<T>(std::move(t), hue::LIGHT_RED, hue::LIGHT_GREEN)); }
+    template<typename T> R<T> light_red_on_light_aqua(T t)      { return R<T>(S<T>(std::move(t), hue::LIGHT_RED, hue::LIGHT_AQUA)); }
+    template<typename T> R<T> light_red_on_light_red(T t)       { return R<T>(S<T>(std::move(t), hue::LIGHT_RED, hue::LIGHT_RED)); }
+    template<typename T> R<T> light_red_on_light_purple(T t)    { return R<T>(S<T>(std::move(t), hue::LIGHT_RED, hue::LIGHT_PURPLE)); }
+    template<typename T> R<T> light_red_on_light_yellow(T t)    { return R<T>(S<T>(std::move(t), hue::LIGHT_RED, hue::LIGHT_YELLOW)); }
+    template<typename T> R<T> light_red_on_bright_white(T t)    { return R<T>(S<T>(std::move(t), hue::LIGHT_RED, hue::BRIGHT_WHITE)); }
+    template<typename T> R<T> light_purple_on_black(T t)        { return R<T>(S<T>(std::move(t), hue::LIGHT_PURPLE, hue::BLACK)); }
+    template<typename T> R<T> light_purple_on_blue(T t)         { return R<T>(S<T>(std::move(t), hue::LIGHT_PURPLE, hue::BLUE)); }
+    template<typename T> R<T> light_purple_on_green(T t)        { return R<T>(S<T>(std::move(t), hue::LIGHT_PURPLE, hue::GREEN)); }
+    template<typename T> R<T> light_purple_on_aqua(T t)         { return R<T>(S<T>(std::move(t), hue::LIGHT_PURPLE, hue::AQUA)); }
+    template<typename T> R<T> light_purple_on_red(T t)          { return R<T>(S<T>(std::move(t), hue::LIGHT_PURPLE, hue::RED)); }
+    template<typename T> R<T> light_purple_on_purple(T t)       { return R<T>(S<T>(std::move(t), hue::LIGHT_PURPLE, hue::PURPLE)); }
+    template<typename T> R<T> light_purple_on_yellow(T t)       { return R<T>(S<T>(std::move(t), hue::LIGHT_PURPLE, hue::YELLOW)); }
+    template<typename T> R<T> light_purple_on_white(T t)        { return R<T>(S<T>(std::move(t), hue::LIGHT_PURPLE, hue::WHITE)); }
+    template<typename T> R<T> light_purple_on_grey(T t)         { return R<T>(S<T>(std::move(t), hue::LIGHT_PURPLE, hue::GREY)); }
+    template<typename T> R<T> light_purple_on_light_blue(T t)   { return R<T>(S<T>(std::move(t), hue::LIGHT_PURPLE, hue::LIGHT_BLUE)); }
+    template<typename T> R<T> light_purple_on_light_green(T t)  { return R<T>(S<T>(std::move(t), hue::LIGHT_PURPLE, hue::LIGHT_GREEN)); }
+    template<typename T> R<T> light_purple_on_light_aqua(T t)   { return R<T>(S<T>(std::move(t), hue::LIGHT_PURPLE, hue::LIGHT_AQUA)); }
+    template<typename T> R<T> light_purple_on_light_red(T t)    { return R<T>(S<T>(std::move(t), hue::LIGHT_PURPLE, hue::LIGHT_RED)); }
+    template<typename T> R<T> light_purple_on_light_purple(T t) { return R<T>(S<T>(std::move(t), hue::LIGHT_PURPLE, hue::LIGHT_PURPLE)); }
+    template<typename T> R<T> light_purple_on_light_yellow(T t) { return R<T>(S<T>(std::move(t), hue::LIGHT_PURPLE, hue::LIGHT_YELLOW)); }
+    template<typename T> R<T> light_purple_on_bright_white(T t) { return R<T>(S<T>(std::move(t), hue::LIGHT_PURPLE, hue::BRIGHT_WHITE)); }
+    template<typename T> R<T> light_yellow_on_black(T t)        { return R<T>(S<T>(std::move(t), hue::LIGHT_YELLOW, hue::BLACK)); }
+    template<typename T> R<T> light_yellow_on_blue(T t)         { return R<T>(S<T>(std::move(t), hue::LIGHT_YELLOW, hue::BLUE)); }
+    template<typename T> R<T> light_yellow_on_green(T t)        { return R<T>(S<T>(std::move(t), hue::LIGHT_YELLOW, hue::GREEN)); }
+    template<typename T> R<T> light_yellow_on_aqua(T t)         { return R<T>(S<T>(std::move(t), hue::LIGHT_YELLOW, hue::AQUA)); }
+    template<typename T> R<T> light_yellow_on_red(T t)          { return R<T>(S<T>(std::move(t), hue::LIGHT_YELLOW, hue::RED)); }
+    template<typename T> R<T> light_yellow_on_purple(T t)       { return R<T>(S<T>(std::move(t), hue::LIGHT_YELLOW, hue::PURPLE)); }
+    template<typename T> R<T> light_yellow_on_yellow(T t)       { return R<T>(S<T>(std::move(t), hue::LIGHT_YELLOW, hue::YELLOW)); }
+    template<typename T> R<T> light_yellow_on_white(T t)        { return R<T>(S<T>(std::move(t), hue::LIGHT_YELLOW, hue::WHITE)); }
+    template<typename T> R<T> light_yellow_on_grey(T t)         { return R<T>(S<T>(std::move(t), hue::LIGHT_YELLOW, hue::GREY)); }
+    template<typename T> R<T> light_yellow_on_light_blue(T t)   { return R<T>(S<T>(std::move(t), hue::LIGHT_YELLOW, hue::LIGHT_BLUE)); }
+    template<typename T> R<T> light_yellow_on_light_green(T t)  { return R<T>(S<T>(std::move(t), hue::LIGHT_YELLOW, hue::LIGHT_GREEN)); }
+    template<typename T> R<T> light_yellow_on_light_aqua(T t)   { return R<T>(S<T>(std::move(t), hue::LIGHT_YELLOW, hue::LIGHT_AQUA)); }
+    template<typename T> R<T> light_yellow_on_light_red(T t)    { return R<T>(S<T>(std::move(t), hue::LIGHT_YELLOW, hue::LIGHT_RED)); }
+    template<typename T> R<T> light_yellow_on_light_purple(T t) { return R<T>(S<T>(std::move(t), hue::LIGHT_YELLOW, hue::LIGHT_PURPLE)); }
+    template<typename T> R<T> light_yellow_on_light_yellow(T t) { return R<T>(S<T>(std::move(t), hue::LIGHT_YELLOW, hue::LIGHT_YELLOW)); }
+    template<typename T> R<T> light_yellow_on_bright_white(T t) { return R<T>(S<T>(std::move(t), hue::LIGHT_YELLOW, hue::BRIGHT_WHITE)); }
+    template<typename T> R<T> bright_white_on_black(T t)        { return R<T>(S<T>(std::move(t), hue::BRIGHT_WHITE, hue::BLACK)); }
+    template<typename T> R<T> bright_white_on_blue(T t)         { return R<T>(S<T>(std::move(t), hue::BRIGHT_WHITE, hue::BLUE)); }
+    template<typename T> R<T> bright_white_on_green(T t)        { return R<T>(S<T>(std::move(t), hue::BRIGHT_WHITE, hue::GREEN)); }
+    template<typename T> R<T> bright_white_on_aqua(T t)         { return R<T>(S<T>(std::move(t), hue::BRIGHT_WHITE, hue::AQUA)); }
+    template<typename T> R<T> bright_white_on_red(T t)          { return R<T>(S<T>(std::move(t), hue::BRIGHT_WHITE, hue::RED)); }
+    template<typename T> R<T> bright_white_on_purple(T t)       { return R<T>(S<T>(std::move(t), hue::BRIGHT_WHITE, hue::PURPLE)); }
+    template<typename T> R<T> bright_white_on_yellow(T t)       { return R<T>(S<T>(std::move(t), hue::BRIGHT_WHITE, hue::YELLOW)); }
+    template<typename T> R<T> bright_white_on_white(T t)        { return R<T>(S<T>(std::move(t), hue::BRIGHT_WHITE, hue::WHITE)); }
+    template<typename T> R<T> bright_white_on_grey(T t)         { return R<T>(S<T>(std::move(t), hue::BRIGHT_WHITE, hue::GREY)); }
+    template<typename T> R<T> bright_white_on_light_blue(T t)   { return R<T>(S<T>(std::move(t), hue::BRIGHT_WHITE, hue::LIGHT_BLUE)); }
+    template<typename T> R<T> bright_white_on_light_green(T t)  { return R<T>(S<T>(std::move(t), hue::BRIGHT_WHITE, hue::LIGHT_GREEN)); }
+    template<typename T> R<T> bright_white_on_light_aqua(T t)   { return R<T>(S<T>(std::move(t), hue::BRIGHT_WHITE, hue::LIGHT_AQUA)); }
+    template<typename T> R<T> bright_white_on_light_red(T t)    { return R<T>(S<T>(std::move(t), hue::BRIGHT_WHITE, hue::LIGHT_RED)); }
+    template<typename T> R<T> bright_white_on_light_purple(T t) { return R<T>(S<T>(std::move(t), hue::BRIGHT_WHITE, hue::LIGHT_PURPLE)); }
+    template<typename T> R<T> bright_white_on_light_yellow(T t) { return R<T>(S<T>(std::move(t), hue::BRIGHT_WHITE, hue::LIGHT_YELLOW)); }
+    template<typename T> R<T> bright_white_on_bright_white(T t) { return R<T>(S<T>(std::move(t), hue::BRIGHT_WHITE, hue::BRIGHT_WHITE)); }
 
-    template<typename T> R<T> colorize(T t, std::string a)      { return R<T> { S<T>(t, a) }; }
-    template<typename T> R<T> vanilla(T t)                      { return R<T> { S<T>(t) }; }
-    template<typename T> R<T> black(T t)                        { return R<T> { S<T>(t, "k") }; }
-    template<typename T> R<T> blue(T t)                         { return R<T> { S<T>(t, "b") }; }
-    template<typename T> R<T> green(T t)                        { return R<T> { S<T>(t, "g") }; }
-    template<typename T> R<T> aqua(T t)                         { return R<T> { S<T>(t, "a") }; }
-    template<typename T> R<T> red(T t)                          { return R<T> { S<T>(t, "r") }; }
-    template<typename T> R<T> purple(T t)                       { return R<T> { S<T>(t, "p") }; }
-    template<typename T> R<T> yellow(T t)                       { return R<T> { S<T>(t, "y") }; }
-    template<typename T> R<T> white(T t)                        { return R<T> { S<T>(t, "w") }; }
-    template<typename T> R<T> grey(T t)                         { return R<T> { S<T>(t, "e") }; }
-    template<typename T> R<T> light_blue(T t)                   { return R<T> { S<T>(t, "lb") }; }
-    template<typename T> R<T> light_green(T t)                  { return R<T> { S<T>(t, "lg") }; }
-    template<typename T> R<T> light_aqua(T t)                   { return R<T> { S<T>(t, "la") }; }
-    template<typename T> R<T> light_red(T t)                    { return R<T> { S<T>(t, "lr") }; }
-    template<typename T> R<T> light_purple(T t)                 { return R<T> { S<T>(t, "lp") }; }
-    template<typename T> R<T> light_yellow(T t)                 { return R<T> { S<T>(t, "ly") }; }
-    template<typename T> R<T> bright_white(T t)                 { return R<T> { S<T>(t, "bw") }; }
-    template<typename T> R<T> on_black(T t)                     { return R<T> { S<T>(t, "k", "k") }; }
-    template<typename T> R<T> on_blue(T t)                      { return R<T> { S<T>(t, "k", "b") }; }
-    template<typename T> R<T> on_green(T t)                     { return R<T> { S<T>(t, "k", "g") }; }
-    template<typename T> R<T> on_aqua(T t)                      { return R<T> { S<T>(t, "k", "a") }; }
-    template<typename T> R<T> on_red(T t)                       { return R<T> { S<T>(t, "k", "r") }; }
-    template<typename T> R<T> on_purple(T t)                    { return R<T> { S<T>(t, "k", "p") }; }
-    template<typename T> R<T> on_yellow(T t)                    { return R<T> { S<T>(t, "k", "y") }; }
-    template<typename T> R<T> on_white(T t)                     { return R<T> { S<T>(t, "k", "w") }; }
-    template<typename T> R<T> on_grey(T t)                      { return R<T> { S<T>(t, "k", "e") }; }
-    template<typename T> R<T> on_light_blue(T t)                { return R<T> { S<T>(t, "k", "lb") }; }
-    template<typename T> R<T> on_light_green(T t)               { return R<T> { S<T>(t, "k", "lg") }; }
-    template<typename T> R<T> on_light_aqua(T t)                { return R<T> { S<T>(t, "k", "la") }; }
-    template<typename T> R<T> on_light_red(T t)                 { return R<T> { S<T>(t, "k", "lr") }; }
-    template<typename T> R<T> on_light_purple(T t)              { return R<T> { S<T>(t, "k", "lp") }; }
-    template<typename T> R<T> on_light_yellow(T t)              { return R<T> { S<T>(t, "k", "ly") }; }
-    template<typename T> R<T> on_bright_white(T t)              { return R<T> { S<T>(t, "k", "bw") }; }
-    template<typename T> R<T> black_on_black(T t)               { return R<T> { S<T>(t, "k", "k") }; }
-    template<typename T> R<T> black_on_blue(T t)                { return R<T> { S<T>(t, "k", "b") }; }
-    template<typename T> R<T> black_on_green(T t)               { return R<T> { S<T>(t, "k", "g") }; }
-    template<typename T> R<T> black_on_aqua(T t)                { return R<T> { S<T>(t, "k", "a") }; }
-    template<typename T> R<T> black_on_red(T t)                 { return R<T> { S<T>(t, "k", "r") }; }
-    template<typename T> R<T> black_on_purple(T t)              { return R<T> { S<T>(t, "k", "p") }; }
-    template<typename T> R<T> black_on_yellow(T t)              { return R<T> { S<T>(t, "k", "y") }; }
-    template<typename T> R<T> black_on_white(T t)               { return R<T> { S<T>(t, "k", "w") }; }
-    template<typename T> R<T> black_on_grey(T t)                { return R<T> { S<T>(t, "k", "e") }; }
-    template<typename T> R<T> black_on_light_blue(T t)          { return R<T> { S<T>(t, "k", "lb") }; }
-    template<typename T> R<T> black_on_light_green(T t)         { return R<T> { S<T>(t, "k", "lg") }; }
-    template<typename T> R<T> black_on_light_aqua(T t)          { return R<T> { S<T>(t, "k", "la") }; }
-    template<typename T> R<T> black_on_light_red(T t)           { return R<T> { S<T>(t, "k", "lr") }; }
-    template<typename T> R<T> black_on_light_purple(T t)        { return R<T> { S<T>(t, "k", "lp") }; }
-    template<typename T> R<T> black_on_light_yellow(T t)        { return R<T> { S<T>(t, "k", "ly") }; }
-    template<typename T> R<T> black_on_bright_white(T t)        { return R<T> { S<T>(t, "k", "bw") }; }
-    template<typename T> R<T> blue_on_black(T t)                { return R<T> { S<T>(t, "b", "k") }; }
-    template<typename T> R<T> blue_on_blue(T t)                 { return R<T> { S<T>(t, "b", "b") }; }
-    template<typename T> R<T> blue_on_green(T t)                { return R<T> { S<T>(t, "b", "g") }; }
-    template<typename T> R<T> blue_on_aqua(T t)                 { return R<T> { S<T>(t, "b", "a") }; }
-    template<typename T> R<T> blue_on_red(T t)                  { return R<T> { S<T>(t, "b", "r") }; }
-    template<typename T> R<T> blue_on_purple(T t)               { return R<T> { S<T>(t, "b", "p") }; }
-    template<typename T> R<T> blue_on_yellow(T t)               { return R<T> { S<T>(t, "b", "y") }; }
-    template<typename T> R<T> blue_on_white(T t)                { return R<T> { S<T>(t, "b", "w") }; }
-    template<typename T> R<T> blue_on_grey(T t)                 { return R<T> { S<T>(t, "b", "e") }; }
-    template<typename T> R<T> blue_on_light_blue(T t)           { return R<T> { S<T>(t, "b", "lb") }; }
-    template<typename T> R<T> blue_on_light_green(T t)          { return R<T> { S<T>(t, "b", "lg") }; }
-    template<typename T> R<T> blue_on_light_aqua(T t)           { return R<T> { S<T>(t, "b", "la") }; }
-    template<typename T> R<T> blue_on_light_red(T t)            { return R<T> { S<T>(t, "b", "lr") }; }
-    template<typename T> R<T> blue_on_light_purple(T t)         { return R<T> { S<T>(t, "b", "lp") }; }
-    template<typename T> R<T> blue_on_light_yellow(T t)         { return R<T> { S<T>(t, "b", "ly") }; }
-    template<typename T> R<T> blue_on_bright_white(T t)         { return R<T> { S<T>(t, "b", "bw") }; }
-    template<typename T> R<T> green_on_black(T t)               { return R<T> { S<T>(t, "g", "k") }; }
-    template<typename T> R<T> green_on_blue(T t)                { return R<T> { S<T>(t, "g", "b") }; }
-    template<typename T> R<T> green_on_green(T t)               { return R<T> { S<T>(t, "g", "g") }; }
-    template<typename T> R<T> green_on_aqua(T t)                { return R<T> { S<T>(t, "g", "a") }; }
-    template<typename T> R<T> green_on_red(T t)                 { return R<T> { S<T>(t, "g", "r") }; }
-    template<typename T> R<T> green_on_purple(T t)              { return R<T> { S<T>(t, "g", "p") }; }
-    template<typename T> R<T> green_on_yellow(T t)              { return R<T> { S<T>(t, "g", "y") }; }
-    template<typename T> R<T> green_on_white(T t)               { return R<T> { S<T>(t, "g", "w") }; }
-    template<typename T> R<T> green_on_grey(T t)                { return R<T> { S<T>(t, "g", "e") }; }
-    template<typename T> R<T> green_on_light_blue(T t)          { return R<T> { S<T>(t, "g", "lb") }; }
-    template<typename T> R<T> green_on_light_green(T t)         { return R<T> { S<T>(t, "g", "lg") }; }
-    template<typename T> R<T> green_on_light_aqua(T t)          { return R<T> { S<T>(t, "g", "la") }; }
-    template<typename T> R<T> green_on_light_red(T t)           { return R<T> { S<T>(t, "g", "lr") }; }
-    template<typename T> R<T> green_on_light_purple(T t)        { return R<T> { S<T>(t, "g", "lp") }; }
-    template<typename T> R<T> green_on_light_yellow(T t)        { return R<T> { S<T>(t, "g", "ly") }; }
-    template<typename T> R<T> green_on_bright_white(T t)        { return R<T> { S<T>(t, "g", "bw") }; }
-    template<typename T> R<T> aqua_on_black(T t)                { return R<T> { S<T>(t, "a", "k") }; }
-    template<typename T> R<T> aqua_on_blue(T t)                 { return R<T> { S<T>(t, "a", "b") }; }
-    template<typename T> R<T> aqua_on_green(T t)                { return R<T> { S<T>(t, "a", "g") }; }
-    template<typename T> R<T> aqua_on_aqua(T t)                 { return R<T> { S<T>(t, "a", "a") }; }
-    template<typename T> R<T> aqua_on_red(T t)                  { return R<T> { S<T>(t, "a", "r") }; }
-    template<typename T> R<T> aqua_on_purple(T t)               { return R<T> { S<T>(t, "a", "p") }; }
-    template<typename T> R<T> aqua_on_yellow(T t)               { return R<T> { S<T>(t, "a", "y") }; }
-    template<typename T> R<T> aqua_on_white(T t)                { return R<T> { S<T>(t, "a", "w") }; }
-    template<typename T> R<T> aqua_on_grey(T t)                 { return R<T> { S<T>(t, "a", "e") }; }
-    template<typename T> R<T> aqua_on_light_blue(T t)           { return R<T> { S<T>(t, "a", "lb") }; }
-    template<typename T> R<T> aqua_on_light_green(T t)          { return R<T> { S<T>(t, "a", "lg") }; }
-    template<typename T> R<T> aqua_on_light_aqua(T t)           { return R<T> { S<T>(t, "a", "la") }; }
-    template<typename T> R<T> aqua_on_light_red(T t)            { return R<T> { S<T>(t, "a", "lr") }; }
-    template<typename T> R<T> aqua_on_light_purple(T t)         { return R<T> { S<T>(t, "a", "lp") }; }
-    template<typename T> R<T> aqua_on_light_yellow(T t)         { return R<T> { S<T>(t, "a", "ly") }; }
-    template<typename T> R<T> aqua_on_bright_white(T t)         { return R<T> { S<T>(t, "a", "bw") }; }
-    template<typename T> R<T> red_on_black(T t)                 { return R<T> { S<T>(t, "r", "k") }; }
-    template<typename T> R<T> red_on_blue(T t)                  { return R<T> { S<T>(t, "r", "b") }; }
-    template<typename T> R<T> red_on_green(T t)                 { return R<T> { S<T>(t, "r", "g") }; }
-    template<typename T> R<T> red_on_aqua(T t)                  { return R<T> { S<T>(t, "r", "a") }; }
-    template<typename T> R<T> red_on_red(T t)                   { return R<T> { S<T>(t, "r", "r") }; }
-    template<typename T> R<T> red_on_purple(T t)                { return R<T> { S<T>(t, "r", "p") }; }
-    template<typename T> R<T> red_on_yellow(T t)                { return R<T> { S<T>(t, "r", "y") }; }
-    template<typename T> R<T> red_on_white(T t)                 { return R<T> { S<T>(t, "r", "w") }; }
-    template<typename T> R<T> red_on_grey(T t)                  { return R<T> { S<T>(t, "r", "e") }; }
-    template<typename T> R<T> red_on_light_blue(T t)            { return R<T> { S<T>(t, "r", "lb") }; }
-    template<typename T> R<T> red_on_light_green(T t)           { return R<T> { S<T>(t, "r", "lg") }; }
-    template<typename T> R<T> red_on_light_aqua(T t)            { return R<T> { S<T>(t, "r", "la") }; }
-    template<typename T> R<T> red_on_light_red(T t)             { return R<T> { S<T>(t, "r", "lr") }; }
-    template<typename T> R<T> red_on_light_purple(T t)          { return R<T> { S<T>(t, "r", "lp") }; }
-    template<typename T> R<T> red_on_light_yellow(T t)          { return R<T> { S<T>(t, "r", "ly") }; }
-    template<typename T> R<T> red_on_bright_white(T t)          { return R<T> { S<T>(t, "r", "bw") }; }
-    template<typename T> R<T> purple_on_black(T t)              { return R<T> { S<T>(t, "p", "k") }; }
-    template<typename T> R<T> purple_on_blue(T t)               { return R<T> { S<T>(t, "p", "b") }; }
-    template<typename T> R<T> purple_on_green(T t)              { return R<T> { S<T>(t, "p", "g") }; }
-    template<typename T> R<T> purple_on_aqua(T t)               { return R<T> { S<T>(t, "p", "a") }; }
-    template<typename T> R<T> purple_on_red(T t)                { return R<T> { S<T>(t, "p", "r") }; }
-    template<typename T> R<T> purple_on_purple(T t)             { return R<T> { S<T>(t, "p", "p") }; }
-    template<typename T> R<T> purple_on_yellow(T t)             { return R<T> { S<T>(t, "p", "y") }; }
-    template<typename T> R<T> purple_on_white(T t)              { return R<T> { S<T>(t, "p", "w") }; }
-    template<typename T> R<T> purple_on_grey(T t)               { return R<T> { S<T>(t, "p", "e") }; }
-    template<typename T> R<T> purple_on_light_blue(T t)         { return R<T> { S<T>(t, "p", "lb") }; }
-    template<typename T> R<T> purple_on_light_green(T t)        { return R<T> { S<T>(t, "p", "lg") }; }
-    template<typename T> R<T> purple_on_light_aqua(T t)         { return R<T> { S<T>(t, "p", "la") }; }
-    template<typename T> R<T> purple_on_light_red(T t)          { return R<T> { S<T>(t, "p", "lr") }; }
-    template<typename T> R<T> purple_on_light_purple(T t)       { return R<T> { S<T>(t, "p", "lp") }; }
-    template<typename T> R<T> purple_on_light_yellow(T t)       { return R<T> { S<T>(t, "p", "ly") }; }
-    template<typename T> R<T> purple_on_bright_white(T t)       { return R<T> { S<T>(t, "p", "bw") }; }
-    template<typename T> R<T> yellow_on_black(T t)              { return R<T> { S<T>(t, "y", "k") }; }
-    template<typename T> R<T> yellow_on_blue(T t)               { return R<T> { S<T>(t, "y", "b") }; }
-    template<typename T> R<T> yellow_on_green(T t)              { return R<T> { S<T>(t, "y", "g") }; }
-    template<typename T> R<T> yellow_on_aqua(T t)               { return R<T> { S<T>(t, "y", "a") }; }
-    template<typename T> R<T> yellow_on_red(T t)                { return R<T> { S<T>(t, "y", "r") }; }
-    template<typename T> R<T> yellow_on_purple(T t)             { return R<T> { S<T>(t, "y", "p") }; }
-    template<typename T> R<T> yellow_on_yellow(T t)             { return R<T> { S<T>(t, "y", "y") }; }
-    template<typename T> R<T> yellow_on_white(T t)              { return R<T> { S<T>(t, "y", "w") }; }
-    template<typename T> R<T> yellow_on_grey(T t)               { return R<T> { S<T>(t, "y", "e") }; }
-    template<typename T> R<T> yellow_on_light_blue(T t)         { return R<T> { S<T>(t, "y", "lb") }; }
-    template<typename T> R<T> yellow_on_light_green(T t)        { return R<T> { S<T>(t, "y", "lg") }; }
-    template<typename T> R<T> yellow_on_light_aqua(T t)         { return R<T> { S<T>(t, "y", "la") }; }
-    template<typename T> R<T> yellow_on_light_red(T t)          { return R<T> { S<T>(t, "y", "lr") }; }
-    template<typename T> R<T> yellow_on_light_purple(T t)       { return R<T> { S<T>(t, "y", "lp") }; }
-    template<typename T> R<T> yellow_on_light_yellow(T t)       { return R<T> { S<T>(t, "y", "ly") }; }
-    template<typename T> R<T> yellow_on_bright_white(T t)       { return R<T> { S<T>(t, "y", "bw") }; }
-    template<typename T> R<T> white_on_black(T t)               { return R<T> { S<T>(t, "w", "k") }; }
-    template<typename T> R<T> white_on_blue(T t)                { return R<T> { S<T>(t, "w", "b") }; }
-    template<typename T> R<T> white_on_green(T t)               { return R<T> { S<T>(t, "w", "g") }; }
-    template<typename T> R<T> white_on_aqua(T t)                { return R<T> { S<T>(t, "w", "a") }; }
-    template<typename T> R<T> white_on_red(T t)                 { return R<T> { S<T>(t, "w", "r") }; }
-    template<typename T> R<T> white_on_purple(T t)              { return R<T> { S<T>(t, "w", "p") }; }
-    template<typename T> R<T> white_on_yellow(T t)              { return R<T> { S<T>(t, "w", "y") }; }
-    template<typename T> R<T> white_on_white(T t)               { return R<T> { S<T>(t, "w", "w") }; }
-    template<typename T> R<T> white_on_grey(T t)                { return R<T> { S<T>(t, "w", "e") }; }
-    template<typename T> R<T> white_on_light_blue(T t)          { return R<T> { S<T>(t, "w", "lb") }; }
-    template<typename T> R<T> white_on_light_green(T t)         { return R<T> { S<T>(t, "w", "lg") }; }
-    template<typename T> R<T> white_on_light_aqua(T t)          { return R<T> { S<T>(t, "w", "la") }; }
-    template<typename T> R<T> white_on_light_red(T t)           { return R<T> { S<T>(t, "w", "lr") }; }
-    template<typename T> R<T> white_on_light_purple(T t)        { return R<T> { S<T>(t, "w", "lp") }; }
-    template<typename T> R<T> white_on_light_yellow(T t)        { return R<T> { S<T>(t, "w", "ly") }; }
-    template<typename T> R<T> white_on_bright_white(T t)        { return R<T> { S<T>(t, "w", "bw") }; }
-    template<typename T> R<T> grey_on_black(T t)                { return R<T> { S<T>(t, "e", "k") }; }
-    template<typename T> R<T> grey_on_blue(T t)                 { return R<T> { S<T>(t, "e", "b") }; }
-    template<typename T> R<T> grey_on_green(T t)                { return R<T> { S<T>(t, "e", "g") }; }
-    template<typename T> R<T> grey_on_aqua(T t)                 { return R<T> { S<T>(t, "e", "a") }; }
-    template<typename T> R<T> grey_on_red(T t)                  { return R<T> { S<T>(t, "e", "r") }; }
-    template<typename T> R<T> grey_on_purple(T t)               { return R<T> { S<T>(t, "e", "p") }; }
-    template<typename T> R<T> grey_on_yellow(T t)               { return R<T> { S<T>(t, "e", "y") }; }
-    template<typename T> R<T> grey_on_white(T t)                { return R<T> { S<T>(t, "e", "w") }; }
-    template<typename T> R<T> grey_on_grey(T t)                 { return R<T> { S<T>(t, "e", "e") }; }
-    template<typename T> R<T> grey_on_light_blue(T t)           { return R<T> { S<T>(t, "e", "lb") }; }
-    template<typename T> R<T> grey_on_light_green(T t)          { return R<T> { S<T>(t, "e", "lg") }; }
-    template<typename T> R<T> grey_on_light_aqua(T t)           { return R<T> { S<T>(t, "e", "la") }; }
-    template<typename T> R<T> grey_on_light_red(T t)            { return R<T> { S<T>(t, "e", "lr") }; }
-    template<typename T> R<T> grey_on_light_purple(T t)         { return R<T> { S<T>(t, "e", "lp") }; }
-    template<typename T> R<T> grey_on_light_yellow(T t)         { return R<T> { S<T>(t, "e", "ly") }; }
-    template<typename T> R<T> grey_on_bright_white(T t)         { return R<T> { S<T>(t, "e", "bw") }; }
-    template<typename T> R<T> light_blue_on_black(T t)          { return R<T> { S<T>(t, "lb", "k") }; }
-    template<typename T> R<T> light_blue_on_blue(T t)           { return R<T> { S<T>(t, "lb", "b") }; }
-    template<typename T> R<T> light_blue_on_green(T t)          { return R<T> { S<T>(t, "lb", "g") }; }
-    template<typename T> R<T> light_blue_on_aqua(T t)           { return R<T> { S<T>(t, "lb", "a") }; }
-    template<typename T> R<T> light_blue_on_red(T t)            { return R<T> { S<T>(t, "lb", "r") }; }
-    template<typename T> R<T> light_blue_on_purple(T t)         { return R<T> { S<T>(t, "lb", "p") }; }
-    template<typename T> R<T> light_blue_on_yellow(T t)         { return R<T> { S<T>(t, "lb", "y") }; }
-    template<typename T> R<T> light_blue_on_white(T t)          { return R<T> { S<T>(t, "lb", "w") }; }
-    template<typename T> R<T> light_blue_on_grey(T t)           { return R<T> { S<T>(t, "lb", "e") }; }
-    template<typename T> R<T> light_blue_on_light_blue(T t)     { return R<T> { S<T>(t, "lb", "lb") }; }
-    template<typename T> R<T> light_blue_on_light_green(T t)    { return R<T> { S<T>(t, "lb", "lg") }; }
-    template<typename T> R<T> light_blue_on_light_aqua(T t)     { return R<T> { S<T>(t, "lb", "la") }; }
-    template<typename T> R<T> light_blue_on_light_red(T t)      { return R<T> { S<T>(t, "lb", "lr") }; }
-    template<typename T> R<T> light_blue_on_light_purple(T t)   { return R<T> { S<T>(t, "lb", "lp") }; }
-    template<typename T> R<T> light_blue_on_light_yellow(T t)   { return R<T> { S<T>(t, "lb", "ly") }; }
-    template<typename T> R<T> light_blue_on_bright_white(T t)   { return R<T> { S<T>(t, "lb", "bw") }; }
-    template<typename T> R<T> light_green_on_black(T t)         { return R<T> { S<T>(t, "lg", "k") }; }
-    template<typename T> R<T> light_green_on_blue(T t)          { return R<T> { S<T>(t, "lg", "b") }; }
-    template<typename T> R<T> light_green_on_green(T t)         { return R<T> { S<T>(t, "lg", "g") }; }
-    template<typename T> R<T> light_green_on_aqua(T t)          { return R<T> { S<T>(t, "lg", "a") }; }
-    template<typename T> R<T> light_green_on_red(T t)           { return R<T> { S<T>(t, "lg", "r") }; }
-    template<typename T> R<T> light_green_on_purple(T t)        { return R<T> { S<T>(t, "lg", "p") }; }
-    template<typename T> R<T> light_green_on_yellow(T t)        { return R<T> { S<T>(t, "lg", "y") }; }
-    template<typename T> R<T> light_green_on_white(T t)         { return R<T> { S<T>(t, "lg", "w") }; }
-    template<typename T> R<T> light_green_on_grey(T t)          { return R<T> { S<T>(t, "lg", "e") }; }
-    template<typename T> R<T> light_green_on_light_blue(T t)    { return R<T> { S<T>(t, "lg", "lb") }; }
-    template<typename T> R<T> light_green_on_light_green(T t)   { return R<T> { S<T>(t, "lg", "lg") }; }
-    template<typename T> R<T> light_green_on_light_aqua(T t)    { return R<T> { S<T>(t, "lg", "la") }; }
-    template<typename T> R<T> light_green_on_light_red(T t)     { return R<T> { S<T>(t, "lg", "lr") }; }
-    template<typename T> R<T> light_green_on_light_purple(T t)  { return R<T> { S<T>(t, "lg", "lp") }; }
-    template<typename T> R<T> light_green_on_light_yellow(T t)  { return R<T> { S<T>(t, "lg", "ly") }; }
-    template<typename T> R<T> light_green_on_bright_white(T t)  { return R<T> { S<T>(t, "lg", "bw") }; }
-    template<typename T> R<T> light_aqua_on_black(T t)          { return R<T> { S<T>(t, "la", "k") }; }
-    template<typename T> R<T> light_aqua_on_blue(T t)           { return R<T> { S<T>(t, "la", "b") }; }
-    template<typename T> R<T> light_aqua_on_green(T t)          { return R<T> { S<T>(t, "la", "g") }; }
-    template<typename T> R<T> light_aqua_on_aqua(T t)           { return R<T> { S<T>(t, "la", "a") }; }
-    template<typename T> R<T> light_aqua_on_red(T t)            { return R<T> { S<T>(t, "la", "r") }; }
-    template<typename T> R<T> light_aqua_on_purple(T t)         { return R<T> { S<T>(t, "la", "p") }; }
-    template<typename T> R<T> light_aqua_on_yellow(T t)         { return R<T> { S<T>(t, "la", "y") }; }
-    template<typename T> R<T> light_aqua_on_white(T t)          { return R<T> { S<T>(t, "la", "w") }; }
-    template<typename T> R<T> light_aqua_on_grey(T t)           { return R<T> { S<T>(t, "la", "e") }; }
-    template<typename T> R<T> light_aqua_on_light_blue(T t)     { return R<T> { S<T>(t, "la", "lb") }; }
-    template<typename T> R<T> light_aqua_on_light_green(T t)    { return R<T> { S<T>(t, "la", "lg") }; }
-    template<typename T> R<T> light_aqua_on_light_aqua(T t)     { return R<T> { S<T>(t, "la", "la") }; }
-    template<typename T> R<T> light_aqua_on_light_red(T t)      { return R<T> { S<T>(t, "la", "lr") }; }
-    template<typename T> R<T> light_aqua_on_light_purple(T t)   { return R<T> { S<T>(t, "la", "lp") }; }
-    template<typename T> R<T> light_aqua_on_light_yellow(T t)   { return R<T> { S<T>(t, "la", "ly") }; }
-    template<typename T> R<T> light_aqua_on_bright_white(T t)   { return R<T> { S<T>(t, "la", "bw") }; }
-    template<typename T> R<T> light_red_on_black(T t)           { return R<T> { S<T>(t, "lr", "k") }; }
-    template<typename T> R<T> light_red_on_blue(T t)            { return R<T> { S<T>(t, "lr", "b") }; }
-    template<typename T> R<T> light_red_on_green(T t)           { return R<T> { S<T>(t, "lr", "g") }; }
-    template<typename T> R<T> light_red_on_aqua(T t)            { return R<T> { S<T>(t, "lr", "a") }; }
-    template<typename T> R<T> light_red_on_red(T t)             { return R<T> { S<T>(t, "lr", "r") }; }
-    template<typename T> R<T> light_red_on_purple(T t)          { return R<T> { S<T>(t, "lr", "p") }; }
-    template<typename T> R<T> light_red_on_yellow(T t)          { return R<T> { S<T>(t, "lr", "y") }; }
-    template<typename T> R<T> light_red_on_white(T t)           { return R<T> { S<T>(t, "lr", "w") }; }
-    template<typename T> R<T> light_red_on_grey(T t)            { return R<T> { S<T>(t, "lr", "e") }; }
-    template<typename T> R<T> light_red_on_light_blue(T t)      { return R<T> { S<T>(t, "lr", "lb") }; }
-    template<typename T> R<T> light_red_on_light_green(T t)     { return R<T> { S<T>(t, "lr", "lg") }; }
-    template<typename T> R<T> light_red_on_light_aqua(T t)      { return R<T> { S<T>(t, "lr", "la") }; }
-    template<typename T> R<T> light_red_on_light_red(T t)       { return R<T> { S<T>(t, "lr", "lr") }; }
-    template<typename T> R<T> light_red_on_light_purple(T t)    { return R<T> { S<T>(t, "lr", "lp") }; }
-    template<typename T> R<T> light_red_on_light_yellow(T t)    { return R<T> { S<T>(t, "lr", "ly") }; }
-    template<typename T> R<T> light_red_on_bright_white(T t)    { return R<T> { S<T>(t, "lr", "bw") }; }
-    template<typename T> R<T> light_purple_on_black(T t)        { return R<T> { S<T>(t, "lp", "k") }; }
-    template<typename T> R<T> light_purple_on_blue(T t)         { return R<T> { S<T>(t, "lp", "b") }; }
-    template<typename T> R<T> light_purple_on_green(T t)        { return R<T> { S<T>(t, "lp", "g") }; }
-    template<typename T> R<T> light_purple_on_aqua(T t)         { return R<T> { S<T>(t, "lp", "a") }; }
-    template<typename T> R<T> light_purple_on_red(T t)          { return R<T> { S<T>(t, "lp", "r") }; }
-    template<typename T> R<T> light_purple_on_purple(T t)       { return R<T> { S<T>(t, "lp", "p") }; }
-    template<typename T> R<T> light_purple_on_yellow(T t)       { return R<T> { S<T>(t, "lp", "y") }; }
-    template<typename T> R<T> light_purple_on_white(T t)        { return R<T> { S<T>(t, "lp", "w") }; }
-    template<typename T> R<T> light_purple_on_grey(T t)         { return R<T> { S<T>(t, "lp", "e") }; }
-    template<typename T> R<T> light_purple_on_light_blue(T t)   { return R<T> { S<T>(t, "lp", "lb") }; }
-    template<typename T> R<T> light_purple_on_light_green(T t)  { return R<T> { S<T>(t, "lp", "lg") }; }
-    template<typename T> R<T> light_purple_on_light_aqua(T t)   { return R<T> { S<T>(t, "lp", "la") }; }
-    template<typename T> R<T> light_purple_on_light_red(T t)    { return R<T> { S<T>(t, "lp", "lr") }; }
-    template<typename T> R<T> light_purple_on_light_purple(T t) { return R<T> { S<T>(t, "lp", "lp") }; }
-    template<typename T> R<T> light_purple_on_light_yellow(T t) { return R<T> { S<T>(t, "lp", "ly") }; }
-    template<typename T> R<T> light_purple_on_bright_white(T t) { return R<T> { S<T>(t, "lp", "bw") }; }
-    template<typename T> R<T> light_yellow_on_black(T t)        { return R<T> { S<T>(t, "ly", "k") }; }
-    template<typename T> R<T> light_yellow_on_blue(T t)         { return R<T> { S<T>(t, "ly", "b") }; }
-    template<typename T> R<T> light_yellow_on_green(T t)        { return R<T> { S<T>(t, "ly", "g") }; }
-    template<typename T> R<T> light_yellow_on_aqua(T t)         { return R<T> { S<T>(t, "ly", "a") }; }
-    template<typename T> R<T> light_yellow_on_red(T t)          { return R<T> { S<T>(t, "ly", "r") }; }
-    template<typename T> R<T> light_yellow_on_purple(T t)       { return R<T> { S<T>(t, "ly", "p") }; }
-    template<typename T> R<T> light_yellow_on_yellow(T t)       { return R<T> { S<T>(t, "ly", "y") }; }
-    template<typename T> R<T> light_yellow_on_white(T t)        { return R<T> { S<T>(t, "ly", "w") }; }
-    template<typename T> R<T> light_yellow_on_grey(T t)         { return R<T> { S<T>(t, "ly", "e") }; }
-    template<typename T> R<T> light_yellow_on_light_blue(T t)   { return R<T> { S<T>(t, "ly", "lb") }; }
-    template<typename T> R<T> light_yellow_on_light_green(T t)  { return R<T> { S<T>(t, "ly", "lg") }; }
-    template<typename T> R<T> light_yellow_on_light_aqua(T t)   { return R<T> { S<T>(t, "ly", "la") }; }
-    template<typename T> R<T> light_yellow_on_light_red(T t)    { return R<T> { S<T>(t, "ly", "lr") }; }
-    template<typename T> R<T> light_yellow_on_light_purple(T t) { return R<T> { S<T>(t, "ly", "lp") }; }
-    template<typename T> R<T> light_yellow_on_light_yellow(T t) { return R<T> { S<T>(t, "ly", "ly") }; }
-    template<typename T> R<T> light_yellow_on_bright_white(T t) { return R<T> { S<T>(t, "ly", "bw") }; }
-    template<typename T> R<T> bright_white_on_black(T t)        { return R<T> { S<T>(t, "bw", "k") }; }
-    template<typename T> R<T> bright_white_on_blue(T t)         { return R<T> { S<T>(t, "bw", "b") }; }
-    template<typename T> R<T> bright_white_on_green(T t)        { return R<T> { S<T>(t, "bw", "g") }; }
-    template<typename T> R<T> bright_white_on_aqua(T t)         { return R<T> { S<T>(t, "bw", "a") }; }
-    template<typename T> R<T> bright_white_on_red(T t)          { return R<T> { S<T>(t, "bw", "r") }; }
-    template<typename T> R<T> bright_white_on_purple(T t)       { return R<T> { S<T>(t, "bw", "p") }; }
-    template<typename T> R<T> bright_white_on_yellow(T t)       { return R<T> { S<T>(t, "bw", "y") }; }
-    template<typename T> R<T> bright_white_on_white(T t)        { return R<T> { S<T>(t, "bw", "w") }; }
-    template<typename T> R<T> bright_white_on_grey(T t)         { return R<T> { S<T>(t, "bw", "e") }; }
-    template<typename T> R<T> bright_white_on_light_blue(T t)   { return R<T> { S<T>(t, "bw", "lb") }; }
-    template<typename T> R<T> bright_white_on_light_green(T t)  { return R<T> { S<T>(t, "bw", "lg") }; }
-    template<typename T> R<T> bright_white_on_light_aqua(T t)   { return R<T> { S<T>(t, "bw", "la") }; }
-    template<typename T> R<T> bright_white_on_light_red(T t)    { return R<T> { S<T>(t, "bw", "lr") }; }
-    template<typename T> R<T> bright_white_on_light_purple(T t) { return R<T> { S<T>(t, "bw", "lp") }; }
-    template<typename T> R<T> bright_white_on_light_yellow(T t) { return R<T> { S<T>(t, "bw", "ly") }; }
-    template<typename T> R<T> bright_white_on_bright_white(T t) { return R<T> { S<T>(t, "bw", "bw") }; }
+    // colors past the console's 16; see hue::rgb
+    template<typename T> R<T> rgb(T t, int r, int g, int b)     { return R<T>(S<T>(std::move(t), hue::rgb(r, g, b))); }
+    template<typename T> R<T> on_rgb(T t, int r, int g, int b)  { return R<T>(S<T>(std::move(t), hue::on_rgb(r, g, b))); }
+    template<typename T> R<T> xterm256(T t, int n)              { return R<T>(S<T>(std::move(t), hue::xterm256(n))); }
+    template<typename T> R<T> on_xterm256(T t, int n)           { return R<T>(S<T>(std::move(t), hue::on_xterm256(n))); }
 }
 
 #endif
@@ -0,0 +1,228 @@
+#ifndef COLOR_CANVAS_HPP
+#define COLOR_CANVAS_HPP
+
+#include "color.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace hue
+{
+    // An off-screen grid of cells, each a character and a color code from
+    // 0 to 255, for dashboards that redraw several times a second.  Draw the
+    // next frame into it, then present() writes only the cells that differ
+    // from the frame on screen, moving the cursor and switching colors only
+    // where it has to:
+    //
+    //     hue::canvas screen(80, 24);
+    //     screen.write(0, 0, "load", hue::LIGHT_AQUA);
+    //     screen.write(6, 0, std::to_string(load), hue::YELLOW);
+    //     screen.present(std::cout);
+    //
+    // The canvas covers the top-left corner of the terminal and takes single
+    // byte characters.  The first frame, and the first after invalidate(),
+    // is drawn in full.
+    class canvas
+    {
+        struct cell
+        {
+            char ch;
+            unsigned char color;
+
+            bool operator==(const cell & c) const
+            {
+                return ch == c.ch && color == c.color;
+            }
+
+            bool operator!=(const cell & c) const
+            {
+                return !(*this == c);
+            }
+        };
+
+        int columns;
+        int rows;
+        std::vector<cell> next;     // the frame being drawn
+        std::vector<cell> shown;    // the frame on screen
+        bool stale;                 // whether shown is to be trusted
+
+    public:
+        canvas(int width, int height)
+            : columns(width > 0 ? width : 0), rows(height > 0 ? height : 0),
+              next(static_cast<std::size_t>(columns) * rows, cell{' ', DEFAULT_COLOR}),
+              shown(next), stale(true)
+        {
+        }
+
+        int width() const
+        {
+            return columns;
+        }
+
+        int height() const
+        {
+            return rows;
+        }
+
+        // blank the frame being drawn
+        void clear(int color = DEFAULT_COLOR)
+        {
+            std::fill(next.begin(), next.end(), cell{' ', attribute(color)});
+        }
+
+        // cells outside the canvas are ignored
+        void put(int x, int y, char ch, int color)
+        {
+            if (0 <= x && x < columns && 0 <= y && y < rows)
+                next[index(x, y)] = cell{ch, attribute(color)};
+        }
+
+        // write s from (x, y) to the right, clipped at the edge
+        void write(int x, int y, const char * s, std::size_t n, int color)
+        {
+            if (y < 0 || y >= rows)
+                return;
+            unsigned char a = attribute(color);
+            for (std::size_t i = 0; i != n && x < columns; ++i, ++x)
+                if (x >= 0)
+                    next[index(x, y)] = cell{s[i], a};
+        }
+
+        void write(int x, int y, const std::string & s, int color)
+        {
+            write(x, y, s.data(), s.size(), color);
+        }
+
+        void fill(int x, int y, int width, int height, char ch, int color)
+        {
+            for (int j = y; j < y + height; ++j)
+                for (int i = x; i < x + width; ++i)
+                    put(i, j, ch, color);
+        }
+
+        char char_at(int x, int y) const
+        {
+            return next[index(x, y)].ch;
+        }
+
+        int color_at(int x, int y) const
+        {
+            return next[index(x, y)].color;
+        }
+
+        // forget what is on screen, e.g. after the terminal has been cleared,
+        // so that the next present() draws every cell
+        void invalidate()
+        {
+            stale = true;
+        }
+
+        // bring the screen up to date with the frame drawn; returns the
+        // number of cells written.  A muted stream, such as cout sent to a
+        // file, has no screen to address and gets nothing.
+        std::size_t present(std::ostream & os)
+        {
+            if (muted(os))
+                return 0;
+            std::size_t written = 0;
+            int color = get(os);
+            int cx = -1;
+            int cy = -1;
+            std::string run;
+
+            for (int y = 0; y != rows; ++y) {
+                for (int x = 0; x != columns; ) {
+                    std::size_t i = index(x, y);
+                    if (!stale && next[i] == shown[i]) {
+                        ++x;
+                        continue;
+                    }
+
+                    move(os, cx, cy, x, y, color);
+                    // one span of changed cells, split only where its color changes
+                    while (x != columns && (stale || next[index(x, y)] != shown[index(x, y)])) {
+                        cell & c = next[index(x, y)];
+                        if (c.color != color) {
+                            if (!run.empty()) {
+                                os.write(run.data(), static_cast<std::streamsize>(run.size()));
+                                run.clear();
+                            }
+                            set(os, c.color);
+                            color = c.color;
+                        }
+                        run.push_back(c.ch);
+                        shown[index(x, y)] = c;
+                        ++written;
+                        ++x;
+                    }
+                    os.write(run.data(), static_cast<std::streamsize>(run.size()));
+                    run.clear();
+                    // past the last column the terminal may be waiting to wrap,
+                    // so the next move must not be relative
+                    cx = x < columns ? x : -1;
+                    cy = y;
+                }
+            }
+
+            if (written && color != DEFAULT_COLOR)
+                set(os, DEFAULT_COLOR);
+            stale = false;
+            return written;
+        }
+
+    private:
+        std::size_t index(int x, int y) const
+        {
+            return static_cast<std::size_t>(y) * columns + x;
+        }
+
+        static unsigned char attribute(int color)
+        {
+            color = console(color);
+            return static_cast<unsigned char>(is_good(color) ? color : DEFAULT_COLOR);
+        }
+
+        // take the cursor from (cx, cy) to (x, y) the cheapest way we know;
+        // a short gap on the same row whose cells are already right and in
+        // the current color is simply written over again
+        void move(std::ostream & os, int cx, int cy, int x, int y, int color)
+        {
+            if (cy == y && cx == x)
+                return;
+#if defined(COLOR_CONSOLE_WIN32)
+            if (!escaped(os)) {
+                os.flush();
+                COORD p = {static_cast<SHORT>(x), static_cast<SHORT>(y)};
+                SetConsoleCursorPosition(GetStdHandle(STD_OUTPUT_HANDLE), p);
+                COLOR_CONSOLE_COUNT(console_calls, 1);
+                return;
+            }
+#endif
+            if (cy == y && 0 <= cx && cx < x) {
+                int gap = x - cx;
+                if (gap <= 3) {
+                    bool same = true;
+                    for (int i = cx; i != x && same; ++i)
+                        same = shown[index(i, y)].color == color;
+                    if (same) {
+                        for (int i = cx; i != x; ++i)
+                            os.put(shown[index(i, y)].ch);
+                        return;
+                    }
+                }
+                os << "\x1b[" << gap << 'C';
+                return;
+            }
+            if (x == 0 && y == 0)
+                os.write("\x1b[H", 3);
+            else if (x == 0)
+                os << "\x1b[" << y + 1 << 'H';
+            else
+                os << "\x1b[" << y + 1 << ';' << x + 1 << 'H';
+        }
+    };
+}
+
+#endif
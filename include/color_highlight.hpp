@@ -0,0 +1,566 @@
+#ifndef COLOR_HIGHLIGHT_HPP
+#define COLOR_HIGHLIGHT_HPP
+
+#include "color.hpp"
+#include "color_scan.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace dye
+{
+    // Colors keywords and numbers in running text, the way examples/mark.cpp
+    // does, without breaking the text into strings.  The keywords are
+    // compiled once into an Aho-Corasick automaton; input is then scanned in
+    // fixed-size chunks and written out as it goes, so memory stays the same
+    // whatever the size of the input:
+    //
+    //     dye::highlighter marker({"google", "facebook"}, hue::YELLOW);
+    //     marker.highlight(std::cin, std::cout);
+    //
+    // Keywords match case-insensitively and may span several words.  A match
+    // counts when it starts and ends at a word boundary: whitespace, the
+    // punctuation in mark.cpp, or either end of the input.  A number is a run
+    // of digits, commas and periods, with an optional leading '$' and
+    // trailing '%', bounded the same way.  Overlapping matches go to the one
+    // starting first, then to the longer one.
+    class highlighter
+    {
+        enum : unsigned char
+        {
+            BOUNDARY = 1,   // whitespace and punctuation
+            NUMERIC = 2,    // may be part of a number
+            START = 4       // may start a keyword or a number
+        };
+
+        // bytes are mapped to classes, so a row of the automaton has one
+        // column per distinct keyword character plus one for the rest
+        unsigned char classes[256];
+        unsigned char kinds[256];
+        simd::byte_set starts;              // the bytes with START set
+        int width;
+        // (state * width + class) -> the next state's row, state * width,
+        // negated if a keyword ends there, its own or a suffix of it
+        std::vector<std::int32_t> delta;
+        std::vector<std::int32_t> match;    // longest keyword ending in state
+        std::vector<std::int32_t> shorter;  // next state whose keyword is a suffix
+        std::vector<std::int32_t> depth;
+        std::size_t longest;
+        int keyword_color;
+        int number_color;
+
+    public:
+        static constexpr std::size_t CHUNK = 64 * 1024;
+
+        // a number longer than this is left plain
+        static constexpr std::size_t MAX_NUMBER = 64;
+
+        // keywords in inverted color, numbers in color, like mark()
+        highlighter(const std::vector<std::string> & keywords, int color)
+            : highlighter(keywords, hue::invert(color), color)
+        {
+        }
+
+        highlighter(const std::vector<std::string> & keywords, int keyword_color, int number_color)
+            : width(1), longest(0), keyword_color(keyword_color), number_color(number_color)
+        {
+            for (int c = 0; c != 256; ++c) {
+                kinds[c] = 0;
+                classes[c] = 0;
+            }
+            for (unsigned char c : {' ', '\t', '\n', '\r', '\v', '\f', ',', '.', ':', ';',
+                                    '?', '!', '\'', '"', '(', ')'})
+                kinds[c] |= BOUNDARY;
+            for (unsigned char c : {',', '.', '$', '%'})
+                kinds[c] |= NUMERIC;
+            for (unsigned char c = '0'; c <= '9'; ++c)
+                kinds[c] |= NUMERIC;
+            for (int c = 0; c != 256; ++c)
+                if (kinds[c] & NUMERIC)
+                    kinds[c] |= START;
+            compile(keywords);
+            for (int c = 0; c != 256; ++c)
+                if (kinds[c] & START)
+                    starts.add(static_cast<unsigned char>(c));
+        }
+
+        // Where a scanner sends its output: n bytes at p, all to be shown in
+        // color.  Text of one color may come in several pieces, and at the
+        // end n is 0 with color the plain one, to switch back to it.
+        class sink
+        {
+        public:
+            const int plain;    // the color of text that is neither keyword nor number
+
+            virtual void write(const char * p, std::size_t n, int color) = 0;
+
+        protected:
+            explicit sink(int plain) : plain(plain)
+            {
+            }
+
+            ~sink() = default;
+        };
+
+        // a sink writing to a stream, switching colors only when they change
+        class stream_sink : public sink
+        {
+            std::ostream & os;
+            int current;
+
+        public:
+            explicit stream_sink(std::ostream & os) : sink(hue::get(os)), os(os), current(plain)
+            {
+            }
+
+            void write(const char * p, std::size_t n, int color) override
+            {
+                if (color != current) {
+                    hue::set(os, color);
+                    current = color;
+                }
+                os.write(p, static_cast<std::streamsize>(n));
+            }
+        };
+
+        // Scanning state for one input, fed in pieces of any size; output
+        // lags the input by at most the longest keyword or number
+        class scanner
+        {
+            struct span
+            {
+                std::size_t start;
+                std::size_t end;
+                int color;
+            };
+
+            const highlighter & h;
+            sink & out;
+            std::vector<char> buf;      // carried bytes, then the newest piece
+            // the bytes not yet written: in buf, or in place after view()
+            const char * data;
+            std::size_t size;
+            std::vector<span> spans;    // colored, sorted, not overlapping
+            // where keywords and numbers may start in the 64 bytes from block
+            std::size_t block;
+            std::uint64_t candidates;
+            char before;                // the byte before data[0]
+            bool at_start;
+            std::int32_t state;         // the automaton's current row
+            // a keyword that has matched, waiting to see a boundary after it
+            std::size_t kw_start;
+            std::size_t kw_end;
+            bool kw_pending;
+            // the run of number characters being read
+            std::size_t num_start;
+            bool num_open;
+            bool num_ok;
+
+        public:
+            scanner(const highlighter & h, sink & out)
+                : h(h), out(out), data(nullptr), size(0), block(std::size_t(-1)), candidates(0),
+                  before(' '), at_start(true), state(0), kw_start(0), kw_end(0),
+                  kw_pending(false), num_start(0), num_open(false), num_ok(false)
+            {
+            }
+
+            scanner(const scanner &) = delete;
+            scanner & operator=(const scanner &) = delete;
+
+            // scan a copy of n bytes at p, which may then go away
+            void feed(const char * p, std::size_t n)
+            {
+                if (buf.capacity() < CHUNK)
+                    buf.reserve(CHUNK + h.longest + MAX_NUMBER + 1);
+                while (n) {
+                    std::size_t k = n < CHUNK ? n : CHUNK;
+                    std::size_t from = buf.size();
+                    buf.insert(buf.end(), p, p + k);
+                    data = buf.data();
+                    size = buf.size();
+                    scan(from);
+                    flush(cut());
+                    p += k;
+                    n -= k;
+                }
+            }
+
+            // scan all of the input, n bytes at p, where it is; the pieces
+            // written to the sink point into it, and nothing is copied
+            void view(const char * p, std::size_t n)
+            {
+                data = p;
+                size = 0;
+                while (n) {
+                    std::size_t k = n < CHUNK ? n : CHUNK;
+                    std::size_t from = size;
+                    size += k;
+                    scan(from);
+                    flush(cut());
+                    n -= k;
+                }
+            }
+
+            // the end of the input counts as a boundary
+            void finish()
+            {
+                if (kw_pending)
+                    accept(kw_start, kw_end, h.keyword_color);
+                if (num_open)
+                    end_number(size, true);
+                kw_pending = false;
+                num_open = false;
+                flush(size);
+                out.write(data + size, 0, out.plain);
+            }
+
+        private:
+            bool boundary_before(std::size_t i) const
+            {
+                if (i)
+                    return h.kinds[static_cast<unsigned char>(data[i - 1])] & BOUNDARY;
+                return at_start || (h.kinds[static_cast<unsigned char>(before)] & BOUNDARY);
+            }
+
+            // the first byte from i on that can start a keyword or a number
+            // right after a boundary, or the end of data
+            std::size_t next_start(std::size_t i)
+            {
+                const std::size_t n = size;
+                if (simd::active() != simd::level::avx2) {
+                    // one table lookup a byte beats building masks bit by bit,
+                    // or range by range without a byte shuffle
+                    for (; i < n; ++i)
+                        if ((h.kinds[static_cast<unsigned char>(data[i])] & START) && boundary_before(i))
+                            return i;
+                    return n;
+                }
+                while (i < n) {
+                    std::size_t base = i & ~std::size_t(63);
+                    if (base != block) {
+                        std::size_t k = n - base < 64 ? n - base : 64;
+                        simd::masks m = simd::classify(data + base, k, h.starts);
+                        std::uint64_t after = (m.space | m.punct) << 1 | (boundary_before(base) ? 1 : 0);
+                        candidates = after & m.member;
+                        block = k == 64 ? base : std::size_t(-1);
+                    }
+                    std::uint64_t c = candidates & (~std::uint64_t(0) << (i - base));
+                    if (c)
+                        return base + simd::lowest_bit(c);
+                    i = base + 64;
+                }
+                return n;
+            }
+
+            void scan(std::size_t i)
+            {
+                const std::size_t n = size;
+                const char * p = data;
+                const unsigned char * kinds = h.kinds;
+                const unsigned char * classes = h.classes;
+                const std::int32_t * delta = h.delta.data();
+                std::int32_t s = state;
+                unsigned char last = i ? kinds[static_cast<unsigned char>(p[i - 1])]
+                                       : at_start ? static_cast<unsigned char>(BOUNDARY)
+                                                  : kinds[static_cast<unsigned char>(before)];
+
+                for (; i != n; ++i) {
+                    // at the root nothing can happen before the next place a
+                    // keyword or number may start
+                    if (s == 0 && !kw_pending && !num_open) {
+                        std::size_t j = next_start(i);
+                        if (j != i) {
+                            if (j == n)
+                                break;
+                            i = j;
+                            last = kinds[static_cast<unsigned char>(p[i - 1])];
+                        }
+                    }
+
+                    unsigned char b = static_cast<unsigned char>(p[i]);
+                    unsigned char kind = kinds[b];
+
+                    // plain letters, the bulk of any text, only step the automaton
+                    if ((kind & NUMERIC) | kw_pending | num_open) {
+                        if (kw_pending) {
+                            if (kind & BOUNDARY)
+                                accept(kw_start, kw_end, h.keyword_color);
+                            kw_pending = false;
+                        }
+                        if (num_open) {
+                            if (!(kind & NUMERIC))
+                                end_number(i, (kind & BOUNDARY) != 0);
+                            else if (i - num_start >= MAX_NUMBER)
+                                num_ok = false;
+                        }
+                        else if ((kind & NUMERIC) && !(last & NUMERIC)) {
+                            num_open = true;
+                            num_start = i;
+                            num_ok = (last & BOUNDARY) != 0;
+                        }
+                    }
+                    last = kind;
+
+                    s = delta[s + classes[b]];
+                    if (s < 0) {
+                        s = -s;
+                        keyword(s / h.width, i + 1);
+                    }
+                }
+                state = s;
+            }
+
+            // a keyword or more ends just before end; take the longest one
+            // that starts at a boundary and wait for the next byte.  State s
+            // need not be a keyword itself when a suffix of it is.
+            void keyword(std::int32_t s, std::size_t end)
+            {
+                for (; s; s = h.shorter[s]) {
+                    if (!h.match[s])
+                        continue;
+                    std::size_t start = end - static_cast<std::size_t>(h.match[s]);
+                    if (boundary_before(start)) {
+                        kw_start = start;
+                        kw_end = end;
+                        kw_pending = true;
+                        return;
+                    }
+                }
+            }
+
+            void end_number(std::size_t end, bool bounded)
+            {
+                num_open = false;
+                if (!num_ok || !bounded || end - num_start > MAX_NUMBER)
+                    return;
+                // leading and trailing commas and periods are punctuation
+                std::size_t a = num_start;
+                std::size_t b = end;
+                while (a != b && (data[a] == ',' || data[a] == '.'))
+                    ++a;
+                while (a != b && (data[b - 1] == ',' || data[b - 1] == '.'))
+                    --b;
+                std::size_t p = a + (a != b && data[a] == '$');
+                std::size_t q = b - (b != p && data[b - 1] == '%');
+                if (p == q)
+                    return;
+                for (std::size_t i = p; i != q; ++i)
+                    if (!(h.kinds[static_cast<unsigned char>(data[i])] & NUMERIC) ||
+                        data[i] == '$' || data[i] == '%')
+                        return;
+                accept(a, b, h.number_color);
+            }
+
+            // add a colored span, leftmost then longest winning an overlap
+            void accept(std::size_t start, std::size_t end, int color)
+            {
+                while (!spans.empty() && spans.back().end > start) {
+                    if (spans.back().start < start)
+                        return;
+                    if (spans.back().start == start && spans.back().end >= end)
+                        return;
+                    spans.pop_back();
+                }
+                spans.push_back({start, end, color});
+            }
+
+            // where the bytes that can still change color begin
+            std::size_t cut() const
+            {
+                std::size_t c = size - static_cast<std::size_t>(h.depth[state / h.width]);
+                if (kw_pending && kw_start < c)
+                    c = kw_start;
+                if (num_open && num_ok && num_start < c)
+                    c = num_start;
+                // never split a span, so that a later one cannot replace
+                // a span that has been half written
+                for (std::size_t k = spans.size(); k-- && spans[k].end > c; )
+                    if (spans[k].start < c)
+                        c = spans[k].start;
+                return c;
+            }
+
+            // write out data up to c, then drop it
+            void flush(std::size_t c)
+            {
+                std::size_t i = 0;
+                std::size_t kept = 0;
+                for (std::size_t k = 0; k != spans.size(); ++k) {
+                    span sp = spans[k];
+                    if (sp.end <= c) {
+                        write(i, sp.start, out.plain);
+                        write(sp.start, sp.end, sp.color);
+                        i = sp.end;
+                    }
+                    else {
+                        sp.start -= c;
+                        sp.end -= c;
+                        spans[kept++] = sp;
+                    }
+                }
+                spans.resize(kept);
+                write(i, c, out.plain);
+
+                block = std::size_t(-1);
+                if (c) {
+                    before = data[c - 1];
+                    at_start = false;
+                    if (buf.empty()) {
+                        data += c;
+                    }
+                    else {
+                        buf.erase(buf.begin(), buf.begin() + static_cast<std::ptrdiff_t>(c));
+                        data = buf.data();
+                    }
+                    size -= c;
+                    if (kw_pending) {
+                        kw_start -= c;
+                        kw_end -= c;
+                    }
+                    if (num_open)
+                        num_start = num_start >= c ? num_start - c : 0;
+                }
+            }
+
+            void write(std::size_t a, std::size_t b, int color)
+            {
+                if (a != b)
+                    out.write(data + a, b - a, color);
+            }
+        };
+
+        void highlight(const char * p, std::size_t n, sink & out) const
+        {
+            scanner s(*this, out);
+            s.view(p, n);
+            s.finish();
+        }
+
+        void highlight(const char * p, std::size_t n, std::ostream & os) const
+        {
+            if (hue::muted(os)) {
+                os.write(p, static_cast<std::streamsize>(n));
+                return;
+            }
+            stream_sink out(os);
+            highlight(p, n, out);
+        }
+
+        void highlight(const std::string & s, std::ostream & os) const
+        {
+            highlight(s.data(), s.size(), os);
+        }
+
+        void highlight(std::istream & is, std::ostream & os) const
+        {
+            const bool muted = hue::muted(os) != 0;
+            stream_sink out(os);
+            scanner s(*this, out);
+            std::vector<char> chunk(CHUNK);
+            while (is) {
+                is.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+                if (muted)
+                    os.write(chunk.data(), is.gcount());
+                else
+                    s.feed(chunk.data(), static_cast<std::size_t>(is.gcount()));
+            }
+            if (!muted)
+                s.finish();
+        }
+
+        // whether no keyword holds a line break, so that lines can be
+        // highlighted apart from one another with the same result
+        bool line_bound() const
+        {
+            return classes[static_cast<unsigned char>('\n')] == 0;
+        }
+
+    private:
+        static unsigned char fold(unsigned char c)
+        {
+            return (c >= 'A' && c <= 'Z') ? static_cast<unsigned char>(c - 'A' + 'a') : c;
+        }
+
+        void compile(const std::vector<std::string> & keywords)
+        {
+            // one class per distinct folded keyword byte; 0 is everything else
+            for (const auto & k : keywords)
+                for (char ch : k) {
+                    unsigned char c = fold(static_cast<unsigned char>(ch));
+                    if (!classes[c])
+                        classes[c] = static_cast<unsigned char>(width++);
+                }
+            for (const auto & k : keywords)
+                if (!k.empty()) {
+                    unsigned char c = fold(static_cast<unsigned char>(k[0]));
+                    kinds[c] |= START;
+                    if (c >= 'a' && c <= 'z')
+                        kinds[c - 'a' + 'A'] |= START;
+                }
+            for (int c = 'A'; c <= 'Z'; ++c)
+                classes[c] = classes[c - 'A' + 'a'];
+
+            // the trie, with -1 for missing edges
+            std::vector<std::int32_t> next(static_cast<std::size_t>(width), -1);
+            match.assign(1, 0);
+            depth.assign(1, 0);
+            for (const auto & k : keywords) {
+                if (k.empty())
+                    continue;
+                std::int32_t s = 0;
+                for (char ch : k) {
+                    std::size_t at = static_cast<std::size_t>(s) * width + classes[static_cast<unsigned char>(ch)];
+                    if (next[at] < 0) {
+                        next[at] = static_cast<std::int32_t>(match.size());
+                        match.push_back(0);
+                        depth.push_back(depth[s] + 1);
+                        next.resize(next.size() + width, -1);
+                    }
+                    s = next[at];
+                }
+                match[s] = static_cast<std::int32_t>(k.size());
+                if (k.size() > longest)
+                    longest = k.size();
+            }
+
+            // breadth first, fill in failure transitions to make a DFA
+            std::size_t states = match.size();
+            delta.assign(states * width, 0);
+            shorter.assign(states, 0);
+            std::vector<std::int32_t> fail(states, 0);
+            std::vector<std::int32_t> queue;
+            queue.reserve(states);
+            for (int c = 0; c != width; ++c) {
+                std::int32_t t = next[c];
+                if (t > 0) {
+                    delta[c] = t;
+                    queue.push_back(t);
+                }
+            }
+            for (std::size_t q = 0; q != queue.size(); ++q) {
+                std::int32_t s = queue[q];
+                std::int32_t f = fail[s];
+                shorter[s] = match[f] ? f : shorter[f];
+                for (int c = 0; c != width; ++c) {
+                    std::size_t at = static_cast<std::size_t>(s) * width + c;
+                    std::int32_t t = next[at];
+                    if (t > 0) {
+                        fail[t] = delta[static_cast<std::size_t>(f) * width + c];
+                        delta[at] = t;
+                        queue.push_back(t);
+                    }
+                    else {
+                        delta[at] = delta[static_cast<std::size_t>(f) * width + c];
+                    }
+                }
+            }
+            for (auto & t : delta)
+                t = match[t] || shorter[t] ? -t * width : t * width;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,207 @@
+#ifndef COLOR_LINE_HPP
+#define COLOR_LINE_HPP
+
+#include "color.hpp"
+#include <cstddef>
+#include <iostream>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <utility>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <cerrno>
+#include <climits>
+#include <unistd.h>
+#endif
+
+#if defined(__GLIBC__)
+#include <cstdio>
+#include <stdio_ext.h>
+#endif
+
+namespace dye
+{
+    // a streambuf that appends to a std::string it owns
+    class string_buffer : public std::streambuf
+    {
+        std::string text;
+
+    public:
+        std::string & str()
+        {
+            return text;
+        }
+
+    protected:
+        int_type overflow(int_type c) override
+        {
+            if (!traits_type::eq_int_type(c, traits_type::eof()))
+                text.push_back(traits_type::to_char_type(c));
+            return traits_type::not_eof(c);
+        }
+
+        std::streamsize xsputn(const char * s, std::streamsize n) override
+        {
+            text.append(s, static_cast<std::size_t>(n));
+            return n;
+        }
+    };
+
+    // whether a standard stream may hold output it has not handed to its
+    // fd: in its own buffer, or, synced with stdio, in the FILE behind it
+    struct unflushed : std::streambuf
+    {
+        static bool in(std::ostream & os, int fd)
+        {
+            std::streambuf * b = os.rdbuf();
+            if (b && (b->*&unflushed::pptr)() != (b->*&unflushed::pbase)())
+                return true;
+#if defined(__GLIBC__)
+            return __fpending(fd == 2 ? stderr : stdout) != 0;
+#else
+            (void)fd;
+            return true;
+#endif
+        }
+    };
+
+    // write n bytes at p to fd in as few calls as the OS allows.  A record
+    // up to PIPE_BUF bytes long goes out in one write(2), which no other
+    // write splits, and takes no lock; a longer one is written under a
+    // lock, so that the records of this process at least come out whole.
+    // On fd 1 or 2, what the program wrote to std::cout or std::cerr
+    // before is flushed first, so that it comes out first, under the lock
+    // too, as two threads must not flush a stream at once.
+    inline void publish(int fd, const char * p, std::size_t n)
+    {
+#if defined(PIPE_BUF)
+        const std::size_t atomic = PIPE_BUF;
+#else
+        const std::size_t atomic = 512;
+#endif
+        static std::mutex m;
+        std::unique_lock<std::mutex> hold(m, std::defer_lock);
+        if (fd == 1 || fd == 2) {
+            std::ostream & os = fd == 2 ? std::cerr : std::cout;
+            if (unflushed::in(os, fd)) {
+                hold.lock();
+                os.flush();
+            }
+        }
+        if (n > atomic && !hold.owns_lock())
+            hold.lock();
+#if defined(_WIN32)
+        HANDLE h = GetStdHandle(fd == 2 ? STD_ERROR_HANDLE : STD_OUTPUT_HANDLE);
+        DWORD written = 0;
+        WriteFile(h, p, static_cast<DWORD>(n), &written, nullptr);
+#else
+        while (n) {
+            ssize_t k = ::write(fd, p, n);
+            if (k < 0) {
+                if (errno == EINTR)
+                    continue;
+                return;
+            }
+            p += k;
+            n -= static_cast<std::size_t>(k);
+        }
+#endif
+    }
+
+    // One record of colored output, rendered into a buffer private to the
+    // calling thread and published with a single write when it goes out of
+    // scope, so that records from different threads never interleave and
+    // colors never bleed from one into another:
+    //
+    //     dye::line() << "worker " << id << ": " << dye::red(error);
+    //
+    // The record is colored as the standard stream on the same fd would
+    // color it: in escape sequences whatever the backend, or not at all when
+    // that stream is muted.  It ends with a newline and, if colored, with the
+    // terminal back in its default colors.  Only one line per thread may be
+    // open at a time.  The record bypasses the std::cout (or std::cerr)
+    // buffer: text written there before a record is flushed ahead of it, but
+    // text another thread writes while the record is out may land on either
+    // side.
+    class line
+    {
+        struct staging
+        {
+            string_buffer buf;
+            std::ostream os;
+
+            staging() : os(&buf)
+            {
+                hue::escaped(os) = 1;
+#if defined(_WIN32)
+                // let the console interpret the escape sequences we publish
+                for (DWORD id : {STD_OUTPUT_HANDLE, STD_ERROR_HANDLE}) {
+                    HANDLE h = GetStdHandle(id);
+                    DWORD mode = 0;
+                    if (GetConsoleMode(h, &mode))
+                        SetConsoleMode(h, mode | 0x0004);   // ENABLE_VIRTUAL_TERMINAL_PROCESSING
+                }
+#endif
+            }
+        };
+
+        static staging & local()
+        {
+            static thread_local staging s;
+            return s;
+        }
+
+        int fd;
+        std::ostream & os;
+
+    public:
+        explicit line(int fd = 1) : fd(fd), os(local().os)
+        {
+            local().buf.str().clear();
+            hue::shadow(os) = 0;
+            // colored, as richly and as fully, as the standard stream on
+            // the same fd
+            std::ostream & target = fd == 2 ? std::cerr : std::cout;
+            hue::muted(os) = hue::muted(target);
+            hue::depth(os) = hue::depth(target);
+            hue::ansi::full(os) = hue::ansi::full(target);
+        }
+
+        line(const line &) = delete;
+        line & operator=(const line &) = delete;
+
+        ~line()
+        {
+            if (!hue::muted(os) && hue::get(os) != hue::DEFAULT_COLOR)
+                hue::reset(os);
+            os.put('\n');
+            std::string & text = local().buf.str();
+            publish(fd, text.data(), text.size());
+        }
+
+        template<typename T>
+        line & operator<<(const T & t)
+        {
+            os << t;
+            return *this;
+        }
+
+        line & operator<<(std::ostream & (*manip)(std::ostream &))
+        {
+            manip(os);
+            return *this;
+        }
+
+        // what has been rendered so far, without the closing reset and newline
+        const std::string & str() const
+        {
+            return local().buf.str();
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,261 @@
+#ifndef COLOR_PARALLEL_HPP
+#define COLOR_PARALLEL_HPP
+
+#include "color_highlight.hpp"
+#include "color_line.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+namespace dye
+{
+    // A fixed set of worker threads, each with a queue of its own.  A worker
+    // runs the newest task in its own queue and, once that is empty, steals
+    // the oldest from the others, so uneven tasks spread over every thread.
+    // Tasks still queued when the pool is destroyed are run first.
+    class pool
+    {
+        struct queue
+        {
+            std::mutex m;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        struct worker
+        {
+            const pool * owner;
+            std::size_t index;
+        };
+
+        std::vector<std::unique_ptr<queue>> queues;
+        std::vector<std::thread> threads;
+        std::atomic<std::size_t> next;      // the queue for the next task from outside
+        std::atomic<std::size_t> pending;   // queued and not yet taken
+        std::mutex m;
+        std::condition_variable wake;
+        bool stopping;
+
+    public:
+        // one thread per hardware thread if threads is 0
+        explicit pool(unsigned threads = 0)
+            : next(0), pending(0), stopping(false)
+        {
+            if (!threads)
+                threads = std::thread::hardware_concurrency();
+            if (!threads)
+                threads = 1;
+            for (unsigned i = 0; i != threads; ++i)
+                queues.emplace_back(new queue);
+            for (unsigned i = 0; i != threads; ++i)
+                this->threads.emplace_back([this, i] { run(i); });
+        }
+
+        pool(const pool &) = delete;
+        pool & operator=(const pool &) = delete;
+
+        ~pool()
+        {
+            {
+                std::lock_guard<std::mutex> g(m);
+                stopping = true;
+            }
+            wake.notify_all();
+            for (auto & t : threads)
+                t.join();
+        }
+
+        unsigned size() const
+        {
+            return static_cast<unsigned>(queues.size());
+        }
+
+        // a task submitted by one of the workers goes to its own queue
+        void submit(std::function<void()> task)
+        {
+            worker & w = self();
+            std::size_t i = w.owner == this ? w.index : next.fetch_add(1) % queues.size();
+            {
+                std::lock_guard<std::mutex> g(queues[i]->m);
+                queues[i]->tasks.push_back(std::move(task));
+            }
+            {
+                // under m, so that a worker going to sleep cannot miss it
+                std::lock_guard<std::mutex> g(m);
+                pending.fetch_add(1);
+            }
+            wake.notify_one();
+        }
+
+        // run one queued task on the calling thread; false if there was none
+        bool help()
+        {
+            worker & w = self();
+            std::function<void()> task;
+            bool own = w.owner == this;
+            if (!take(own ? w.index : 0, own, task))
+                return false;
+            task();
+            return true;
+        }
+
+    private:
+        static worker & self()
+        {
+            static thread_local worker w = {nullptr, 0};
+            return w;
+        }
+
+        // the newest task of queue i if it is our own, else the oldest of any
+        bool take(std::size_t i, bool own, std::function<void()> & task)
+        {
+            if (!pending.load())
+                return false;
+            for (std::size_t k = 0; k != queues.size(); ++k) {
+                queue & q = *queues[(i + k) % queues.size()];
+                std::lock_guard<std::mutex> g(q.m);
+                if (q.tasks.empty())
+                    continue;
+                if (own && k == 0) {
+                    task = std::move(q.tasks.back());
+                    q.tasks.pop_back();
+                }
+                else {
+                    task = std::move(q.tasks.front());
+                    q.tasks.pop_front();
+                }
+                pending.fetch_sub(1);
+                return true;
+            }
+            return false;
+        }
+
+        void run(std::size_t i)
+        {
+            self() = worker{this, i};
+            for (;;) {
+                std::function<void()> task;
+                if (take(i, true, task)) {
+                    task();
+                    continue;
+                }
+                std::unique_lock<std::mutex> lk(m);
+                wake.wait(lk, [this] { return pending.load() != 0 || stopping; });
+                if (stopping && pending.load() == 0)
+                    return;
+            }
+        }
+    };
+
+    // Writes to os exactly what marker.highlight(p, n, os) does, using the
+    // threads of workers.  The input is cut at line breaks into chunks of
+    // about chunk bytes, each highlighted into a buffer of its own; the
+    // calling thread writes the buffers out in order and runs queued chunks
+    // itself while it waits.  No keyword or number runs over a line break,
+    // so every chunk starts and ends in the stream's own color, and no
+    // chunk needs to know what came before it.
+    //
+    // Keywords holding line breaks, and a Win32 console that takes its
+    // colors by call rather than in the text, fall back to the sequential
+    // path, as does the recording backend, which keeps changes per thread.
+    // At most four chunks per thread are held at a time.
+    inline void highlight(const highlighter & marker, const char * p, std::size_t n,
+                          std::ostream & os, pool & workers, std::size_t chunk = 1 << 20)
+    {
+        bool serial = !marker.line_bound() || n <= chunk || !chunk || hue::muted(os);
+#if defined(COLOR_CONSOLE_WIN32)
+        serial = serial || !hue::escaped(os);
+#elif defined(COLOR_CONSOLE_RECORD)
+        serial = true;
+#endif
+        if (serial) {
+            marker.highlight(p, n, os);
+            return;
+        }
+
+        // where each chunk ends, just past a line break or at the end
+        std::vector<std::size_t> ends;
+        for (std::size_t a = 0; a != n; ) {
+            std::size_t b = n - a > chunk ? a + chunk : n;
+            if (b != n) {
+                const void * nl = std::memchr(p + b - 1, '\n', n - b + 1);
+                b = nl ? static_cast<std::size_t>(static_cast<const char *>(nl) - p) + 1 : n;
+            }
+            ends.push_back(b);
+            a = b;
+        }
+
+        struct slot
+        {
+            string_buffer buf;
+            bool done;
+        };
+
+        const int plain = hue::get(os);
+        const long colors = hue::depth(os);
+        const long full = hue::ansi::full(os);
+        const std::size_t window = 4 * (static_cast<std::size_t>(workers.size()) + 1);
+        std::unique_ptr<slot[]> slots(new slot[window]);
+        std::mutex m;
+        std::condition_variable ready;
+
+        auto start = [&](std::size_t k)
+        {
+            slots[k % window].done = false;
+            workers.submit([&, k]
+                {
+                    slot & s = slots[k % window];
+                    std::size_t a = k ? ends[k - 1] : 0;
+                    s.buf.str().clear();
+                    std::ostream out(&s.buf);
+                    hue::escaped(out) = 1;
+                    hue::depth(out) = colors;
+                    hue::ansi::full(out) = full;
+                    hue::shadow(out) = plain + 1;
+                    marker.highlight(p + a, ends[k] - a, out);
+                    // notify under the lock, as the caller may return as
+                    // soon as it sees the last chunk done
+                    std::lock_guard<std::mutex> g(m);
+                    s.done = true;
+                    ready.notify_all();
+                });
+        };
+
+        for (std::size_t k = 0; k != ends.size() && k != window; ++k)
+            start(k);
+        for (std::size_t k = 0; k != ends.size(); ++k) {
+            slot & s = slots[k % window];
+            for (;;) {
+                {
+                    std::lock_guard<std::mutex> g(m);
+                    if (s.done)
+                        break;
+                }
+                if (!workers.help()) {
+                    std::unique_lock<std::mutex> lk(m);
+                    ready.wait(lk, [&s] { return s.done; });
+                    break;
+                }
+            }
+            const std::string & text = s.buf.str();
+            os.write(text.data(), static_cast<std::streamsize>(text.size()));
+            if (k + window < ends.size())
+                start(k + window);
+        }
+    }
+
+    inline void highlight(const highlighter & marker, const std::string & s,
+                          std::ostream & os, pool & workers)
+    {
+        highlight(marker, s.data(), s.size(), os, workers);
+    }
+}
+
+#endif
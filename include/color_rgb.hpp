@@ -0,0 +1,69 @@
+#ifndef COLOR_RGB_HPP
+#define COLOR_RGB_HPP
+
+#include "color.hpp"
+#include "color_scan.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace hue
+{
+    namespace palette
+    {
+        // one table read per pixel
+        inline void quantize_scalar(const unsigned char * table, const std::uint32_t * rgb, std::size_t n,
+                                    unsigned char * out)
+        {
+            for (std::size_t i = 0; i != n; ++i)
+                out[i] = table[cell(rgb[i])];
+        }
+
+#if COLOR_CONSOLE_X86
+        // the table entries of eight pixels, one to a 32-bit lane
+        COLOR_CONSOLE_AVX2
+        inline __m256i gather_avx2(const unsigned char * table, const std::uint32_t * rgb)
+        {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rgb));
+            __m256i k = _mm256_or_si256(
+                _mm256_and_si256(_mm256_srli_epi32(v, 9), _mm256_set1_epi32(0x7c00)),
+                _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(v, 6), _mm256_set1_epi32(0x3e0)),
+                                _mm256_and_si256(_mm256_srli_epi32(v, 3), _mm256_set1_epi32(0x1f))));
+            __m256i words = _mm256_i32gather_epi32(reinterpret_cast<const int *>(table), k, 1);
+            return _mm256_and_si256(words, _mm256_set1_epi32(0xff));
+        }
+
+        // 32 pixels a loop, the table read with gathers; SSE2 has no gather,
+        // so below AVX2 the scalar loop is as good as it gets
+        COLOR_CONSOLE_AVX2
+        inline void quantize_avx2(const unsigned char * table, const std::uint32_t * rgb, std::size_t n,
+                                  unsigned char * out)
+        {
+            const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+            std::size_t i = 0;
+            for (; i + 32 <= n; i += 32) {
+                __m256i ab = _mm256_packus_epi32(gather_avx2(table, rgb + i), gather_avx2(table, rgb + i + 8));
+                __m256i cd = _mm256_packus_epi32(gather_avx2(table, rgb + i + 16), gather_avx2(table, rgb + i + 24));
+                __m256i bytes = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(ab, cd), order);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), bytes);
+            }
+            quantize_scalar(table, rgb + i, n - i, out + i);
+        }
+#endif
+    }
+
+    // the nearest console color, or with colors at 256 the nearest xterm
+    // entry, of each of n RGB values, 0xrrggbb, written to out
+    inline void quantize(const std::uint32_t * rgb, std::size_t n, unsigned char * out, long colors = 16)
+    {
+        const unsigned char * table = colors == 256 ? palette::xterm_table() : palette::console_table();
+#if COLOR_CONSOLE_X86
+        if (dye::simd::active() == dye::simd::level::avx2) {
+            palette::quantize_avx2(table, rgb, n, out);
+            return;
+        }
+#endif
+        palette::quantize_scalar(table, rgb, n, out);
+    }
+}
+
+#endif // COLOR_RGB_HPP
@@ -0,0 +1,852 @@
+#ifndef COLOR_RULES_HPP
+#define COLOR_RULES_HPP
+
+#include "color.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace dye
+{
+    // Colors whatever matches any of a set of patterns, each with its own
+    // color and priority.  All the patterns are compiled together into one
+    // DFA, so the work on a line hardly grows with the number of rules:
+    //
+    //     dye::ruleset rules;
+    //     rules.add("ERROR|FATAL", hue::LIGHT_RED);
+    //     rules.add("[0-9]+(\\.[0-9]+)?%?", hue::YELLOW);
+    //     rules.add("(?i)timeout", hue::LIGHT_PURPLE, 1);
+    //     rules.highlight(std::cin, std::cout);
+    //
+    // Patterns take literals, '.', classes such as [a-z_] and [^,], the
+    // escapes \d \w \s \D \W \S \t \n \r \xHH, groups, '|', and the
+    // repeats * + ? {m} {m,} {m,n}.  Any other byte after a backslash is
+    // taken as itself, save a letter or digit: a pattern with \b or \1 is
+    // refused rather than read as "b" or "1".  A leading '^' or trailing
+    // '$' ties a pattern to the start or end of the line, and a leading
+    // "(?i)" makes it case-insensitive.  Where matches overlap, the one
+    // starting first wins, then the longest, then the one of higher
+    // priority, then the rule added first.  Empty matches are ignored.
+    //
+    // The DFA is compiled at the first match after rules are added, not at
+    // each add(), so a thousand rules cost one compile.  A line is read
+    // twice.  A DFA run backwards over it, unanchored, marks every byte at
+    // which some match starts; the forward DFA then runs only from those
+    // marks, to find the longest match there.
+    class ruleset
+    {
+        typedef std::bitset<256> byte_set;
+
+        // the NFA: a node either takes one byte in a set or none at all
+        struct node
+        {
+            enum kind_t { BYTE, SPLIT, EMPTY, ACCEPT } kind;
+            byte_set set;
+            int out1;
+            int out2;
+        };
+
+        // a parsed pattern
+        struct ast
+        {
+            enum op_t { SET, CAT, ALT, REPEAT, NONE } op;
+            byte_set set;
+            int a;
+            int b;
+            int min;
+            int max;            // -1 for no limit
+        };
+
+        struct rule
+        {
+            int color;
+            int priority;
+            bool at_start;      // the pattern began with '^'
+            bool at_end;        // the pattern ended with '$'
+            int start;          // its first NFA node
+            int back;           // the first node of its NFA read backwards
+        };
+
+        enum : unsigned char
+        {
+            ANYWHERE = 1,       // a match starts here
+            AT_START = 2        // a match starts here if here is the start of the line
+        };
+
+        // the DFA; state 0 is dead, and rows are width entries long
+        struct tables
+        {
+            unsigned char classes[256];
+            int width;
+            // (state * width + class) -> the next state's row, state * width,
+            // negated if some rule matches there
+            std::vector<std::int32_t> delta;
+            std::vector<std::int32_t> accept;       // the rule winning in a state, or -1
+            std::vector<std::int32_t> accept_end;   // the same, at the end of the line
+            std::int32_t first;                     // the state at the start of a line
+            std::int32_t rest;                      // the state anywhere else
+            // the DFA run backwards, laid out the same way; marks are ANYWHERE
+            // and AT_START for the byte just read, by row
+            std::vector<std::int32_t> back_delta;
+            std::vector<unsigned char> marks;
+            std::int32_t last;                      // the state at the end of a line
+            std::size_t used;                       // how many of the rules, the first, it has
+        };
+
+        std::vector<node> nfa;
+        std::vector<node> reversed;
+        std::vector<rule> rules;
+        mutable tables dfa;
+        mutable std::atomic<bool> ready;            // dfa has all the rules added
+
+    public:
+        // a DFA of more states than this leaves out the rules from the one
+        // that overflows it on
+        static constexpr std::size_t MAX_STATES = 10000;
+
+        ruleset() : ready(false)
+        {
+        }
+
+        ruleset(const ruleset & rhs) : ready(false)
+        {
+            *this = rhs;
+        }
+
+        ruleset & operator=(const ruleset & rhs)
+        {
+            if (this != &rhs) {
+                std::lock_guard<std::mutex> hold(compiling());
+                nfa = rhs.nfa;
+                reversed = rhs.reversed;
+                rules = rhs.rules;
+                dfa = rhs.dfa;
+                ready.store(rhs.ready.load());
+            }
+            return *this;
+        }
+
+        // false, and the set left as it was, if the pattern is malformed
+        // or too large
+        bool add(const std::string & pattern, int color, int priority = 0)
+        {
+            std::size_t saved = nfa.size();
+            std::size_t saved_reversed = reversed.size();
+            rule r = {color, priority, false, false, 0, 0};
+            std::string p = pattern;
+            bool fold = false;
+            if (p.compare(0, 4, "(?i)") == 0) {
+                fold = true;
+                p.erase(0, 4);
+            }
+            if (!p.empty() && p[0] == '^') {
+                r.at_start = true;
+                p.erase(0, 1);
+            }
+            if (!p.empty() && p.back() == '$' && (p.size() < 2 || p[p.size() - 2] != '\\')) {
+                r.at_end = true;
+                p.pop_back();
+            }
+
+            parser ps(p, fold);
+            int root = ps.parse();
+            if (root < 0)
+                return false;
+            int id = static_cast<int>(rules.size());
+            nfa.push_back(node{node::ACCEPT, byte_set(), id, -1});
+            reversed.push_back(node{node::ACCEPT, byte_set(), id, -1});
+            r.start = compile(nfa, ps.tree, root, static_cast<int>(nfa.size()) - 1, false);
+            r.back = compile(reversed, ps.tree, root, static_cast<int>(reversed.size()) - 1, true);
+            if (r.start < 0 || r.back < 0) {
+                nfa.resize(saved);
+                reversed.resize(saved_reversed);
+                return false;
+            }
+            rules.push_back(r);
+            ready.store(false);
+            return true;
+        }
+
+        std::size_t size() const
+        {
+            return rules.size();
+        }
+
+        // compile the DFA now rather than at the next match; false if it
+        // had to leave out the last rules to stay within MAX_STATES
+        bool compile() const
+        {
+            return compiled().used == rules.size();
+        }
+
+        std::size_t states() const
+        {
+            return compiled().accept.size();
+        }
+
+        // call f(start, end, color) for each match in the n bytes at p, a
+        // line, in order
+        template<typename F>
+        void match(const char * p, std::size_t n, F f) const
+        {
+            const tables & t = compiled();
+            const unsigned char * m = mark(t, p, n);
+            const std::int32_t * d = t.delta.data();
+            std::size_t i = 0;
+            while (i < n) {
+                if (!(m[i] & (i ? ANYWHERE : ANYWHERE | AT_START))) {
+                    ++i;
+                    continue;
+                }
+                std::int32_t s = i ? t.rest : t.first;
+                std::size_t best = 0;
+                std::int32_t winner = -1;
+                std::size_t j = i;
+                while (j != n) {
+                    std::int32_t next = d[s + t.classes[static_cast<unsigned char>(p[j])]];
+                    if (!next)
+                        break;
+                    ++j;
+                    s = next;
+                    if (next < 0) {
+                        s = -next;
+                        best = j - i;
+                        winner = t.accept[static_cast<std::size_t>(s / t.width)];
+                    }
+                }
+                if (j == n) {
+                    std::int32_t r = t.accept_end[static_cast<std::size_t>(s / t.width)];
+                    if (r >= 0 && (n - i > best || better(r, winner))) {
+                        best = n - i;
+                        winner = r;
+                    }
+                }
+                if (winner >= 0) {
+                    f(i, i + best, rules[static_cast<std::size_t>(winner)].color);
+                    i += best;
+                }
+                else {
+                    ++i;
+                }
+            }
+        }
+
+        // write one line with its matches in color, leaving the stream in
+        // the color it was in
+        void colorize(const char * p, std::size_t n, std::ostream & os) const
+        {
+            if (hue::muted(os)) {
+                os.write(p, static_cast<std::streamsize>(n));
+                return;
+            }
+            const int plain = hue::get(os);
+            int current = plain;
+            std::size_t done = 0;
+            match(p, n, [&](std::size_t a, std::size_t b, int color)
+                {
+                    if (a != done) {
+                        if (current != plain)
+                            hue::set(os, current = plain);
+                        os.write(p + done, static_cast<std::streamsize>(a - done));
+                    }
+                    if (current != color)
+                        hue::set(os, current = color);
+                    os.write(p + a, static_cast<std::streamsize>(b - a));
+                    done = b;
+                });
+            if (current != plain)
+                hue::set(os, plain);
+            os.write(p + done, static_cast<std::streamsize>(n - done));
+        }
+
+        void colorize(const std::string & line, std::ostream & os) const
+        {
+            colorize(line.data(), line.size(), os);
+        }
+
+        // colorize is line by line
+        void highlight(std::istream & is, std::ostream & os) const
+        {
+            std::string line;
+            while (std::getline(is, line)) {
+                colorize(line, os);
+                if (!is.eof())
+                    os.put('\n');
+            }
+        }
+
+    private:
+        // one lock for every set, taken only to compile or copy one
+        static std::mutex & compiling()
+        {
+            static std::mutex m;
+            return m;
+        }
+
+        // the DFA, compiled first if rules have been added since; if all
+        // of them would make too many states, as many of the first as fit
+        const tables & compiled() const
+        {
+            if (ready.load(std::memory_order_acquire))
+                return dfa;
+            std::lock_guard<std::mutex> hold(compiling());
+            if (!ready.load(std::memory_order_relaxed)) {
+                if (!build(rules.size())) {
+                    std::size_t fit = 0;
+                    std::size_t over = rules.size();
+                    while (over - fit > 1) {
+                        std::size_t mid = fit + (over - fit) / 2;
+                        if (build(mid))
+                            fit = mid;
+                        else
+                            over = mid;
+                    }
+                    build(fit);
+                }
+                ready.store(true, std::memory_order_release);
+            }
+            return dfa;
+        }
+
+        // the marks for each of the n bytes at p, from the backward DFA
+        static const unsigned char * mark(const tables & t, const char * p, std::size_t n)
+        {
+            static thread_local std::vector<unsigned char> m;
+            if (m.size() < n)
+                m.resize(n);
+            const std::int32_t * d = t.back_delta.data();
+            const unsigned char * flags = t.marks.data();
+            std::int32_t s = t.last;
+            for (std::size_t k = n; k--; ) {
+                s = d[s + t.classes[static_cast<unsigned char>(p[k])]];
+                m[k] = flags[s];
+            }
+            return m.data();
+        }
+
+        // whether rule a beats rule b on a match of the same length
+        bool better(std::int32_t a, std::int32_t b) const
+        {
+            if (b < 0)
+                return true;
+            const rule & x = rules[static_cast<std::size_t>(a)];
+            const rule & y = rules[static_cast<std::size_t>(b)];
+            return x.priority > y.priority || (x.priority == y.priority && a < b);
+        }
+
+        class parser
+        {
+            const std::string & s;
+            std::size_t i;
+            bool fold;
+            bool bad;
+
+        public:
+            std::vector<ast> tree;
+
+            parser(const std::string & s, bool fold) : s(s), i(0), fold(fold), bad(false)
+            {
+            }
+
+            // the root of the tree, or -1 on a syntax error
+            int parse()
+            {
+                int root = alternation();
+                return bad || i != s.size() ? -1 : root;
+            }
+
+        private:
+            int make(ast::op_t op, int a = -1, int b = -1)
+            {
+                tree.push_back(ast{op, byte_set(), a, b, 0, 0});
+                return static_cast<int>(tree.size()) - 1;
+            }
+
+            int make(const byte_set & set)
+            {
+                int k = make(ast::SET);
+                tree[static_cast<std::size_t>(k)].set = set;
+                if (fold)
+                    for (int c = 'a'; c <= 'z'; ++c)
+                        if (set[c] || set[c - 'a' + 'A'])
+                            tree[static_cast<std::size_t>(k)].set.set(c).set(c - 'a' + 'A');
+                return k;
+            }
+
+            int alternation()
+            {
+                int a = sequence();
+                while (!bad && i < s.size() && s[i] == '|') {
+                    ++i;
+                    a = make(ast::ALT, a, sequence());
+                }
+                return a;
+            }
+
+            int sequence()
+            {
+                int a = -1;
+                while (!bad && i < s.size() && s[i] != '|' && s[i] != ')') {
+                    int b = repeat();
+                    a = a < 0 ? b : make(ast::CAT, a, b);
+                }
+                return a < 0 ? make(ast::NONE) : a;
+            }
+
+            int repeat()
+            {
+                int a = atom();
+                while (!bad && i < s.size()) {
+                    int min, max;
+                    char c = s[i];
+                    if (c == '*')
+                        min = 0, max = -1;
+                    else if (c == '+')
+                        min = 1, max = -1;
+                    else if (c == '?')
+                        min = 0, max = 1;
+                    else if (c != '{' || !bounds(min, max))
+                        break;
+                    ++i;
+                    a = make(ast::REPEAT, a);
+                    tree[static_cast<std::size_t>(a)].min = min;
+                    tree[static_cast<std::size_t>(a)].max = max;
+                }
+                return a;
+            }
+
+            // {m}, {m,} or {m,n} at i; i is left on the closing brace
+            bool bounds(int & min, int & max)
+            {
+                std::size_t k = i + 1;
+                if (!number(k, min))
+                    return false;
+                max = min;
+                if (k < s.size() && s[k] == ',') {
+                    ++k;
+                    max = -1;
+                    if (k < s.size() && s[k] != '}' && !number(k, max))
+                        return false;
+                }
+                if (k >= s.size() || s[k] != '}' || (max >= 0 && max < min)) {
+                    bad = true;
+                    return false;
+                }
+                i = k;
+                return true;
+            }
+
+            bool number(std::size_t & k, int & n)
+            {
+                if (k >= s.size() || s[k] < '0' || s[k] > '9')
+                    return false;
+                for (n = 0; k < s.size() && s[k] >= '0' && s[k] <= '9'; ++k)
+                    if ((n = n * 10 + (s[k] - '0')) > 1000)
+                        bad = true;
+                return !bad;
+            }
+
+            int atom()
+            {
+                char c = s[i++];
+                byte_set set;
+                switch (c) {
+                case '(': {
+                    if (s.compare(i, 2, "?:") == 0)
+                        i += 2;
+                    int a = alternation();
+                    if (i >= s.size() || s[i] != ')')
+                        bad = true;
+                    ++i;
+                    return a;
+                }
+                case '[':
+                    return make(bracket());
+                case '.':
+                    set.set();
+                    set.reset('\n');
+                    return make(set);
+                case '\\':
+                    return make(escape());
+                case '*': case '+': case '?': case '^': case '$': case ')':
+                    bad = true;
+                    return make(ast::NONE);
+                default:
+                    set.set(static_cast<unsigned char>(c));
+                    return make(set);
+                }
+            }
+
+            // the class after a backslash at i
+            byte_set escape()
+            {
+                byte_set set;
+                if (i >= s.size()) {
+                    bad = true;
+                    return set;
+                }
+                char c = s[i++];
+                switch (c) {
+                case 'd': case 'D':
+                    for (int b = '0'; b <= '9'; ++b)
+                        set.set(b);
+                    break;
+                case 'w': case 'W':
+                    for (int b = 0; b != 256; ++b)
+                        if ((b >= '0' && b <= '9') || (b >= 'a' && b <= 'z') || (b >= 'A' && b <= 'Z') || b == '_')
+                            set.set(b);
+                    break;
+                case 's': case 'S':
+                    for (char b : {' ', '\t', '\n', '\r', '\v', '\f'})
+                        set.set(static_cast<unsigned char>(b));
+                    break;
+                case 't':
+                    return set.set('\t');
+                case 'n':
+                    return set.set('\n');
+                case 'r':
+                    return set.set('\r');
+                case 'x': {
+                    int v = 0;
+                    for (int k = 0; k != 2; ++k, ++i) {
+                        int h = i < s.size() ? hex(s[i]) : -1;
+                        if (h < 0) {
+                            bad = true;
+                            return set;
+                        }
+                        v = v * 16 + h;
+                    }
+                    return set.set(static_cast<std::size_t>(v));
+                }
+                default:
+                    if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9'))
+                        bad = true;
+                    return set.set(static_cast<unsigned char>(c));
+                }
+                return c >= 'A' && c <= 'Z' ? ~set : set;
+            }
+
+            static int hex(char c)
+            {
+                return c >= '0' && c <= '9' ? c - '0' :
+                       c >= 'a' && c <= 'f' ? c - 'a' + 10 :
+                       c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+            }
+
+            // a class, from just after its '['
+            byte_set bracket()
+            {
+                byte_set set;
+                bool negate = i < s.size() && s[i] == '^';
+                if (negate)
+                    ++i;
+                bool first = true;
+                while (i < s.size() && (s[i] != ']' || first)) {
+                    first = false;
+                    if (s[i] == '\\') {
+                        ++i;
+                        byte_set e = escape();
+                        if (e.count() != 1 || i >= s.size() || s[i] != '-') {
+                            set |= e;
+                            continue;
+                        }
+                        // an escaped byte may start a range
+                        --i;
+                        std::size_t at = 0;
+                        while (!e[at])
+                            ++at;
+                        range(set, static_cast<unsigned char>(at));
+                        continue;
+                    }
+                    range(set, static_cast<unsigned char>(s[i]));
+                }
+                if (i >= s.size()) {
+                    bad = true;
+                    return set;
+                }
+                ++i;
+                return negate ? ~set : set;
+            }
+
+            // a single byte lo at i, or a range from it
+            void range(byte_set & set, unsigned char lo)
+            {
+                ++i;
+                if (i + 1 < s.size() && s[i] == '-' && s[i + 1] != ']') {
+                    unsigned char hi = static_cast<unsigned char>(s[i + 1]);
+                    i += 2;
+                    if (hi == '\\' && i < s.size()) {
+                        byte_set e = escape();
+                        if (e.count() != 1) {
+                            bad = true;
+                            return;
+                        }
+                        hi = 0;
+                        while (!e[hi])
+                            ++hi;
+                    }
+                    if (hi < lo) {
+                        bad = true;
+                        return;
+                    }
+                    for (int b = lo; b <= hi; ++b)
+                        set.set(static_cast<std::size_t>(b));
+                }
+                else {
+                    set.set(lo);
+                }
+            }
+        };
+
+        static int add_node(std::vector<node> & g, node::kind_t kind, int out1, int out2 = -1)
+        {
+            g.push_back(node{kind, byte_set(), out1, out2});
+            return static_cast<int>(g.size()) - 1;
+        }
+
+        // Thompson's construction, back to front: into g, the NFA for
+        // tree[k], or for it read backwards, followed by next; -1 if it
+        // grows too large
+        static int compile(std::vector<node> & g, const std::vector<ast> & tree, int k, int next, bool back)
+        {
+            if (g.size() > 64 * MAX_STATES)
+                return -1;
+            const ast & t = tree[static_cast<std::size_t>(k)];
+            switch (t.op) {
+            case ast::SET: {
+                int n = add_node(g, node::BYTE, next);
+                g[static_cast<std::size_t>(n)].set = t.set;
+                return n;
+            }
+            case ast::CAT: {
+                int b = compile(g, tree, back ? t.a : t.b, next, back);
+                return b < 0 ? -1 : compile(g, tree, back ? t.b : t.a, b, back);
+            }
+            case ast::ALT: {
+                int a = compile(g, tree, t.a, next, back);
+                int b = a < 0 ? -1 : compile(g, tree, t.b, next, back);
+                return b < 0 ? -1 : add_node(g, node::SPLIT, a, b);
+            }
+            case ast::REPEAT: {
+                // the optional copies past min, then min required ones
+                if (t.max < 0) {
+                    int loop = add_node(g, node::SPLIT, -1, next);
+                    int body = compile(g, tree, t.a, loop, back);
+                    if (body < 0)
+                        return -1;
+                    g[static_cast<std::size_t>(loop)].out1 = body;
+                    next = loop;
+                }
+                else {
+                    for (int c = t.min; c < t.max; ++c) {
+                        int body = compile(g, tree, t.a, next, back);
+                        if (body < 0)
+                            return -1;
+                        next = add_node(g, node::SPLIT, body, next);
+                    }
+                }
+                for (int c = 0; c < t.min; ++c)
+                    if ((next = compile(g, tree, t.a, next, back)) < 0)
+                        return -1;
+                return next;
+            }
+            case ast::NONE:
+                return add_node(g, node::EMPTY, next);
+            }
+            return -1;
+        }
+
+        // the BYTE and ACCEPT nodes reachable from the nodes in set without
+        // taking a byte, sorted
+        static void closure(const std::vector<node> & g, std::vector<int> & set)
+        {
+            std::vector<int> stack(set);
+            std::vector<bool> seen(g.size());
+            set.clear();
+            while (!stack.empty()) {
+                int k = stack.back();
+                stack.pop_back();
+                if (k < 0 || seen[static_cast<std::size_t>(k)])
+                    continue;
+                seen[static_cast<std::size_t>(k)] = true;
+                const node & n = g[static_cast<std::size_t>(k)];
+                if (n.kind == node::BYTE || n.kind == node::ACCEPT) {
+                    set.push_back(k);
+                }
+                else {
+                    stack.push_back(n.out2);
+                    stack.push_back(n.out1);
+                }
+            }
+            std::sort(set.begin(), set.end());
+        }
+
+        // the nodes of g that the byte c takes the BYTE nodes in set to
+        static std::vector<int> step(const std::vector<node> & g, const std::vector<int> & set, int c)
+        {
+            std::vector<int> next;
+            for (int k : set)
+                if (k >= 0 && g[static_cast<std::size_t>(k)].kind == node::BYTE &&
+                    g[static_cast<std::size_t>(k)].set[static_cast<std::size_t>(c)])
+                    next.push_back(g[static_cast<std::size_t>(k)].out1);
+            return next;
+        }
+
+        // both DFAs for the first n rules, by subset construction, into
+        // dfa; false if either would have too many states
+        bool build(std::size_t n) const
+        {
+            tables & t = dfa;
+            t.used = n;
+            // bytes that no pattern tells apart share a class
+            std::vector<byte_set> sets;
+            for (const auto & k : nfa)
+                if (k.kind == node::BYTE)
+                    sets.push_back(k.set);
+            std::map<std::vector<bool>, unsigned char> ids;
+            for (int c = 0; c != 256; ++c) {
+                std::vector<bool> sig(sets.size());
+                for (std::size_t k = 0; k != sets.size(); ++k)
+                    sig[k] = sets[k][static_cast<std::size_t>(c)];
+                auto it = ids.insert(std::make_pair(sig, static_cast<unsigned char>(ids.size()))).first;
+                t.classes[c] = it->second;
+            }
+            t.width = static_cast<int>(ids.size());
+            std::vector<int> member(static_cast<std::size_t>(t.width));
+            for (int c = 0; c != 256; ++c)
+                member[t.classes[c]] = c;
+
+            std::map<std::vector<int>, std::int32_t> index;
+            std::vector<std::vector<int>> subsets(1);       // the dead state
+            t.delta.assign(static_cast<std::size_t>(t.width), 0);
+            t.accept.assign(1, -1);
+            t.accept_end.assign(1, -1);
+
+            // a start state is kept apart from the same nodes reached later,
+            // as it accepts nothing: empty matches do not count
+            auto state = [&](std::vector<int> set, bool start) -> std::int32_t
+            {
+                closure(nfa, set);
+                if (set.empty())
+                    return 0;
+                if (start)
+                    set.insert(set.begin(), -1);
+                auto it = index.find(set);
+                if (it != index.end())
+                    return it->second;
+                std::int32_t s = static_cast<std::int32_t>(subsets.size()) * t.width;
+                index.insert(std::make_pair(set, s));
+                std::int32_t win = -1;
+                std::int32_t win_end = -1;
+                for (int k : set)
+                    if (!start && nfa[static_cast<std::size_t>(k)].kind == node::ACCEPT) {
+                        std::int32_t r = nfa[static_cast<std::size_t>(k)].out1;
+                        if (!rules[static_cast<std::size_t>(r)].at_end && better(r, win))
+                            win = r;
+                        if (better(r, win_end))
+                            win_end = r;
+                    }
+                subsets.push_back(std::move(set));
+                t.delta.resize(t.delta.size() + static_cast<std::size_t>(t.width), 0);
+                t.accept.push_back(win);
+                t.accept_end.push_back(win_end);
+                return s;
+            };
+
+            std::vector<int> starts_line;
+            std::vector<int> starts_rest;
+            for (std::size_t k = 0; k != n; ++k) {
+                const rule & r = rules[k];
+                starts_line.push_back(r.start);
+                if (!r.at_start)
+                    starts_rest.push_back(r.start);
+            }
+            t.first = state(starts_line, true);
+            t.rest = state(starts_rest, true);
+
+            for (std::size_t done = 1; done != subsets.size(); ++done) {
+                if (subsets.size() > MAX_STATES)
+                    return false;
+                for (int c = 0; c != t.width; ++c) {
+                    std::int32_t next = state(step(nfa, subsets[done], member[static_cast<std::size_t>(c)]), false);
+                    if (next && t.accept[static_cast<std::size_t>(next / t.width)] >= 0)
+                        next = -next;
+                    t.delta[done * static_cast<std::size_t>(t.width) + static_cast<std::size_t>(c)] = next;
+                }
+            }
+
+            return build_backwards(n, member);
+        }
+
+        // Backwards, a match may start anywhere, so every state also holds
+        // the rules' last nodes; a state holds only the nodes reached by a
+        // byte, so it marks no empty match.  The state at the end of the
+        // line holds the '$' rules besides, and is kept apart.
+        bool build_backwards(std::size_t n, const std::vector<int> & member) const
+        {
+            tables & t = dfa;
+            std::vector<int> from_end;
+            std::vector<int> from_rest;
+            for (std::size_t k = 0; k != n; ++k) {
+                const rule & r = rules[k];
+                from_end.push_back(r.back);
+                if (!r.at_end)
+                    from_rest.push_back(r.back);
+            }
+            closure(reversed, from_end);
+            closure(reversed, from_rest);
+
+            std::map<std::vector<int>, std::int32_t> index;
+            std::vector<std::vector<int>> subsets;
+            t.back_delta.clear();
+            t.marks.clear();
+
+            auto state = [&](std::vector<int> set, bool end) -> std::int32_t
+            {
+                closure(reversed, set);
+                if (end)
+                    set.insert(set.begin(), -1);
+                auto it = index.find(set);
+                if (it != index.end())
+                    return it->second;
+                std::int32_t s = static_cast<std::int32_t>(t.back_delta.size());
+                index.insert(std::make_pair(set, s));
+                unsigned char flags = 0;
+                for (int k : set)
+                    if (k >= 0 && reversed[static_cast<std::size_t>(k)].kind == node::ACCEPT)
+                        flags |= rules[static_cast<std::size_t>(reversed[static_cast<std::size_t>(k)].out1)].at_start
+                                 ? AT_START : ANYWHERE;
+                subsets.push_back(std::move(set));
+                t.back_delta.resize(t.back_delta.size() + static_cast<std::size_t>(t.width), 0);
+                t.marks.resize(t.back_delta.size(), 0);
+                t.marks[static_cast<std::size_t>(s)] = flags;
+                return s;
+            };
+
+            t.last = state(std::vector<int>(), true);
+            for (std::size_t done = 0; done != subsets.size(); ++done) {
+                if (subsets.size() > MAX_STATES)
+                    return false;
+                // the rules may start over at every byte
+                std::vector<int> set = subsets[done];
+                const std::vector<int> & fresh = done == 0 ? from_end : from_rest;
+                set.insert(set.end(), fresh.begin(), fresh.end());
+                for (int c = 0; c != t.width; ++c) {
+                    std::int32_t next = state(step(reversed, set, member[static_cast<std::size_t>(c)]), false);
+                    t.back_delta[done * static_cast<std::size_t>(t.width) + static_cast<std::size_t>(c)] = next;
+                }
+            }
+            return true;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,324 @@
+#ifndef COLOR_SCAN_HPP
+#define COLOR_SCAN_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// x86 builds that may use SSE2 (all x86-64 builds, 32-bit ones compiled for
+// it) get it everywhere and AVX2 where the CPU has it, picked at run time;
+// everything else, -mno-sse2 included, classifies one byte at a time
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define COLOR_CONSOLE_X86 1
+#   include <immintrin.h>
+#   if defined(_MSC_VER) && !defined(__clang__)
+#       include <intrin.h>
+#       define COLOR_CONSOLE_AVX2
+#   else
+#       define COLOR_CONSOLE_AVX2 __attribute__((target("avx2")))
+#   endif
+#else
+#   define COLOR_CONSOLE_X86 0
+#endif
+
+namespace dye
+{
+    namespace simd
+    {
+        enum class level
+        {
+            scalar,
+            sse2,
+            avx2
+        };
+
+        // the best the CPU can do
+        inline level detect()
+        {
+#if COLOR_CONSOLE_X86
+#   if defined(_MSC_VER) && !defined(__clang__)
+            int r[4];
+            __cpuid(r, 0);
+            if (r[0] >= 7) {
+                __cpuid(r, 1);
+                bool osxsave = (r[2] & (1 << 27)) != 0;
+                bool avx = (r[2] & (1 << 28)) != 0;
+                __cpuidex(r, 7, 0);
+                if (osxsave && avx && (r[1] & (1 << 5)) && (_xgetbv(0) & 6) == 6)
+                    return level::avx2;
+            }
+            return level::sse2;
+#   else
+            return __builtin_cpu_supports("avx2") ? level::avx2 : level::sse2;
+#   endif
+#else
+            return level::scalar;
+#endif
+        }
+
+        // the level in use; lower it to compare one path with another
+        inline level & active()
+        {
+            static level l = detect();
+            return l;
+        }
+
+        inline const char * name(level l)
+        {
+            return l == level::avx2 ? "avx2" : l == level::sse2 ? "sse2" : "scalar";
+        }
+
+        inline unsigned lowest_bit(std::uint64_t m)
+        {
+#if defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+            unsigned long i;
+            _BitScanForward64(&i, m);
+            return i;
+#elif defined(__GNUC__)
+            return static_cast<unsigned>(__builtin_ctzll(m));
+#else
+            unsigned i = 0;
+            while (!(m & 1)) {
+                m >>= 1;
+                ++i;
+            }
+            return i;
+#endif
+        }
+
+        // Any set of byte values, tested 16 or 32 bytes at a time.  AVX2
+        // looks bytes up in a bitmap with two shuffles; SSE2 has no shuffle,
+        // so it compares against the set's ranges when there are few enough.
+        class byte_set
+        {
+            std::uint8_t low[16];       // by low nibble: bits for high nibbles 0-7
+            std::uint8_t high[16];      // by low nibble: bits for high nibbles 8-15
+            std::uint8_t first[16];     // ranges of consecutive members
+            std::uint8_t last[16];
+            int ranges;
+
+        public:
+            static constexpr int MAX_RANGES = 16;
+
+            byte_set() : ranges(0)
+            {
+                std::memset(low, 0, sizeof low);
+                std::memset(high, 0, sizeof high);
+            }
+
+            byte_set & add(unsigned char c)
+            {
+                (c < 0x80 ? low : high)[c & 15] |= static_cast<std::uint8_t>(1 << ((c >> 4) & 7));
+                rebuild();
+                return *this;
+            }
+
+            bool contains(unsigned char c) const
+            {
+                return ((c < 0x80 ? low : high)[c & 15] >> ((c >> 4) & 7)) & 1;
+            }
+
+            friend struct kernels;
+
+        private:
+            void rebuild()
+            {
+                ranges = 0;
+                for (int c = 0; c < 256; ) {
+                    if (!contains(static_cast<unsigned char>(c))) {
+                        ++c;
+                        continue;
+                    }
+                    int d = c;
+                    while (d + 1 < 256 && contains(static_cast<unsigned char>(d + 1)))
+                        ++d;
+                    if (ranges < MAX_RANGES) {
+                        first[ranges] = static_cast<std::uint8_t>(c);
+                        last[ranges] = static_cast<std::uint8_t>(d);
+                    }
+                    ++ranges;
+                    c = d + 1;
+                }
+            }
+        };
+
+        // bit i of each mask tells about byte i of a block of up to 64
+        struct masks
+        {
+            std::uint64_t space;    // ' ', '\t', '\n', '\v', '\f', '\r'
+            std::uint64_t digit;    // '0' to '9'
+            std::uint64_t punct;    // , . : ; ? ! ' " ( )
+            std::uint64_t member;   // in the byte_set asked about
+        };
+
+        struct kernels
+        {
+            static bool is_punct(unsigned char c)
+            {
+                switch (c) {
+                case ',': case '.': case ':': case ';': case '?':
+                case '!': case '\'': case '"': case '(': case ')':
+                    return true;
+                default:
+                    return false;
+                }
+            }
+
+            static masks scalar(const unsigned char * p, std::size_t n, const byte_set & set)
+            {
+                masks m = {0, 0, 0, 0};
+                for (std::size_t i = 0; i != n; ++i) {
+                    unsigned char c = p[i];
+                    std::uint64_t bit = std::uint64_t(1) << i;
+                    if (c == ' ' || (c >= '\t' && c <= '\r'))
+                        m.space |= bit;
+                    if (c >= '0' && c <= '9')
+                        m.digit |= bit;
+                    if (is_punct(c))
+                        m.punct |= bit;
+                    if (set.contains(c))
+                        m.member |= bit;
+                }
+                return m;
+            }
+
+#if COLOR_CONSOLE_X86
+            // x in [a, b], on unsigned bytes
+            static __m128i within(__m128i x, unsigned char a, unsigned char b)
+            {
+                __m128i t = _mm_sub_epi8(x, _mm_set1_epi8(static_cast<char>(a)));
+                return _mm_cmpeq_epi8(_mm_min_epu8(t, _mm_set1_epi8(static_cast<char>(b - a))), t);
+            }
+
+            static __m128i equal(__m128i x, char c)
+            {
+                return _mm_cmpeq_epi8(x, _mm_set1_epi8(c));
+            }
+
+            static masks sse2(const unsigned char * p, const byte_set & set)
+            {
+                masks m = {0, 0, 0, 0};
+                __m128i x[4];
+                for (int k = 0; k != 4; ++k) {
+                    x[k] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 16 * k));
+                    __m128i space = _mm_or_si128(equal(x[k], ' '), within(x[k], '\t', '\r'));
+                    __m128i digit = within(x[k], '0', '9');
+                    // '\'' to ')' is just '\'', '(' and ')'
+                    __m128i punct = _mm_or_si128(
+                        _mm_or_si128(_mm_or_si128(equal(x[k], ','), equal(x[k], '.')),
+                                     _mm_or_si128(within(x[k], ':', ';'), equal(x[k], '?'))),
+                        _mm_or_si128(within(x[k], '!', '"'), within(x[k], '\'', ')')));
+                    int shift = 16 * k;
+                    m.space |= std::uint64_t(static_cast<std::uint16_t>(_mm_movemask_epi8(space))) << shift;
+                    m.digit |= std::uint64_t(static_cast<std::uint16_t>(_mm_movemask_epi8(digit))) << shift;
+                    m.punct |= std::uint64_t(static_cast<std::uint16_t>(_mm_movemask_epi8(punct))) << shift;
+                }
+
+                if (set.ranges > byte_set::MAX_RANGES) {
+                    for (int i = 0; i != 64; ++i)
+                        m.member |= std::uint64_t(set.contains(p[i])) << i;
+                    return m;
+                }
+                // one range at a time over the whole block, so that each
+                // range's bounds are broadcast once
+                __m128i x0 = x[0], x1 = x[1], x2 = x[2], x3 = x[3];
+                __m128i in0 = _mm_setzero_si128(), in1 = in0, in2 = in0, in3 = in0;
+                for (int r = 0; r != set.ranges; ++r) {
+                    __m128i a = _mm_set1_epi8(static_cast<char>(set.first[r]));
+                    __m128i d = _mm_set1_epi8(static_cast<char>(set.last[r] - set.first[r]));
+                    __m128i t0 = _mm_sub_epi8(x0, a);
+                    __m128i t1 = _mm_sub_epi8(x1, a);
+                    __m128i t2 = _mm_sub_epi8(x2, a);
+                    __m128i t3 = _mm_sub_epi8(x3, a);
+                    in0 = _mm_or_si128(in0, _mm_cmpeq_epi8(_mm_min_epu8(t0, d), t0));
+                    in1 = _mm_or_si128(in1, _mm_cmpeq_epi8(_mm_min_epu8(t1, d), t1));
+                    in2 = _mm_or_si128(in2, _mm_cmpeq_epi8(_mm_min_epu8(t2, d), t2));
+                    in3 = _mm_or_si128(in3, _mm_cmpeq_epi8(_mm_min_epu8(t3, d), t3));
+                }
+                m.member = std::uint64_t(static_cast<std::uint16_t>(_mm_movemask_epi8(in0))) |
+                           std::uint64_t(static_cast<std::uint16_t>(_mm_movemask_epi8(in1))) << 16 |
+                           std::uint64_t(static_cast<std::uint16_t>(_mm_movemask_epi8(in2))) << 32 |
+                           std::uint64_t(static_cast<std::uint16_t>(_mm_movemask_epi8(in3))) << 48;
+                return m;
+            }
+
+            COLOR_CONSOLE_AVX2
+            static __m256i within(__m256i x, unsigned char a, unsigned char b)
+            {
+                __m256i t = _mm256_sub_epi8(x, _mm256_set1_epi8(static_cast<char>(a)));
+                return _mm256_cmpeq_epi8(_mm256_min_epu8(t, _mm256_set1_epi8(static_cast<char>(b - a))), t);
+            }
+
+            COLOR_CONSOLE_AVX2
+            static __m256i equal(__m256i x, char c)
+            {
+                return _mm256_cmpeq_epi8(x, _mm256_set1_epi8(c));
+            }
+
+            COLOR_CONSOLE_AVX2
+            static masks avx2(const unsigned char * p, const byte_set & set)
+            {
+                masks m = {0, 0, 0, 0};
+                __m256i low = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(set.low)));
+                __m256i high = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(set.high)));
+                __m256i bits = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+                                                1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+                __m256i nibble = _mm256_set1_epi8(0x0f);
+                for (int k = 0; k != 2; ++k) {
+                    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + 32 * k));
+                    __m256i space = _mm256_or_si256(equal(x, ' '), within(x, '\t', '\r'));
+                    __m256i digit = within(x, '0', '9');
+                    __m256i punct = _mm256_or_si256(
+                        _mm256_or_si256(_mm256_or_si256(equal(x, ','), equal(x, '.')),
+                                        _mm256_or_si256(within(x, ':', ';'), equal(x, '?'))),
+                        _mm256_or_si256(within(x, '!', '"'), within(x, '\'', ')')));
+
+                    // the bitmap row for the low nibble, the bit for the high one
+                    __m256i lo = _mm256_and_si256(x, nibble);
+                    __m256i hi = _mm256_and_si256(_mm256_srli_epi16(x, 4), nibble);
+                    __m256i row = _mm256_blendv_epi8(_mm256_shuffle_epi8(low, lo),
+                                                     _mm256_shuffle_epi8(high, lo), x);
+                    __m256i bit = _mm256_shuffle_epi8(bits, hi);
+                    __m256i member = _mm256_cmpeq_epi8(_mm256_and_si256(row, bit), bit);
+
+                    int shift = 32 * k;
+                    m.space |= std::uint64_t(static_cast<std::uint32_t>(_mm256_movemask_epi8(space))) << shift;
+                    m.digit |= std::uint64_t(static_cast<std::uint32_t>(_mm256_movemask_epi8(digit))) << shift;
+                    m.punct |= std::uint64_t(static_cast<std::uint32_t>(_mm256_movemask_epi8(punct))) << shift;
+                    m.member |= std::uint64_t(static_cast<std::uint32_t>(_mm256_movemask_epi8(member))) << shift;
+                }
+                return m;
+            }
+#endif
+        };
+
+        // classify n bytes at p, at most 64, at the active level
+        inline masks classify(const char * p, std::size_t n, const byte_set & set)
+        {
+            const unsigned char * q = reinterpret_cast<const unsigned char *>(p);
+#if COLOR_CONSOLE_X86
+            if (active() != level::scalar) {
+                unsigned char pad[64];
+                if (n < 64) {
+                    // padding bytes are classified too, then masked off
+                    std::memcpy(pad, q, n);
+                    std::memset(pad + n, 0, 64 - n);
+                    q = pad;
+                }
+                masks m = active() == level::avx2 ? kernels::avx2(q, set) : kernels::sse2(q, set);
+                if (n < 64) {
+                    std::uint64_t keep = (std::uint64_t(1) << n) - 1;
+                    m.space &= keep;
+                    m.digit &= keep;
+                    m.punct &= keep;
+                    m.member &= keep;
+                }
+                return m;
+            }
+#endif
+            return kernels::scalar(q, n, set);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,300 @@
+#ifndef COLOR_SINK_HPP
+#define COLOR_SINK_HPP
+
+#include "color.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace dye
+{
+    // what an async_sink does with a record that finds its queue full
+    enum class overflow
+    {
+        block,          // wait for the writer to make room
+        drop_newest,    // discard the record being pushed
+        drop_oldest     // discard the oldest queued record to make room
+    };
+
+    // Renders records on a background thread.  Producers move records (a
+    // colorful<T>, a styled_string, a pre-rendered std::string, anything
+    // that can be streamed) into a bounded lock-free ring; the writer thread
+    // takes them out in order and writes each one, followed by a newline,
+    // to the stream, so that color switches and slow terminals cost the
+    // producers nothing.  The stream is flushed on flush(), at the end, and
+    // otherwise at most every 50 ms while there is output it has not seen
+    // flushed.  Record must be default-constructible and movable.
+    template<typename Record>
+    class async_sink
+    {
+        // bounded MPMC queue after Dmitry Vyukov: each cell carries a
+        // sequence number telling whether it is ready to be written or read
+        struct cell
+        {
+            std::atomic<std::size_t> seq;
+            Record value;
+        };
+
+        std::ostream & os;
+        const overflow policy;
+        const std::size_t mask;
+        std::vector<cell> cells;
+
+        char pad0[64];
+        std::atomic<std::size_t> enqueued;
+        char pad1[64];
+        std::atomic<std::size_t> dequeued;
+        char pad2[64];
+        std::atomic<std::size_t> completed;     // written or dropped after queueing
+        std::atomic<std::size_t> flushed;       // completed as of the last os.flush()
+        std::atomic<std::size_t> drops;
+        std::atomic<std::size_t> blocked;       // producers waiting for room
+        std::atomic<bool> sleeping;
+        std::atomic<bool> flush_wanted;
+        std::atomic<bool> stopping;
+        std::mutex m;
+        std::condition_variable wake;           // for the writer
+        std::condition_variable done;           // for producers, on room or a flush
+        std::thread writer;
+
+    public:
+        // capacity is rounded up to a power of two
+        explicit async_sink(std::ostream & os, std::size_t capacity = 1024,
+                            overflow policy = overflow::block)
+            : os(os), policy(policy), mask(round_up(capacity) - 1), cells(mask + 1),
+              enqueued(0), dequeued(0), completed(0), flushed(0), drops(0), blocked(0),
+              sleeping(false), flush_wanted(false), stopping(false)
+        {
+            for (std::size_t i = 0; i != cells.size(); ++i)
+                cells[i].seq.store(i, std::memory_order_relaxed);
+            writer = std::thread([this] { run(); });
+        }
+
+        async_sink(const async_sink &) = delete;
+        async_sink & operator=(const async_sink &) = delete;
+
+        // write out whatever is still queued, then stop the writer
+        ~async_sink()
+        {
+            stopping.store(true);
+            notify();
+            writer.join();
+        }
+
+        // queue a record; false if it was dropped under overflow::drop_newest
+        bool push(Record r)
+        {
+            for (;;) {
+                if (try_push(r)) {
+                    if (sleeping.load())
+                        notify();
+                    return true;
+                }
+                switch (policy) {
+                case overflow::drop_newest:
+                    drops.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                case overflow::drop_oldest: {
+                    Record old;
+                    if (try_pop(old)) {
+                        drops.fetch_add(1, std::memory_order_relaxed);
+                        completed.fetch_add(1, std::memory_order_release);
+                    }
+                    break;
+                }
+                case overflow::block: {
+                    // counted before the queue is looked at again, so that
+                    // the writer either sees this producer or has made room;
+                    // woken only once half the queue is free, so that the
+                    // two threads do not take turns a record at a time
+                    std::unique_lock<std::mutex> lock(m);
+                    blocked.fetch_add(1);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    wake.notify_one();
+                    done.wait(lock, [this] { return roomy(); });
+                    blocked.fetch_sub(1);
+                    break;
+                }
+                }
+            }
+        }
+
+        async_sink & operator<<(Record r)
+        {
+            push(std::move(r));
+            return *this;
+        }
+
+        // wait until everything queued so far is written and the stream flushed
+        void flush()
+        {
+            std::size_t target = enqueued.load();
+            std::unique_lock<std::mutex> lock(m);
+            while (flushed.load() < target) {
+                flush_wanted.store(true);
+                wake.notify_one();
+                done.wait(lock);
+            }
+        }
+
+        // records waiting to be written
+        std::size_t depth() const
+        {
+            std::size_t in = enqueued.load(std::memory_order_relaxed);
+            std::size_t out = dequeued.load(std::memory_order_relaxed);
+            return in > out ? in - out : 0;
+        }
+
+        // records discarded because the queue was full
+        std::size_t dropped() const
+        {
+            return drops.load(std::memory_order_relaxed);
+        }
+
+        std::size_t capacity() const
+        {
+            return cells.size();
+        }
+
+    private:
+        static std::size_t round_up(std::size_t n)
+        {
+            std::size_t p = 2;
+            while (p < n)
+                p *= 2;
+            return p;
+        }
+
+        bool try_push(Record & r)
+        {
+            std::size_t pos = enqueued.load(std::memory_order_relaxed);
+            for (;;) {
+                cell & c = cells[pos & mask];
+                std::size_t seq = c.seq.load(std::memory_order_acquire);
+                auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+                if (diff == 0) {
+                    // seq_cst, so that a writer going to sleep either sees
+                    // this record or is seen sleeping by push()
+                    if (enqueued.compare_exchange_weak(pos, pos + 1, std::memory_order_seq_cst,
+                                                       std::memory_order_relaxed)) {
+                        c.value = std::move(r);
+                        c.seq.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0) {
+                    return false;
+                }
+                else {
+                    pos = enqueued.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        bool try_pop(Record & r)
+        {
+            std::size_t pos = dequeued.load(std::memory_order_relaxed);
+            for (;;) {
+                cell & c = cells[pos & mask];
+                std::size_t seq = c.seq.load(std::memory_order_acquire);
+                auto diff = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+                if (diff == 0) {
+                    if (dequeued.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        r = std::move(c.value);
+                        c.value = Record();
+                        c.seq.store(pos + mask + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0) {
+                    return false;
+                }
+                else {
+                    pos = dequeued.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        bool pending() const
+        {
+            return enqueued.load() != dequeued.load();
+        }
+
+        bool roomy() const
+        {
+            return depth() <= cells.size() / 2;
+        }
+
+        // wake the producers waiting for room, if there is room and any are
+        // waiting; the fence orders the pop before the look at blocked, as
+        // push() orders the other way
+        void make_room()
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (blocked.load(std::memory_order_relaxed) && roomy()) {
+                std::lock_guard<std::mutex> lock(m);
+                done.notify_all();
+            }
+        }
+
+        void notify()
+        {
+            std::lock_guard<std::mutex> lock(m);
+            wake.notify_one();
+        }
+
+        void mark_flushed(std::chrono::steady_clock::time_point & last)
+        {
+            std::size_t n = completed.load();
+            os.flush();
+            last = std::chrono::steady_clock::now();
+            {
+                std::lock_guard<std::mutex> lock(m);
+                flushed.store(n);
+                flush_wanted.store(false);
+            }
+            done.notify_all();
+        }
+
+        void run()
+        {
+            // a trickle of records costs one flush every period, not one a
+            // record; the stream's own buffer bounds what waits in between
+            const auto period = std::chrono::milliseconds(50);
+            auto last = std::chrono::steady_clock::now();
+            Record r;
+            for (;;) {
+                while (try_pop(r)) {
+                    make_room();
+                    os << r << '\n';
+                    completed.fetch_add(1, std::memory_order_release);
+                    if (flush_wanted.load(std::memory_order_relaxed))
+                        mark_flushed(last);
+                }
+                bool unflushed = flushed.load() != completed.load();
+                auto waited = std::chrono::steady_clock::now() - last;
+                if (flush_wanted.load() || stopping.load() || (unflushed && waited >= period)) {
+                    mark_flushed(last);
+                    unflushed = false;
+                    waited = std::chrono::steady_clock::duration::zero();
+                }
+                if (stopping.load() && !pending())
+                    return;
+
+                std::unique_lock<std::mutex> lock(m);
+                sleeping.store(true);
+                if (!pending() && !stopping.load() && !flush_wanted.load())
+                    wake.wait_for(lock, unflushed ? period - waited : period);
+                sleeping.store(false);
+            }
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,309 @@
+#ifndef COLOR_TABLE_HPP
+#define COLOR_TABLE_HPP
+
+#include "color.hpp"
+#include "color_width.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace dye
+{
+    // A table of dyed cells written as it is filled, for reports too large
+    // to hold.  Rows are kept until a window of them is full, then written
+    // with every column as wide as its widest cell so far, padded and
+    // aligned, the colors of the cells kept:
+    //
+    //     dye::table t(std::cout, {{"host"}, {"ms", dye::table::align::right},
+    //                              {"status", dye::table::align::left, hue::GREEN, 12}});
+    //     t.row(dye::aqua(host), ms, failed ? dye::light_red("failed") : dye::green("ok"));
+    //     t.flush();
+    //
+    // Columns never narrow, so rows line up within a window, and across
+    // windows as long as no later cell is wider.  A cell wider than the
+    // limit of its column is cut, with an ellipsis.  Text a cell leaves in
+    // the default color takes the color of its column.  Missing cells are
+    // left blank, and cells past the last column are dropped.
+    class table
+    {
+    public:
+        enum class align
+        {
+            left,
+            right,
+            center
+        };
+
+        struct column
+        {
+            std::string title;
+            align side;
+            int color;
+            std::size_t limit;      // the most columns a cell takes, 0 for any
+
+            column(std::string title = std::string(), align side = align::left,
+                   int color = hue::DEFAULT_COLOR, std::size_t limit = 0)
+                : title(std::move(title)), side(side), color(color), limit(limit)
+            {
+            }
+        };
+
+    private:
+        struct run
+        {
+            std::size_t offset;
+            std::size_t size;
+            int color;
+        };
+
+        struct cell
+        {
+            std::size_t first;      // the runs of the cell, in runs
+            std::size_t count;
+            std::size_t width;
+        };
+
+        std::ostream & os;
+        std::vector<column> columns;
+        std::size_t window;
+        std::string gap;
+        std::string mark;
+        std::string text;           // the text of the rows held
+        std::vector<run> runs;
+        std::vector<cell> cells;    // columns.size() to a row
+        std::vector<std::size_t> widths;
+        std::size_t filled;         // the cells of the row being added
+
+    public:
+        table(std::ostream & os, std::vector<column> columns, std::size_t window = 1024)
+            : os(os), columns(std::move(columns)), window(window ? window : 1), gap("  "),
+              mark("\xe2\x80\xa6"), widths(this->columns.size()), filled(0)
+        {
+            bool titled = false;
+            for (const auto & c : this->columns)
+                titled = titled || !c.title.empty();
+            if (titled) {
+                for (const auto & c : this->columns)
+                    add_cell(c.title.data(), c.title.size(), hue::BAD_COLOR);
+                end_row();
+            }
+        }
+
+        table(const table &) = delete;
+        table & operator=(const table &) = delete;
+
+        ~table()
+        {
+            flush();
+        }
+
+        // what goes between two columns, two spaces unless set
+        table & separator(std::string s)
+        {
+            gap = std::move(s);
+            return *this;
+        }
+
+        // what ends a cell that is cut, an ellipsis unless set
+        table & ellipsis(std::string s)
+        {
+            mark = std::move(s);
+            return *this;
+        }
+
+        // a row of cells: dyed objects, strings, numbers, or anything else
+        // that can be written to a stream
+        template<typename... Cells>
+        table & row(const Cells &... values)
+        {
+            // expand the pack in order, one cell at a time
+            int expand[] = {0, (add(values), 0)...};
+            (void)expand;
+            end_row();
+            return *this;
+        }
+
+        std::size_t rows() const
+        {
+            return columns.empty() ? 0 : cells.size() / columns.size();
+        }
+
+        // write out the rows held
+        void flush()
+        {
+            if (cells.empty())
+                return;
+            const std::size_t n = columns.size();
+            for (std::size_t k = 0; k != n; ++k)
+                if (columns[k].limit && widths[k] > columns[k].limit)
+                    widths[k] = columns[k].limit;
+
+            const int plain = hue::get(os);
+            int current = plain;
+            auto paint = [&](int c)
+            {
+                if (c != current) {
+                    hue::set(os, c);
+                    current = c;
+                }
+            };
+            for (std::size_t r = 0; r != cells.size(); r += n) {
+                for (std::size_t k = 0; k != n; ++k) {
+                    const cell & c = cells[r + k];
+                    const column & col = columns[k];
+                    std::size_t w = widths[k];
+                    bool cut = c.width > w;
+                    std::size_t shown = cut ? w : c.width;
+                    // the last column is not padded out on the right, nor
+                    // at all when its cell is empty
+                    bool last = k + 1 == n;
+                    std::size_t left = last && !shown ? 0 :
+                                       col.side == align::right ? w - shown :
+                                       col.side == align::center ? (w - shown) / 2 : 0;
+                    std::size_t right = last ? 0 : w - shown - left;
+                    if (k) {
+                        paint(plain);
+                        os.write(gap.data(), static_cast<std::streamsize>(gap.size()));
+                    }
+                    paint(plain);
+                    pad(left);
+                    std::size_t ellipsis = cut ? width(mark) : 0;
+                    bool marked = cut && w >= ellipsis;
+                    std::size_t room = marked ? w - ellipsis : shown;
+                    for (std::size_t i = c.first; i != c.first + c.count; ++i) {
+                        const run & u = runs[i];
+                        int color = u.color == hue::DEFAULT_COLOR ? col.color : u.color;
+                        paint(color == hue::DEFAULT_COLOR || color == hue::BAD_COLOR ? plain : color);
+                        const char * p = text.data() + u.offset;
+                        std::size_t m = cut ? fit(p, u.size, room) : u.size;
+                        os.write(p, static_cast<std::streamsize>(m));
+                        if (cut) {
+                            room -= width(p, m);
+                            if (m != u.size)
+                                break;
+                        }
+                    }
+                    if (marked)
+                        os.write(mark.data(), static_cast<std::streamsize>(mark.size()));
+                    paint(plain);
+                    pad(right + (cut ? room : 0));
+                }
+                paint(plain);
+                os.put('\n');
+            }
+            text.clear();
+            runs.clear();
+            cells.clear();
+        }
+
+    private:
+        void pad(std::size_t n)
+        {
+            static const char spaces[] = "                                ";
+            for (; n > 32; n -= 32)
+                os.write(spaces, 32);
+            os.write(spaces, static_cast<std::streamsize>(n));
+        }
+
+        // runs of BAD_COLOR, the titles, are written in the stream's own
+        // color rather than the column's
+        void append(const char * p, std::size_t n, int color)
+        {
+            if (!n)
+                return;
+            cell & c = cells.back();
+            if (c.count && runs.back().color == color) {
+                runs.back().size += n;
+            }
+            else {
+                runs.push_back(run{text.size(), n, color});
+                ++c.count;
+            }
+            text.append(p, n);
+            c.width += width(p, n);
+        }
+
+        void add_cell(const char * p, std::size_t n, int color)
+        {
+            if (begin_column()) {
+                append(p, n, color);
+                end_cell();
+            }
+        }
+
+        template<typename T>
+        void add_dyed(const T & value)
+        {
+            if (begin_column()) {
+                auto f = [this](const char * p, std::size_t n, int color)
+                    {
+                        append(p, n, hue::is_good(color) || hue::is_extended(color) ? color : hue::DEFAULT_COLOR);
+                    };
+                measure::each(value, f);
+                end_cell();
+            }
+        }
+
+        template<typename T>
+        void add(const colorful<T> & value)
+        {
+            add_dyed(value);
+        }
+
+        template<typename T>
+        void add(const item<T> & value)
+        {
+            add_dyed(value);
+        }
+
+        void add(const std::string & value)
+        {
+            add_cell(value.data(), value.size(), hue::DEFAULT_COLOR);
+        }
+
+        void add(const char * value)
+        {
+            add_cell(value, std::char_traits<char>::length(value), hue::DEFAULT_COLOR);
+        }
+
+        void add(const dye::text & value)
+        {
+            add_cell(value.data(), value.size(), hue::DEFAULT_COLOR);
+        }
+
+        template<typename T>
+        void add(const T & value)
+        {
+            add(measure::plain(value));
+        }
+
+        // false once the row has all its columns
+        bool begin_column()
+        {
+            if (filled == columns.size())
+                return false;
+            ++filled;
+            cells.push_back(cell{runs.size(), 0, 0});
+            return true;
+        }
+
+        void end_cell()
+        {
+            widths[filled - 1] = std::max(widths[filled - 1], cells.back().width);
+        }
+
+        void end_row()
+        {
+            for (; filled < columns.size(); ++filled)
+                cells.push_back(cell{runs.size(), 0, 0});
+            filled = 0;
+            if (rows() >= window)
+                flush();
+        }
+    };
+}
+
+#endif // COLOR_TABLE_HPP
@@ -0,0 +1,525 @@
+#ifndef COLOR_WIDTH_HPP
+#define COLOR_WIDTH_HPP
+
+#include "color.hpp"
+#include "color_scan.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+namespace dye
+{
+    namespace unicode
+    {
+        // whether c falls in one of the ranges of a table, each entry of
+        // which is first << 11 | (last - first)
+        inline bool within(std::uint32_t c, const std::uint32_t * table, std::size_t n)
+        {
+            const std::uint32_t * e = std::upper_bound(table, table + n, c << 11 | 0x7ff);
+            return e != table && c - (e[-1] >> 11) <= (e[-1] & 0x7ff);
+        }
+
+        // the columns a code point takes on a terminal.  None for controls,
+        // combining and enclosing marks, format characters other than the
+        // prepended marks, and the Hangul jamo that join a syllable; two for
+        // East Asian Wide and Fullwidth, as of Unicode 14; one for the rest.
+        inline int width(std::uint32_t c)
+        {
+            if (c < 0x300)
+                return c >= 0x20 && (c < 0x7f || c >= 0xa0) ? 1 : 0;
+            if (c >= 0x20000 && c <= 0x3fffd)
+                return 2;
+            static const std::uint32_t zero[] = {
+                0x0018006f, 0x00241806, 0x002c882c, 0x002df800, 0x002e0801, 0x002e2001,
+                0x002e3800, 0x0030800a, 0x0030e000, 0x00325814, 0x00338000, 0x0036b006,
+                0x0036f805, 0x00373801, 0x00375003, 0x00388800, 0x0039801a, 0x003d300a,
+                0x003f5808, 0x003fe800, 0x0040b003, 0x0040d808, 0x00412802, 0x00414804,
+                0x0042c802, 0x0044c007, 0x00465017, 0x0047181f, 0x0049d000, 0x0049e000,
+                0x004a0807, 0x004a6800, 0x004a8806, 0x004b1001, 0x004c0800, 0x004de000,
+                0x004e0803, 0x004e6800, 0x004f1001, 0x004ff000, 0x00500801, 0x0051e000,
+                0x00520801, 0x00523801, 0x00525802, 0x00528800, 0x00538001, 0x0053a800,
+                0x00540801, 0x0055e000, 0x00560804, 0x00563801, 0x00566800, 0x00571001,
+                0x0057d005, 0x00580800, 0x0059e000, 0x0059f800, 0x005a0803, 0x005a6800,
+                0x005aa801, 0x005b1001, 0x005c1000, 0x005e0000, 0x005e6800, 0x00600000,
+                0x00602000, 0x0061e000, 0x0061f002, 0x00623002, 0x00625003, 0x0062a801,
+                0x00631001, 0x00640800, 0x0065e000, 0x0065f800, 0x00663000, 0x00666001,
+                0x00671001, 0x00680001, 0x0069d801, 0x006a0803, 0x006a6800, 0x006b1001,
+                0x006c0800, 0x006e5000, 0x006e9002, 0x006eb000, 0x00718800, 0x0071a006,
+                0x00723807, 0x00758800, 0x0075a008, 0x00764005, 0x0078c001, 0x0079a800,
+                0x0079b800, 0x0079c800, 0x007b880d, 0x007c0004, 0x007c3001, 0x007c680a,
+                0x007cc823, 0x007e3000, 0x00816803, 0x00819005, 0x0081c801, 0x0081e801,
+                0x0082c001, 0x0082f002, 0x00838803, 0x00841000, 0x00842801, 0x00846800,
+                0x0084e800, 0x008b009f, 0x009ae802, 0x00b89002, 0x00b99001, 0x00ba9001,
+                0x00bb9001, 0x00bda001, 0x00bdb806, 0x00be3000, 0x00be480a, 0x00bee800,
+                0x00c05804, 0x00c42801, 0x00c54800, 0x00c90002, 0x00c93801, 0x00c99000,
+                0x00c9c802, 0x00d0b801, 0x00d0d800, 0x00d2b000, 0x00d2c006, 0x00d30000,
+                0x00d31000, 0x00d32807, 0x00d39809, 0x00d3f800, 0x00d5801e, 0x00d80003,
+                0x00d9a000, 0x00d9b004, 0x00d9e000, 0x00da1000, 0x00db5808, 0x00dc0001,
+                0x00dd1003, 0x00dd4001, 0x00dd5802, 0x00df3000, 0x00df4001, 0x00df6800,
+                0x00df7802, 0x00e16007, 0x00e1b001, 0x00e68002, 0x00e6a00c, 0x00e71006,
+                0x00e76800, 0x00e7a000, 0x00e7c001, 0x00ee003f, 0x01005804, 0x01015004,
+                0x01030004, 0x01033009, 0x01068020, 0x01677802, 0x016bf800, 0x016f001f,
+                0x01815003, 0x0184c801, 0x05337803, 0x0533a009, 0x0534f001, 0x05378001,
+                0x05401000, 0x05403000, 0x05405800, 0x05412801, 0x05416000, 0x05462001,
+                0x05470011, 0x0547f800, 0x05493007, 0x054a380a, 0x054c0002, 0x054d9800,
+                0x054db003, 0x054de001, 0x054f2800, 0x05514805, 0x05518801, 0x0551a801,
+                0x05521800, 0x05526000, 0x0553e000, 0x05558000, 0x05559002, 0x0555b801,
+                0x0555f001, 0x05560800, 0x05576001, 0x0557b000, 0x055f2800, 0x055f4000,
+                0x055f6800, 0x06bd8016, 0x06be5830, 0x07d8f000, 0x07f0000f, 0x07f1000f,
+                0x07f7f800, 0x07ffc802, 0x080fe800, 0x08170000, 0x081bb004, 0x08500802,
+                0x08502801, 0x08506003, 0x0851c002, 0x0851f800, 0x08572801, 0x08692003,
+                0x08755801, 0x087a300a, 0x087c1003, 0x08800800, 0x0881c00e, 0x08838000,
+                0x08839801, 0x0883f802, 0x08859803, 0x0885c801, 0x08861000, 0x08880002,
+                0x08893804, 0x08896807, 0x088b9800, 0x088c0001, 0x088db008, 0x088e4803,
+                0x088e7800, 0x08917802, 0x0891a000, 0x0891b001, 0x0891f000, 0x0896f800,
+                0x08971807, 0x08980001, 0x0899d801, 0x089a0000, 0x089b3006, 0x089b8004,
+                0x08a1c007, 0x08a21002, 0x08a23000, 0x08a2f000, 0x08a59805, 0x08a5d000,
+                0x08a5f801, 0x08a61001, 0x08ad9003, 0x08ade001, 0x08adf801, 0x08aee001,
+                0x08b19807, 0x08b1e800, 0x08b1f801, 0x08b55800, 0x08b56800, 0x08b58005,
+                0x08b5b800, 0x08b8e802, 0x08b91003, 0x08b93804, 0x08c17808, 0x08c1c801,
+                0x08c9d801, 0x08c9f000, 0x08ca1800, 0x08cea003, 0x08ced001, 0x08cf0000,
+                0x08d00809, 0x08d19805, 0x08d1d803, 0x08d23800, 0x08d28805, 0x08d2c802,
+                0x08d4500c, 0x08d4c001, 0x08e18006, 0x08e1c005, 0x08e1f800, 0x08e49015,
+                0x08e55006, 0x08e59001, 0x08e5a801, 0x08e98805, 0x08e9d000, 0x08e9e001,
+                0x08e9f806, 0x08ea3800, 0x08ec8001, 0x08eca800, 0x08ecb800, 0x08f79801,
+                0x09a18008, 0x0b578004, 0x0b598006, 0x0b7a7800, 0x0b7c7803, 0x0b7f2000,
+                0x0de4e801, 0x0de50003, 0x0e78002d, 0x0e798016, 0x0e8b3802, 0x0e8b980f,
+                0x0e8c2806, 0x0e8d5003, 0x0e921002, 0x0ed00036, 0x0ed1d831, 0x0ed3a800,
+                0x0ed42000, 0x0ed4d804, 0x0ed5080e, 0x0f000006, 0x0f004010, 0x0f00d806,
+                0x0f011801, 0x0f013004, 0x0f098006, 0x0f157000, 0x0f176003, 0x0f468006,
+                0x0f4a2006, 0x70000800, 0x7001005f, 0x700800ef
+            };
+            static const std::uint32_t wide[] = {
+                0x0088005f, 0x0118d001, 0x01194801, 0x011f4803, 0x011f8000, 0x011f9800,
+                0x012fe801, 0x0130a001, 0x0132400b, 0x0133f800, 0x01349800, 0x01350800,
+                0x01355001, 0x0135e801, 0x01362001, 0x01367000, 0x0136a000, 0x01375000,
+                0x01379001, 0x0137a800, 0x0137d000, 0x0137e800, 0x01382800, 0x01385001,
+                0x01394000, 0x013a6000, 0x013a7000, 0x013a9802, 0x013ab800, 0x013ca802,
+                0x013d8000, 0x013df800, 0x0158d801, 0x015a8000, 0x015aa800, 0x01740019,
+                0x0174d858, 0x017800d5, 0x017f800b, 0x01800029, 0x01817010, 0x01820855,
+                0x0184d864, 0x0188282a, 0x0189885d, 0x018c8053, 0x018f802e, 0x01910027,
+                0x019287ff, 0x01d287ff, 0x021287ff, 0x0252836f, 0x027007ff, 0x02b007ff,
+                0x02f007ff, 0x033007ff, 0x037007ff, 0x03b007ff, 0x03f007ff, 0x043007ff,
+                0x047007ff, 0x04b007ff, 0x04f0068c, 0x05248036, 0x054b001c, 0x056007ff,
+                0x05a007ff, 0x05e007ff, 0x062007ff, 0x066007ff, 0x06a003a3, 0x07c8016d,
+                0x07d38069, 0x07f08009, 0x07f18022, 0x07f2a012, 0x07f34003, 0x07f8085f,
+                0x07ff0006, 0x0b7f0003, 0x0b7f8001, 0x0b8007ff, 0x0bc007ff, 0x0c0007f7,
+                0x0c4004d5, 0x0c680008, 0x0d7f8003, 0x0d7fa806, 0x0d7fe801, 0x0d800122,
+                0x0d8a8002, 0x0d8b2003, 0x0d8b818b, 0x0f802000, 0x0f867800, 0x0f8c7000,
+                0x0f8c8809, 0x0f900002, 0x0f90802b, 0x0f920008, 0x0f928001, 0x0f930005,
+                0x0f980020, 0x0f996808, 0x0f99b845, 0x0f9bf015, 0x0f9d002a, 0x0f9e7804,
+                0x0f9f0010, 0x0f9fa000, 0x0f9fc046, 0x0fa20000, 0x0fa210ba, 0x0fa7f83e,
+                0x0faa5803, 0x0faa8017, 0x0fabd000, 0x0faca801, 0x0fad2000, 0x0fafd854,
+                0x0fb40045, 0x0fb66000, 0x0fb68002, 0x0fb6a802, 0x0fb6e802, 0x0fb75801,
+                0x0fb7a008, 0x0fbf000b, 0x0fbf8000, 0x0fc8602e, 0x0fc9e009, 0x0fca38b8,
+                0x0fd38004, 0x0fd3c004, 0x0fd40006, 0x0fd4801c, 0x0fd5800a, 0x0fd60005,
+                0x0fd68009, 0x0fd70007, 0x0fd78006
+            };
+            if (within(c, zero, sizeof zero / sizeof *zero))
+                return 0;
+            return within(c, wide, sizeof wide / sizeof *wide) ? 2 : 1;
+        }
+
+        // decode the code point at p, of at most n bytes, and return how many
+        // bytes it took; a malformed sequence takes one byte and reads as
+        // U+FFFD
+        inline std::size_t decode(const unsigned char * p, std::size_t n, std::uint32_t & c)
+        {
+            unsigned char b = p[0];
+            std::size_t k = b >= 0xf0 ? 4 : b >= 0xe0 ? 3 : 2;
+            c = 0xfffd;
+            if (b < 0xc2 || b > 0xf4 || n < k)
+                return 1;
+            std::uint32_t v = b & (0x7f >> k);
+            for (std::size_t i = 1; i != k; ++i) {
+                if ((p[i] & 0xc0) != 0x80)
+                    return 1;
+                v = v << 6 | (p[i] & 0x3f);
+            }
+            if ((k == 3 && v < 0x800) || (k == 4 && (v < 0x10000 || v > 0x10ffff)) ||
+                (v >= 0xd800 && v <= 0xdfff))
+                return 1;
+            c = v;
+            return k;
+        }
+
+        // the length of the escape sequence at p, which starts with ESC: a
+        // CSI sequence up to its final byte, an OSC string up to BEL or ST,
+        // or ESC and the one byte after it
+        inline std::size_t escape(const char * p, std::size_t n)
+        {
+            if (n < 2)
+                return n;
+            std::size_t i = 2;
+            if (p[1] == '[') {
+                while (i != n && (p[i] < 0x40 || p[i] > 0x7e))
+                    ++i;
+                return i != n ? i + 1 : n;
+            }
+            if (p[1] == ']') {
+                for (; i != n; ++i) {
+                    if (p[i] == '\a')
+                        return i + 1;
+                    if (p[i] == '\x1b' && i + 1 != n && p[i + 1] == '\\')
+                        return i + 2;
+                }
+                return n;
+            }
+            return 2;
+        }
+    }
+
+    namespace simd
+    {
+        // how many bytes from p on, of at most n, are printable ASCII, 0x20
+        // to 0x7e: with x + 0x60 those are the signed bytes below -33
+        inline std::size_t printable_scalar(const char * p, std::size_t n)
+        {
+            std::size_t i = 0;
+            while (i != n && static_cast<unsigned char>(p[i] - 0x20) < 0x5f)
+                ++i;
+            return i;
+        }
+
+#if COLOR_CONSOLE_X86
+        inline std::size_t printable_sse2(const char * p, std::size_t n)
+        {
+            const __m128i shift = _mm_set1_epi8(0x60);
+            const __m128i bound = _mm_set1_epi8(-33);
+            std::size_t i = 0;
+            for (; i + 16 <= n; i += 16) {
+                __m128i x = _mm_add_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i)), shift);
+                unsigned m = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmplt_epi8(x, bound)));
+                if (m != 0xffff)
+                    return i + lowest_bit(~m & 0xffff);
+            }
+            return i + printable_scalar(p + i, n - i);
+        }
+
+        COLOR_CONSOLE_AVX2
+        inline std::size_t printable_avx2(const char * p, std::size_t n)
+        {
+            const __m256i shift = _mm256_set1_epi8(0x60);
+            const __m256i bound = _mm256_set1_epi8(-33);
+            std::size_t i = 0;
+            for (; i + 32 <= n; i += 32) {
+                __m256i x = _mm256_add_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i)), shift);
+                std::uint32_t m = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(bound, x)));
+                if (m != 0xffffffff)
+                    return i + lowest_bit(~m);
+            }
+            return i + printable_scalar(p + i, n - i);
+        }
+#endif
+
+        inline std::size_t printable(const char * p, std::size_t n)
+        {
+#if COLOR_CONSOLE_X86
+            // a table cell is mostly shorter than a vector
+            if (n >= 16) {
+                if (active() == level::avx2)
+                    return printable_avx2(p, n);
+                if (active() == level::sse2)
+                    return printable_sse2(p, n);
+            }
+#endif
+            return printable_scalar(p, n);
+        }
+    }
+
+    // the columns UTF-8 text takes on a terminal, escape sequences and
+    // controls taking none
+    inline std::size_t width(const char * p, std::size_t n)
+    {
+        const unsigned char * q = reinterpret_cast<const unsigned char *>(p);
+        std::size_t w = 0;
+        for (std::size_t i = 0; ; ) {
+            std::size_t k = simd::printable(p + i, n - i);
+            w += k;
+            i += k;
+            if (i == n)
+                return w;
+            if (q[i] == 0x1b) {
+                i += unicode::escape(p + i, n - i);
+            }
+            else if (q[i] < 0x80) {
+                ++i;
+            }
+            else {
+                std::uint32_t c;
+                i += unicode::decode(q + i, n - i, c);
+                w += static_cast<std::size_t>(unicode::width(c));
+            }
+        }
+    }
+
+    inline std::size_t width(const char * s)
+    {
+        return width(s, std::char_traits<char>::length(s));
+    }
+
+    inline std::size_t width(const std::string & s)
+    {
+        return width(s.data(), s.size());
+    }
+
+    inline std::size_t width(const text & t)
+    {
+        return width(t.data(), t.size());
+    }
+
+    // how many bytes from p on, of at most n, fit in the given number of
+    // columns, cut only between code points; escape sequences ride along
+    inline std::size_t fit(const char * p, std::size_t n, std::size_t columns)
+    {
+        const unsigned char * q = reinterpret_cast<const unsigned char *>(p);
+        std::size_t w = 0;
+        for (std::size_t i = 0; ; ) {
+            std::size_t k = simd::printable(p + i, std::min(n - i, columns - w));
+            w += k;
+            i += k;
+            if (i == n)
+                return i;
+            if (q[i] == 0x1b) {
+                i += unicode::escape(p + i, n - i);
+            }
+            else if (q[i] < 0x80) {
+                // printable ASCII left over means the columns are used up
+                if (q[i] >= 0x20 && q[i] < 0x7f)
+                    return i;
+                ++i;
+            }
+            else {
+                std::uint32_t c;
+                std::size_t len = unicode::decode(q + i, n - i, c);
+                std::size_t cw = static_cast<std::size_t>(unicode::width(c));
+                if (w + cw > columns)
+                    return i;
+                w += cw;
+                i += len;
+            }
+        }
+    }
+
+    // text with its escape sequences taken out
+    inline std::string plain(const char * p, std::size_t n)
+    {
+        std::string s;
+        s.reserve(n);
+        for (std::size_t i = 0; i != n; ) {
+            const void * e = std::memchr(p + i, '\x1b', n - i);
+            std::size_t k = e ? static_cast<std::size_t>(static_cast<const char *>(e) - p) : n;
+            s.append(p + i, k - i);
+            i = k == n ? n : k + unicode::escape(p + k, n - k);
+        }
+        return s;
+    }
+
+    inline std::string plain(const std::string & s)
+    {
+        return plain(s.data(), s.size());
+    }
+
+    // what dyed things are measured and written out as without colors;
+    // whole numbers are counted digit by digit, anything else that is not
+    // text is put through a stream first
+    struct measure
+    {
+        template<typename T>
+        using counted = std::integral_constant<bool, std::is_integral<T>::value &&
+                                                     (sizeof(T) > 1 || std::is_same<T, bool>::value)>;
+
+        template<typename T>
+        static std::size_t width(const T & t)
+        {
+            return width(t, counted<T>());
+        }
+
+        static std::size_t width(const text & t)
+        {
+            return dye::width(t);
+        }
+
+        static std::size_t width(const std::string & s)
+        {
+            return dye::width(s);
+        }
+
+        template<typename T>
+        static std::size_t width(const view<T> & v)
+        {
+            return width(v.get());
+        }
+
+        template<typename T>
+        static std::size_t width(const item<T> & it)
+        {
+            return width(it.thing);
+        }
+
+        template<typename T>
+        static std::size_t width(const colorful<T> & col)
+        {
+            std::size_t w = 0;
+            for (const auto & elem : col)
+                w += width(elem.thing);
+            return w;
+        }
+
+        template<typename T>
+        static std::string plain(const T & t)
+        {
+            return plain(t, counted<T>());
+        }
+
+        static std::string plain(const text & t)
+        {
+            return dye::plain(t.data(), t.size());
+        }
+
+        static std::string plain(const std::string & s)
+        {
+            return dye::plain(s.data(), s.size());
+        }
+
+        template<typename T>
+        static std::string plain(const view<T> & v)
+        {
+            return plain(v.get());
+        }
+
+        template<typename T>
+        static std::string plain(const item<T> & it)
+        {
+            return plain(it.thing);
+        }
+
+        template<typename T>
+        static std::string plain(const colorful<T> & col)
+        {
+            std::string s;
+            for (const auto & elem : col)
+                s += plain(elem.thing);
+            return s;
+        }
+
+        // hand f the things of a dyed object one by one, as text with a color
+        template<typename T, typename F>
+        static void each(const item<T> & it, F & f)
+        {
+            emit(it.thing, it.color, f);
+        }
+
+        template<typename T, typename F>
+        static void each(const colorful<T> & col, F & f)
+        {
+            for (const auto & elem : col)
+                emit(elem.thing, elem.color, f);
+        }
+
+        template<typename F>
+        static void emit(const text & t, int color, F & f)
+        {
+            f(t.data(), t.size(), color);
+        }
+
+        template<typename F>
+        static void emit(const std::string & s, int color, F & f)
+        {
+            f(s.data(), s.size(), color);
+        }
+
+        template<typename T, typename F>
+        static void emit(const T & t, int color, F & f)
+        {
+            std::string s = plain(t);
+            f(s.data(), s.size(), color);
+        }
+
+        template<typename T>
+        static std::string rendered(const T & t)
+        {
+            static thread_local std::ostringstream os;
+            os.str(std::string());
+            os.clear();
+            os << t;
+            return os.str();
+        }
+
+        template<typename T>
+        static std::size_t width(T v, std::true_type)
+        {
+            bool negative = std::is_signed<T>::value && static_cast<long long>(v) < 0;
+            unsigned long long u = static_cast<unsigned long long>(v);
+            if (negative)
+                u = 0 - u;
+            std::size_t w = negative ? 2 : 1;
+            while (u >= 10) {
+                u /= 10;
+                ++w;
+            }
+            return w;
+        }
+
+        template<typename T>
+        static std::size_t width(const T & t, std::false_type)
+        {
+            return dye::width(rendered(t));
+        }
+
+        template<typename T>
+        static std::string plain(T v, std::true_type)
+        {
+            return std::to_string(v);
+        }
+
+        template<typename T>
+        static std::string plain(const T & t, std::false_type)
+        {
+            return dye::plain(rendered(t));
+        }
+    };
+
+    // the columns a dyed object takes, measured from its things without
+    // rendering any colors
+    template<typename T>
+    std::size_t width(const item<T> & it)
+    {
+        return measure::width(it);
+    }
+
+    template<typename T>
+    std::size_t width(const colorful<T> & col)
+    {
+        return measure::width(col);
+    }
+
+    inline std::size_t width(const styled_string & s)
+    {
+        return width(s.str());
+    }
+
+    // a dyed object as text without its colors
+    template<typename T>
+    std::string plain(const item<T> & it)
+    {
+        return measure::plain(it);
+    }
+
+    template<typename T>
+    std::string plain(const colorful<T> & col)
+    {
+        return measure::plain(col);
+    }
+
+    inline std::string plain(const styled_string & s)
+    {
+        return s.str();
+    }
+}
+
+#endif // COLOR_WIDTH_HPP
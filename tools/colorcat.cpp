@@ -0,0 +1,279 @@
+// colorcat: cat, with keywords and numbers highlighted the way
+// examples/mark.cpp does
+//
+//     colorcat [-k keyword,keyword,...] [-c color] [file ...]
+//
+// With no file, or with "-", standard input is read.  Regular files are
+// mapped into memory and written out with writev(2) straight from the
+// mapping, so that text which stays uncolored is never copied; pipes and
+// terminals are read in chunks instead.  Output that is not a terminal is
+// copied as it is, unless CLICOLOR_FORCE or FORCE_COLOR is set.
+//
+//     g++ -std=c++11 -O2 -I../include colorcat.cpp -o colorcat
+
+#include "../include/color_highlight.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#include <fstream>
+#include <iostream>
+#else
+#include <climits>
+#include <fcntl.h>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+#if !defined(_WIN32)
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+// Gathers the highlighted text as a list of slices, escape sequences
+// between them, and hands the list to writev(2) when it fills up.  Slices
+// of a mapped file are taken as they are; text that will not stay put, as
+// from a pipe, is copied into a buffer of our own first.
+class gather : public dye::highlighter::sink
+{
+    int fd;
+    vector<iovec> slices;
+    string copied;          // the text of slices that are not in place
+    vector<size_t> offsets; // where each copied slice starts in copied, or -1
+    int current;
+    bool failed;
+
+    static const string & escape(int c)
+    {
+        static vector<string> table = []
+        {
+            vector<string> t(256);
+            for (int i = 0; i != 256; ++i) {
+                ostringstream os;
+                hue::ansi::write(os, i);
+                t[static_cast<size_t>(i)] = os.str();
+            }
+            return t;
+        }();
+        return table[static_cast<size_t>(c)];
+    }
+
+public:
+    bool in_place;          // whether the text written stays put until flush()
+
+    explicit gather(int fd)
+        : sink(hue::DEFAULT_COLOR), fd(fd), current(hue::DEFAULT_COLOR), failed(false), in_place(true)
+    {
+        slices.reserve(IOV_MAX);
+        offsets.reserve(IOV_MAX);
+    }
+
+    void write(const char * p, size_t n, int color) override
+    {
+        if (color != current && hue::is_good(color)) {
+            const string & e = escape(color);
+            add(e.data(), e.size(), true);
+            current = color;
+        }
+        if (n)
+            add(p, n, in_place);
+    }
+
+    // false once a write has failed, e.g. on a closed pipe
+    bool flush()
+    {
+        // copied may have moved as it grew, so point into it only now
+        for (size_t i = 0; i != slices.size(); ++i)
+            if (offsets[i] != size_t(-1))
+                slices[i].iov_base = &copied[offsets[i]];
+        iovec * v = slices.data();
+        size_t count = slices.size();
+        while (count && !failed) {
+            ssize_t k = ::writev(fd, v, static_cast<int>(count));
+            if (k < 0) {
+                if (errno != EINTR)
+                    failed = true;
+                continue;
+            }
+            size_t left = static_cast<size_t>(k);
+            while (count && left >= v->iov_len) {
+                left -= v->iov_len;
+                ++v;
+                --count;
+            }
+            if (count) {
+                v->iov_base = static_cast<char *>(v->iov_base) + left;
+                v->iov_len -= left;
+            }
+        }
+        slices.clear();
+        offsets.clear();
+        copied.clear();
+        return !failed;
+    }
+
+private:
+    void add(const char * p, size_t n, bool stays)
+    {
+        if (stays && !slices.empty() && offsets.back() == size_t(-1) &&
+            static_cast<const char *>(slices.back().iov_base) + slices.back().iov_len == p) {
+            slices.back().iov_len += n;
+            return;
+        }
+        if (slices.size() == IOV_MAX)
+            flush();
+        if (stays) {
+            slices.push_back(iovec{const_cast<char *>(p), n});
+            offsets.push_back(size_t(-1));
+        }
+        else {
+            slices.push_back(iovec{nullptr, n});
+            offsets.push_back(copied.size());
+            copied.append(p, n);
+        }
+    }
+};
+
+// false if the input could not be read or the output written; a null
+// marker copies the input as it is
+bool colorcat(const dye::highlighter * marker, int in, gather & out)
+{
+    struct stat st;
+    if (fstat(in, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        size_t n = static_cast<size_t>(st.st_size);
+        void * map = mmap(nullptr, n, PROT_READ, MAP_PRIVATE, in, 0);
+        if (map != MAP_FAILED) {
+            madvise(map, n, MADV_SEQUENTIAL);
+            out.in_place = true;
+            if (marker)
+                marker->highlight(static_cast<const char *>(map), n, out);
+            else
+                out.write(static_cast<const char *>(map), n, out.plain);
+            bool ok = out.flush();
+            munmap(map, n);
+            return ok;
+        }
+    }
+
+    vector<char> chunk(dye::highlighter::CHUNK);
+    if (!marker) {
+        // each chunk is out before the next is read, so it can stay put
+        out.in_place = true;
+        for (;;) {
+            ssize_t k = ::read(in, chunk.data(), chunk.size());
+            if (k < 0 && errno == EINTR)
+                continue;
+            if (k <= 0)
+                return out.flush() && k == 0;
+            out.write(chunk.data(), static_cast<size_t>(k), out.plain);
+            if (!out.flush())
+                return false;
+        }
+    }
+
+    out.in_place = false;
+    dye::highlighter::scanner s(*marker, out);
+    for (;;) {
+        ssize_t k = ::read(in, chunk.data(), chunk.size());
+        if (k < 0 && errno == EINTR)
+            continue;
+        if (k <= 0) {
+            s.finish();
+            return out.flush() && k == 0;
+        }
+        s.feed(chunk.data(), static_cast<size_t>(k));
+        if (!out.flush())
+            return false;
+    }
+}
+
+#endif
+
+int main(int argc, char * argv[])
+{
+    vector<string> keywords = {"google", "facebook", "microsoft", "twitter"};
+    int color = hue::YELLOW;
+    vector<string> files;
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if ((arg == "-k" || arg == "-c") && i + 1 < argc) {
+            string value = argv[++i];
+            if (arg == "-c") {
+                color = hue::stoc(value);
+                if (color == hue::BAD_COLOR) {
+                    fprintf(stderr, "colorcat: unknown color '%s'\n", value.c_str());
+                    return 2;
+                }
+                continue;
+            }
+            keywords.clear();
+            for (size_t a = 0, b; a <= value.size(); a = b + 1) {
+                b = value.find(',', a);
+                if (b == string::npos)
+                    b = value.size();
+                if (b != a)
+                    keywords.push_back(value.substr(a, b - a));
+            }
+        }
+        else if (arg.size() > 1 && arg[0] == '-') {
+            fprintf(stderr, "usage: colorcat [-k keyword,keyword,...] [-c color] [file ...]\n");
+            return 2;
+        }
+        else {
+            files.push_back(arg);
+        }
+    }
+    if (files.empty())
+        files.push_back("-");
+
+    dye::highlighter marker(keywords, color);
+    int status = 0;
+
+#if defined(_WIN32)
+    for (const auto & f : files) {
+        if (f == "-") {
+            marker.highlight(cin, cout);
+            continue;
+        }
+        ifstream is(f, ios::binary);
+        if (!is) {
+            fprintf(stderr, "colorcat: %s: cannot open\n", f.c_str());
+            status = 1;
+            continue;
+        }
+        marker.highlight(is, cout);
+    }
+#else
+    gather out(STDOUT_FILENO);
+    for (const auto & f : files) {
+        int in = f == "-" ? STDIN_FILENO : open(f.c_str(), O_RDONLY);
+        if (in < 0) {
+            fprintf(stderr, "colorcat: %s: %s\n", f.c_str(), strerror(errno));
+            status = 1;
+            continue;
+        }
+        bool ok = colorcat(hue::muted(cout) ? nullptr : &marker, in, out);
+        // close() may set errno too
+        int error = errno;
+        if (in != STDIN_FILENO)
+            close(in);
+        if (!ok) {
+            if (error == EPIPE)
+                return status;
+            fprintf(stderr, "colorcat: %s: %s\n", f.c_str(), strerror(error));
+            return 1;
+        }
+    }
+#endif
+    return status;
+}